@@ -1,5 +1,44 @@
 #include "CAP1208.h"
 
+// Clock steps probed by tuneBusClock(), slowest first
+static const uint32_t CLOCK_STEPS[] = {100000, 200000, 300000, 400000};
+static const uint8_t CLOCK_STEP_COUNT = sizeof(CLOCK_STEPS) / sizeof(CLOCK_STEPS[0]);
+
+// Registers kept by saveConfig(), CAP1208_CONFIG_BYTES in all. Calibration Activate is left out (writing it back
+// would start a calibration), so are the status registers between the ranges.
+static const struct {
+  CAP1208_Register reg;
+  uint8_t len;
+} CONFIG_RANGES[] = {{SENSITIVITY, 6}, {INT_ENABLE, 2}, {MULTITOUCH, 1}, {RECALCONFIG, 1}, {CONFIG2, 1}};
+static const uint8_t CONFIG_RANGE_COUNT = sizeof(CONFIG_RANGES) / sizeof(CONFIG_RANGES[0]);
+
+#ifdef CAP1208_FAULT_INJECTION
+// Power-on values of the configuration ranges (pg. 24), written back by an injected reset
+static const uint8_t CONFIG_DEFAULTS[CAP1208_CONFIG_BYTES] = {0x2F, 0x20, 0xFF, 0xA4, 0x07, 0x39, 0xFF, 0xFF, 0x80, 0x8A, 0x40};
+
+// Skip the transaction as if it was not acknowledged, once the bus is granted
+#define CAP1208_INJECT_NACK(...) \
+  if (injectBefore()) {          \
+    checkTransaction(false);     \
+    releaseBus();                \
+    return __VA_ARGS__;          \
+  }
+#define CAP1208_INJECT_SHORT_READ(received) injectShortRead(received)
+#define CAP1208_INJECT_LATENCY() injectLatency()
+#else
+#define CAP1208_INJECT_NACK(...)
+#define CAP1208_INJECT_SHORT_READ(received)
+#define CAP1208_INJECT_LATENCY()
+#endif
+
+// Name, averaging, sample time, cycle time, noise filters, recalibration, poll interval (see CAP1208_ProfileId)
+const CAP1208_Profile CAP1208_PROFILES[CAP1208_PROFILE_COUNT] = {
+    {"low-latency", 0, 0, 0, true, 0, 35},
+    {"balanced", 2, 1, 0, true, 2, 50},
+    {"low-noise", 4, 1, 1, true, 3, 90},
+    {"low-power", 0, 0, 3, true, 3, 150},
+};
+
 /**
  * @brief Constructor for the TouchSlider class.
  *
@@ -14,10 +53,11 @@ CAP1208::CAP1208(byte addr) {
  *
  * @param wirePort The Wire port to use for communication.
  * @param deviceAddress The address of the CAP1208 sensor.
+ * @param autoTuneClock Probe and select the fastest reliable I2C clock (see tuneBusClock()).
  *
  * @return true if the sensor is initialized successfully.
  */
-bool CAP1208::begin(TwoWire &wirePort, uint8_t deviceAddress) {
+bool CAP1208::begin(TwoWire &wirePort, uint8_t deviceAddress, bool autoTuneClock) {
   // Set device address and wire port to private variable
   _deviceAddress = deviceAddress;
   _i2cPort = &wirePort;
@@ -35,9 +75,128 @@ bool CAP1208::begin(TwoWire &wirePort, uint8_t deviceAddress) {
     return false;
   }
 
+  if (autoTuneClock) {
+    tuneBusClock();
+  }
+
   return true;  // Success
 }
 
+/**
+ * @brief Select the fastest I2C clock that works reliably with the sensor.
+ *
+ * The clock is stepped up from 100 kHz; each step must pass CAP1208_TUNE_ITERATIONS reads of the ID registers and
+ * a write/read round trip before the next one is tried. The last step that passed is kept. Afterwards, if the error
+ * rate of the normal transactions rises above CAP1208_ERROR_THRESHOLD per CAP1208_ERROR_WINDOW, the clock steps down.
+ *
+ * The clock is that of the whole Wire bus: on a shared bus, every device must support it and SharedI2CBus::begin()
+ * must be called afterwards so its transfer estimates follow. A later step-down happens while the touch client owns
+ * the bus, the arbiter reads the new clock when it is released.
+ *
+ * @param maxClock Highest clock to try (Hz).
+ * @return The selected clock (Hz), 0 if even the slowest step failed.
+ */
+uint32_t CAP1208::tuneBusClock(uint32_t maxClock) {
+  int8_t selected = -1;
+  _clockStep = -1;  // No fallback while probing
+  for (uint8_t step = 0; step < CLOCK_STEP_COUNT && CLOCK_STEPS[step] <= maxClock; step++) {
+    _i2cPort->setClock(CLOCK_STEPS[step]);
+    if (!verifyBus()) {
+      log_w("I2C unreliable at %lu Hz", (unsigned long)CLOCK_STEPS[step]);
+      break;
+    }
+    selected = step;
+  }
+
+  if (selected < 0) {
+    _i2cPort->setClock(CLOCK_STEPS[0]);
+    _clockStep = -1;
+    _busClock = 0;
+    log_e("I2C verification failed at %lu Hz", (unsigned long)CLOCK_STEPS[0]);
+    return 0;
+  }
+
+  _i2cPort->setClock(CLOCK_STEPS[selected]);
+  _clockStep = selected;
+  _busClock = CLOCK_STEPS[selected];
+  _windowTransactions = 0;
+  _windowErrors = 0;
+  _transactionTimeUs = measureTransactionTime();
+  log_i("I2C clock %lu Hz, %u us per register read", (unsigned long)_busClock, _transactionTimeUs);
+  return _busClock;
+}
+
+/**
+ * @brief Check the bus at the current clock.
+ *
+ * @return true if the ID registers read back their fixed values (REV must stay constant) and a write to the
+ *         standby threshold register reads back correctly.
+ */
+bool CAP1208::verifyBus() {
+  uint32_t errors = _i2cErrors;
+  uint8_t revision = readRegister(REV);
+
+  for (uint8_t i = 0; i < CAP1208_TUNE_ITERATIONS; i++) {
+    if (readRegister(PRODUCT_ID) != PROD_ID_VALUE || readRegister(MAN_ID) != MAN_ID_VALUE ||
+        readRegister(REV) != revision) {
+      return false;
+    }
+  }
+
+  // Round trip on a register that only matters in standby
+  uint8_t original = readRegister(STANDBY_THRE);
+  static const uint8_t patterns[] = {0x55, 0xAA};
+  bool ok = true;
+  for (uint8_t i = 0; i < sizeof(patterns) && ok; i++) {
+    writeRegister(STANDBY_THRE, patterns[i]);
+    ok = readRegister(STANDBY_THRE) == patterns[i];
+  }
+  writeRegister(STANDBY_THRE, original);
+
+  return ok && _i2cErrors == errors;
+}
+
+/**
+ * @brief Measure the average time of a one-byte register read at the current clock.
+ *
+ * @return Time per transaction in microseconds.
+ */
+uint16_t CAP1208::measureTransactionTime() {
+  const uint8_t reads = 16;
+  uint32_t start = micros();
+  for (uint8_t i = 0; i < reads; i++) {
+    readRegister(PRODUCT_ID);
+  }
+  return (micros() - start) / reads;
+}
+
+/**
+ * @brief Account for the result of a transaction and step the clock down if the error rate is too high.
+ *
+ * @param ok false if the transaction was not acknowledged or returned fewer bytes than requested.
+ */
+void CAP1208::checkTransaction(bool ok) {
+  if (!ok) {
+    _i2cErrors++;
+    if (_windowErrors < 0xFF) {
+      _windowErrors++;
+    }
+  }
+  if (++_windowTransactions < CAP1208_ERROR_WINDOW) {
+    return;
+  }
+
+  if (_windowErrors > CAP1208_ERROR_THRESHOLD && _clockStep > 0) {
+    _clockStep--;
+    _busClock = CLOCK_STEPS[_clockStep];
+    _i2cPort->setClock(_busClock);
+    log_w("%u I2C errors in %u transactions, clock lowered to %lu Hz", _windowErrors, CAP1208_ERROR_WINDOW,
+          (unsigned long)_busClock);
+  }
+  _windowTransactions = 0;
+  _windowErrors = 0;
+}
+
 /**
  *  @brief Check if the sensor is connected
  *
@@ -63,8 +222,7 @@ bool CAP1208::isConnected() {
  * @note See datasheet on Main Control Register
  */
 void CAP1208::checkMainControl() {
-  MAIN_CONTROL_REG reg;
-  reg.MAIN_CONTROL_COMBINED = readRegister(MAIN_CTRL_REG);
+  readRegister(MAIN_CTRL_REG);
 }
 
 /**
@@ -72,52 +230,31 @@ void CAP1208::checkMainControl() {
  * @note See datasheet on General Status Register
  */
 void CAP1208::checkStatus() {
-  GENERAL_STATUS_REG reg;
-  reg.GENERAL_STATUS_COMBINED = readRegister(GEN_STATUS);
+  readRegister(GEN_STATUS);
 }
 
 /**
  * @brief Clears the interrupt pin
+ * @note The register is only written if the INT bit is set
  */
 void CAP1208::clearInterrupt() {
-  MAIN_CONTROL_REG reg;
-  reg.MAIN_CONTROL_COMBINED = readRegister(MAIN_CTRL_REG);
-  reg.MAIN_CONTROL_FIELDS.INT = 0x00;
-  writeRegister(MAIN_CTRL_REG, reg.MAIN_CONTROL_COMBINED);
+  updateRegister(MAIN_CTRL_INT::set<0>());
 }
 
 /**
  * @brief Disables all interrupts
+ * @note The register has no other field, it is written without being read
  */
 void CAP1208::setInterruptDisabled() {
-  INTERRUPT_ENABLE_REG reg;
-  reg.INTERRUPT_ENABLE_COMBINED = readRegister(INT_ENABLE);
-  reg.INTERRUPT_ENABLE_FIELDS.CS1_INT_EN = 0x00;
-  reg.INTERRUPT_ENABLE_FIELDS.CS2_INT_EN = 0x00;
-  reg.INTERRUPT_ENABLE_FIELDS.CS3_INT_EN = 0x00;
-  reg.INTERRUPT_ENABLE_FIELDS.CS4_INT_EN = 0x00;
-  reg.INTERRUPT_ENABLE_FIELDS.CS5_INT_EN = 0x00;
-  reg.INTERRUPT_ENABLE_FIELDS.CS6_INT_EN = 0x00;
-  reg.INTERRUPT_ENABLE_FIELDS.CS7_INT_EN = 0x00;
-  reg.INTERRUPT_ENABLE_FIELDS.CS8_INT_EN = 0x00;
-  writeRegister(INT_ENABLE, reg.INTERRUPT_ENABLE_COMBINED);
+  updateRegister(INT_ENABLE_CS::set<0x00>());
 }
 
 /**
  * @brief Sets all interrupts
+ * @note The register has no other field, it is written without being read
  */
 void CAP1208::setInterruptEnabled() {
-  INTERRUPT_ENABLE_REG reg;
-  reg.INTERRUPT_ENABLE_COMBINED = readRegister(INT_ENABLE);
-  reg.INTERRUPT_ENABLE_FIELDS.CS1_INT_EN = 0x01;
-  reg.INTERRUPT_ENABLE_FIELDS.CS2_INT_EN = 0x01;
-  reg.INTERRUPT_ENABLE_FIELDS.CS3_INT_EN = 0x01;
-  reg.INTERRUPT_ENABLE_FIELDS.CS4_INT_EN = 0x01;
-  reg.INTERRUPT_ENABLE_FIELDS.CS5_INT_EN = 0x01;
-  reg.INTERRUPT_ENABLE_FIELDS.CS6_INT_EN = 0x01;
-  reg.INTERRUPT_ENABLE_FIELDS.CS7_INT_EN = 0x01;
-  reg.INTERRUPT_ENABLE_FIELDS.CS8_INT_EN = 0x01;
-  writeRegister(INT_ENABLE, reg.INTERRUPT_ENABLE_COMBINED);
+  updateRegister(INT_ENABLE_CS::set<0xFF>());
 }
 
 /**
@@ -126,12 +263,7 @@ void CAP1208::setInterruptEnabled() {
  * @return true if interrupts are enabled
  */
 bool CAP1208::isInterruptEnabled() {
-  INTERRUPT_ENABLE_REG reg;
-  reg.INTERRUPT_ENABLE_COMBINED = readRegister(INT_ENABLE);
-  if (reg.INTERRUPT_ENABLE_FIELDS.CS1_INT_EN == 0x01 && reg.INTERRUPT_ENABLE_FIELDS.CS2_INT_EN == 0x01 && reg.INTERRUPT_ENABLE_FIELDS.CS3_INT_EN == 0x01) {
-    return true;
-  }
-  return false;
+  return (INT_ENABLE_CS::get(readRegister(INT_ENABLE)) & 0x07) == 0x07;  // Inputs 1 to 3, as before
 }
 
 /**
@@ -141,27 +273,10 @@ bool CAP1208::isInterruptEnabled() {
  * @note See datasheet on Sensitivity, default is SENSITIVITY_32X
  */
 void CAP1208::setSensitivity(uint8_t sensitivity) {
-  SENSITIVITY_CONTROL_REG reg;
-  reg.SENSITIVITY_CONTROL_COMBINED = readRegister(SENSITIVITY);
-  if (sensitivity == SENSITIVITY_128X) {
-    reg.SENSITIVITY_CONTROL_FIELDS.DELTA_SENSE = SENSITIVITY_128X;
-  } else if (sensitivity == SENSITIVITY_64X) {
-    reg.SENSITIVITY_CONTROL_FIELDS.DELTA_SENSE = SENSITIVITY_64X;
-  } else if (sensitivity == SENSITIVITY_32X) {
-    reg.SENSITIVITY_CONTROL_FIELDS.DELTA_SENSE = SENSITIVITY_32X;
-  } else if (sensitivity == SENSITIVITY_16X) {
-    reg.SENSITIVITY_CONTROL_FIELDS.DELTA_SENSE = SENSITIVITY_16X;
-  } else if (sensitivity == SENSITIVITY_8X) {
-    reg.SENSITIVITY_CONTROL_FIELDS.DELTA_SENSE = SENSITIVITY_8X;
-  } else if (sensitivity == SENSITIVITY_4X) {
-    reg.SENSITIVITY_CONTROL_FIELDS.DELTA_SENSE = SENSITIVITY_4X;
-  } else if (sensitivity == SENSITIVITY_1X) {
-    reg.SENSITIVITY_CONTROL_FIELDS.DELTA_SENSE = SENSITIVITY_1X;
-  } else {
-    // Default case: calibrated for CAP1208 touch sensor
-    reg.SENSITIVITY_CONTROL_FIELDS.DELTA_SENSE = SENSITIVITY_2X;
-  }
-  writeRegister(SENSITIVITY, reg.SENSITIVITY_CONTROL_COMBINED);
+  if (sensitivity > SENSITIVITY_1X) {
+    sensitivity = SENSITIVITY_2X;  // Default case: calibrated for CAP1208 touch sensor
+  }
+  updateRegister(SENSITIVITY_DELTA_SENSE::of(sensitivity));
 }
 
 /**
@@ -170,29 +285,7 @@ void CAP1208::setSensitivity(uint8_t sensitivity) {
  * @return Sensitivity value, SENSITIVITY_128X to SENSITIVITY_1X (Most sensitive to least sensitive)
  */
 uint8_t CAP1208::getSensitivity() {
-  SENSITIVITY_CONTROL_REG reg;
-  reg.SENSITIVITY_CONTROL_COMBINED = readRegister(SENSITIVITY);
-  uint16_t sensitivity = reg.SENSITIVITY_CONTROL_FIELDS.DELTA_SENSE;
-  if (sensitivity == SENSITIVITY_128X) {
-    return 128;
-  } else if (sensitivity == SENSITIVITY_64X) {
-    return 64;
-  } else if (sensitivity == SENSITIVITY_32X) {
-    return 32;
-  } else if (sensitivity == SENSITIVITY_16X) {
-    return 16;
-  } else if (sensitivity == SENSITIVITY_8X) {
-    return 8;
-  } else if (sensitivity == SENSITIVITY_4X) {
-    return 4;
-  } else if (sensitivity == SENSITIVITY_2X) {
-    return 2;
-  } else if (sensitivity == SENSITIVITY_1X) {
-    return 1;
-  } else {
-    // Error - no possible register value (pg. 25)
-    return 0;
-  }
+  return 128 >> SENSITIVITY_DELTA_SENSE::get(readRegister(SENSITIVITY));  // 128x to 1x (pg. 25)
 }
 
 /**
@@ -201,11 +294,8 @@ uint8_t CAP1208::getSensitivity() {
  * @retval true if the sensor is touched
  */
 bool CAP1208::isTouched() {
-  GENERAL_STATUS_REG reg;
-  reg.GENERAL_STATUS_COMBINED = readRegister(GEN_STATUS);
-
   // Touch detected
-  if (reg.GENERAL_STATUS_FIELDS.TOUCH == ON) {
+  if (GEN_STATUS_TOUCH::get(readRegister(GEN_STATUS)) == ON) {
     clearInterrupt();
     return true;
   }
@@ -229,74 +319,581 @@ uint8_t CAP1208::readID() {
  * @brief Sets the sensor to standby mode
  */
 void CAP1208::StandbyMode() {
-  MAIN_CONTROL_REG reg;
-  reg.MAIN_CONTROL_COMBINED = readRegister(MAIN_CTRL_REG);
-  reg.MAIN_CONTROL_FIELDS.STBY = true;
-  writeRegister(MAIN_CTRL_REG, reg.MAIN_CONTROL_COMBINED);
+  updateRegister(MAIN_CTRL_STBY::set<1>());
 }
 
 /**
  * @brief Sets the sensor to active mode
  */
 void CAP1208::ActiveMode() {
-  MAIN_CONTROL_REG reg;
-  reg.MAIN_CONTROL_COMBINED = readRegister(MAIN_CTRL_REG);
-  reg.MAIN_CONTROL_FIELDS.STBY = false;
-  writeRegister(MAIN_CTRL_REG, reg.MAIN_CONTROL_COMBINED);
+  updateRegister(MAIN_CTRL_STBY::set<0>());
 }
 
 /**
  * @brief Sets the sensor to sleep mode
  */
 void CAP1208::SleepMode() {
-  MAIN_CONTROL_REG reg;
-  reg.MAIN_CONTROL_COMBINED = readRegister(MAIN_CTRL_REG);
-  reg.MAIN_CONTROL_FIELDS.DSLEEP = true;
-  writeRegister(MAIN_CTRL_REG, reg.MAIN_CONTROL_COMBINED);
+  updateRegister(MAIN_CTRL_DSLEEP::set<1>());
 }
 
 /**
  * @brief Set the multi touch mode, this option enables multiple touch detection allowing for a maximum of 4 touches
- * @param  number: Number of touches, 1 (Single touch) to 4 (Maximum of 4 touches)
+ * @param  number: Number of touches, 1 (Single touch) to 4 (Maximum of 4 touches), 0 to remove the limit
  */
 void CAP1208::ConfigureMultiTouch(u_int8_t number) {
-  MULTI_TOUCH_REG reg;
-  if (number != 0) {
-    number -= 1;
-    if (number >= 4) {
-      number = 3;
+  if (number == 0) {
+    updateRegister(MULTITOUCH_MULT_BLK_EN::set<0>() | MULTITOUCH_B_MULT_T::set<0>());
+    return;
+  }
+  number = number > 4 ? 3 : number - 1;
+  updateRegister(MULTITOUCH_MULT_BLK_EN::set<1>() | MULTITOUCH_B_MULT_T::of(number));
+}
+
+/**
+ * @brief Apply an acquisition profile.
+ *
+ * Configuration to Averaging and Sampling Configuration (0x20 to 0x24) are read and written back in one burst each,
+ * so the chip never runs with half of the new sampling settings; the recalibration speed follows in one more
+ * read-modify-write. TouchSlider::setProfile() calls it between two updates, the automatic switch of
+ * TouchSlider::setAutoProfiles() from inside the update.
+ *
+ * @param profile Profile to apply.
+ * @return false if an I2C transaction failed.
+ */
+bool CAP1208::setProfile(const CAP1208_Profile &profile) {
+  uint32_t errors = _i2cErrors;
+  uint8_t block[5];  // CONFIG1, SENSINPUTEN, SENSINCONF1, SENSINCONF2, AVERAGE_SAMP_CONF
+  readRegisters(CONFIG1, block, sizeof(block));
+  if (_i2cErrors != errors) {
+    return false;
+  }
+
+  const uint8_t noiseMask = CONFIG1_DIS_DIG_NOISE::mask | CONFIG1_DIS_ANA_NOISE::mask;
+  block[0] = (block[0] & ~noiseMask) | (profile.noiseFilters ? 0 : noiseMask);
+  block[4] = (AVERAGE_SAMP_AVG::of(profile.averaging) | AVERAGE_SAMP_SAMP_TIME::of(profile.sampleTime) |
+              AVERAGE_SAMP_CYCLE_TIME::of(profile.cycleTime)).bits;
+  writeRegisters(CONFIG1, block, sizeof(block));
+  updateRegister(RECALCONFIG_CAL_CFG::of(profile.recalibration));
+
+  return _i2cErrors == errors;
+}
+
+/**
+ * @brief Apply a profile and measure what it gives on this hardware.
+ *
+ * The cycle time is the median time between two changes of the delta counts, read as fast as the bus allows with
+ * the most sensitive gain so the noise changes them on every cycle. The noise is then sampled once per cycle at the
+ * configured sensitivity. Do not touch the pads, and stop the TouchSlider (it shares the bus). The profile stays applied.
+ *
+ * @param profile Profile to measure.
+ * @param report Measured cycle time and noise.
+ * @return false if an I2C transaction failed.
+ */
+bool CAP1208::measureProfile(const CAP1208_Profile &profile, CAP1208_ProfileReport &report) {
+  memset(&report, 0, sizeof(report));
+  if (!setProfile(profile)) {
+    return false;
+  }
+  uint32_t errors = _i2cErrors;
+  uint8_t sensitivity = readRegister(SENSITIVITY);
+
+  // Cycle time: timestamps of the delta count updates
+  updateRegister(SENSITIVITY_DELTA_SENSE::set<SENSITIVITY_128X>());
+  uint32_t expectedMs = 35UL * (profile.cycleTime + 1) + (8UL << profile.averaging) * (320UL << profile.sampleTime) / 1000;
+  uint32_t intervals[CAP1208_PROFILE_CYCLE_CHANGES - 1];
+  uint8_t changes = 0;
+  int8_t previous[8];
+  int8_t deltas[8];
+  getDeltaCounts(previous);
+  uint32_t last = micros();
+  uint32_t deadline = millis() + expectedMs * (CAP1208_PROFILE_CYCLE_CHANGES + 4);
+  while (changes < CAP1208_PROFILE_CYCLE_CHANGES && (int32_t)(millis() - deadline) < 0) {
+    getDeltaCounts(deltas);
+    if (memcmp(deltas, previous, sizeof(deltas)) == 0) {
+      continue;
+    }
+    uint32_t now = micros();
+    if (changes > 0) {
+      intervals[changes - 1] = now - last;  // The first change ends a partial cycle
+    }
+    last = now;
+    memcpy(previous, deltas, sizeof(deltas));
+    changes++;
+  }
+  writeRegister(SENSITIVITY, sensitivity);
+
+  if (changes > 2) {
+    uint8_t count = changes - 1;
+    for (uint8_t i = 1; i < count; i++) {  // Insertion sort, at most 32 values
+      uint32_t value = intervals[i];
+      int8_t j = i - 1;
+      for (; j >= 0 && intervals[j] > value; j--) {
+        intervals[j + 1] = intervals[j];
+      }
+      intervals[j + 1] = value;
+    }
+    report.cycleUs = intervals[count / 2];
+  }
+
+  // Noise: one sample per cycle
+  uint32_t cycleMs = report.cycleUs != 0 ? (report.cycleUs + 999) / 1000 : expectedMs;
+  uint32_t squares[8] = {};
+  getNoiseFlags();  // Read once to start from the flags of this profile
+  for (uint8_t frame = 0; frame < CAP1208_PROFILE_NOISE_FRAMES; frame++) {
+    delay(cycleMs);
+    getDeltaCounts(deltas);
+    report.noiseFlags |= getNoiseFlags();
+    for (uint8_t i = 0; i < 8; i++) {
+      uint8_t magnitude = deltas[i] < 0 ? -deltas[i] : deltas[i];
+      squares[i] += magnitude * magnitude;
+      report.noisePeak[i] = magnitude > report.noisePeak[i] ? magnitude : report.noisePeak[i];
+    }
+  }
+  for (uint8_t i = 0; i < 8; i++) {
+    // RMS in 1/16 counts: sqrt(256 * mean of the squares)
+    uint32_t meanQ8 = (squares[i] << 8) / CAP1208_PROFILE_NOISE_FRAMES;
+    uint32_t root = 0;
+    for (uint32_t bit = 1UL << 15; bit != 0; bit >>= 1) {
+      if ((root | bit) * (root | bit) <= meanQ8) {
+        root |= bit;
+      }
     }
-    reg.MULTI_TOUCH_COMBINED = readRegister(MULTITOUCH);
-    reg.MULTI_TOUCH_FIELDS.MULT_BLK_EN = true;
-    reg.MULTI_TOUCH_FIELDS.B_MULT_T = number;
-    writeRegister(MULTITOUCH, reg.MULTI_TOUCH_COMBINED);
-  } else {
-    reg.MULTI_TOUCH_COMBINED = readRegister(MULTITOUCH);
-    reg.MULTI_TOUCH_FIELDS.MULT_BLK_EN = false;
-    reg.MULTI_TOUCH_FIELDS.B_MULT_T = false;
-    writeRegister(MULTITOUCH, reg.MULTI_TOUCH_COMBINED);
+    report.noiseRms[i] = root;
   }
+
+  return _i2cErrors == errors;
 }
 
 /**
  * @brief Reads the touch data
  *
+ * A failed read leaves data as it was, so the caller can hold the previous frame instead of seeing no touch.
+ *
  * @param data: Array to store the touch data
+ * @retval false if the read failed
  */
-void CAP1208::getTouchData(bool data[8]) {
-  SENSOR_INPUT_STATUS_REG reg;
-  reg.SENSOR_INPUT_STATUS_COMBINED = readRegister(SENSOR_INPUTS);
-
-  data[0] = reg.SENSOR_INPUT_STATUS_FIELDS.CS1;
-  data[1] = reg.SENSOR_INPUT_STATUS_FIELDS.CS2;
-  data[2] = reg.SENSOR_INPUT_STATUS_FIELDS.CS3;
-  data[3] = reg.SENSOR_INPUT_STATUS_FIELDS.CS4;
-  data[4] = reg.SENSOR_INPUT_STATUS_FIELDS.CS5;
-  data[5] = reg.SENSOR_INPUT_STATUS_FIELDS.CS6;
-  data[6] = reg.SENSOR_INPUT_STATUS_FIELDS.CS7;
-  data[7] = reg.SENSOR_INPUT_STATUS_FIELDS.CS8;
+bool CAP1208::getTouchData(bool data[8]) {
+  uint32_t errors = _i2cErrors;
+  uint8_t inputs = readInputs();
+  if (_i2cErrors != errors) {
+    return false;  // INT stays set, the touches latched since the last good read are reported by the next one
+  }
+  for (uint8_t i = 0; i < 8; i++) {
+    data[i] = (inputs >> i) & 0x01;
+  }
 
   clearInterrupt();
+  return true;
+}
+
+/**
+ * @brief Reads the inputs that are touched now.
+ *
+ * The Sensor Input Status bits are latched until the INT bit is cleared, so getTouchData() also reports the inputs
+ * touched and released since the previous read. Once getTouchData() has cleared INT, only the inputs still touched
+ * stay set: a bit in getTouchData() but not here is a tap that already ended.
+ *
+ * @return Touched inputs, bit 0 = CS1. All set if the read failed, so no touch looks released.
+ */
+uint8_t CAP1208::getLiveInputs() {
+  uint32_t errors = _i2cErrors;
+  uint8_t inputs = readInputs();
+  return _i2cErrors == errors ? inputs : 0xFF;
+}
+
+/**
+ * @brief Reads the Sensor Input Status register (with the injected stuck bits).
+ */
+uint8_t CAP1208::readInputs() {
+  uint8_t inputs = SENSOR_INPUTS_CS::get(readRegister(SENSOR_INPUTS));
+#ifdef CAP1208_FAULT_INJECTION
+  if (_injecting) {
+    inputs = (inputs & ~_faults.stuckMask) | (_faults.stuckValue & _faults.stuckMask);
+  }
+#endif
+  return inputs;
+}
+
+/**
+ * @brief Keep the current configuration of the chip, to restore it after a reset (see checkConfig()).
+ *
+ * Call it once the sensor is configured (TouchSlider::start() does). The configuration written through this class
+ * afterwards is kept as well; registers written by other means are not.
+ *
+ * @return false if the configuration could not be read.
+ */
+bool CAP1208::saveConfig() {
+  _configSaved = readConfig(_config);
+  return _configSaved;
+}
+
+/**
+ * @brief Detect a chip reset and restore the saved configuration.
+ *
+ * A brown-out or an ESD event restarts the chip with its power-on configuration while the bus keeps working: the
+ * sensitivity, the sampling and the multi-touch settings silently change. The configuration registers are read back
+ * and written again if any of them differs from the saved copy. A configuration equal to the defaults cannot be lost.
+ *
+ * @return true if the configuration had to be restored.
+ */
+bool CAP1208::checkConfig() {
+  uint8_t current[CAP1208_CONFIG_BYTES];
+  if (!_configSaved || !readConfig(current) || memcmp(current, _config, sizeof(current)) == 0) {
+    return false;
+  }
+  log_w("CAP1208 configuration lost (chip reset?), restoring it");
+  writeConfig(_config);
+  if (_chipResets < 0xFFFF) {
+    _chipResets++;
+  }
+  return true;
+}
+
+/**
+ * @brief Read the configuration ranges.
+ *
+ * @param config Buffer of CAP1208_CONFIG_BYTES, in the order of the ranges.
+ * @return false if a transaction failed.
+ */
+bool CAP1208::readConfig(uint8_t config[CAP1208_CONFIG_BYTES]) {
+  uint32_t errors = _i2cErrors;
+  uint8_t offset = 0;
+  for (uint8_t i = 0; i < CONFIG_RANGE_COUNT && _i2cErrors == errors; i++) {
+    readRegisters(CONFIG_RANGES[i].reg, config + offset, CONFIG_RANGES[i].len);
+    offset += CONFIG_RANGES[i].len;
+  }
+  return _i2cErrors == errors;
+}
+
+/**
+ * @brief Write the configuration ranges, one burst each.
+ */
+void CAP1208::writeConfig(const uint8_t config[CAP1208_CONFIG_BYTES]) {
+  uint8_t offset = 0;
+  for (uint8_t i = 0; i < CONFIG_RANGE_COUNT; i++) {
+    writeRegisters(CONFIG_RANGES[i].reg, config + offset, CONFIG_RANGES[i].len);
+    offset += CONFIG_RANGES[i].len;
+  }
+}
+
+/**
+ * @brief Follow a successful write in the saved configuration.
+ */
+void CAP1208::trackConfig(uint8_t reg, const byte *buffer, byte len) {
+  if (!_configSaved) {
+    return;
+  }
+  uint8_t offset = 0;
+  for (uint8_t i = 0; i < CONFIG_RANGE_COUNT; i++) {
+    for (uint8_t j = 0; j < CONFIG_RANGES[i].len; j++) {
+      uint8_t index = CONFIG_RANGES[i].reg + j - reg;  // Position of this register in the written buffer
+      if (index < len) {
+        _config[offset + j] = buffer[index];
+      }
+    }
+    offset += CONFIG_RANGES[i].len;
+  }
+}
+
+/**
+ * @brief Inject faults into the register transactions (needs CAP1208_FAULT_INJECTION).
+ *
+ * Each transaction draws its faults from a seeded pseudo-random sequence, so a run can be repeated. A NACK skips the
+ * transaction, a short read drops its data, a reset writes the power-on values of the configuration registers (the
+ * chip itself keeps its calibration) and a latency spike holds the bus longer. The stuck bits apply to every read of
+ * the Sensor Input Status.
+ *
+ * @param faults Rates and parameters of the faults.
+ * @param seed Start of the pseudo-random sequence (not 0).
+ */
+void CAP1208::setFaults(const CAP1208_Faults &faults, uint32_t seed) {
+#ifdef CAP1208_FAULT_INJECTION
+  _faults = faults;
+  _faultRandom = seed != 0 ? seed : 1;
+  memset(&_faultCounts, 0, sizeof(_faultCounts));
+  _injecting = true;
+#else
+  (void)faults;
+  (void)seed;
+  log_e("Fault injection disabled, define CAP1208_FAULT_INJECTION to enable it");
+#endif
+}
+
+/**
+ * @brief Stop injecting faults (the counts are kept).
+ */
+void CAP1208::clearFaults() {
+#ifdef CAP1208_FAULT_INJECTION
+  _injecting = false;
+#endif
+}
+
+/**
+ * @brief Faults injected since setFaults() (zeroed if CAP1208_FAULT_INJECTION is not defined).
+ */
+void CAP1208::getFaultCounts(CAP1208_FaultCounts &counts) {
+#ifdef CAP1208_FAULT_INJECTION
+  counts = _faultCounts;
+#else
+  memset(&counts, 0, sizeof(counts));
+#endif
+}
+
+#ifdef CAP1208_FAULT_INJECTION
+/**
+ * @brief Draw a fault.
+ *
+ * @param perMillion Rate of the fault.
+ * @return true if the fault happens in this transaction.
+ */
+bool CAP1208::faultHit(uint32_t perMillion) {
+  if (perMillion == 0) {
+    return false;
+  }
+  _faultRandom ^= _faultRandom << 13;
+  _faultRandom ^= _faultRandom >> 17;
+  _faultRandom ^= _faultRandom << 5;
+  return _faultRandom % 1000000 < perMillion;
+}
+
+/**
+ * @brief Faults drawn before a transaction: the emulated reset, then the NACK.
+ *
+ * @return true if the transaction is not acknowledged.
+ */
+bool CAP1208::injectBefore() {
+  if (!_injecting) {
+    return false;
+  }
+  if (faultHit(_faults.reset)) {
+    _faultCounts.resets++;
+    bool saved = _configSaved;
+    _injecting = false;  // The reset itself goes through
+    _configSaved = false;
+    writeRegister(MAIN_CTRL_REG, 0x00);
+    writeConfig(CONFIG_DEFAULTS);
+    _configSaved = saved;
+    _injecting = true;
+  }
+  if (faultHit(_faults.nack)) {
+    _faultCounts.nacks++;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Short read drawn after a read transaction.
+ *
+ * @param received Cleared by a short read.
+ */
+void CAP1208::injectShortRead(bool &received) {
+  if (_injecting && faultHit(_faults.shortRead)) {
+    _faultCounts.shortReads++;
+    received = false;
+  }
+}
+
+/**
+ * @brief Latency spike drawn at the end of a transaction, the bus is still held.
+ */
+void CAP1208::injectLatency() {
+  if (_injecting && faultHit(_faults.latency)) {
+    _faultCounts.latencySpikes++;
+    delayMicroseconds(_faults.latencyUs);
+  }
+}
+#endif
+
+/**
+ * @brief Program the chip to signal every press, hold-repeat and release per input.
+ *
+ * The chip raises INT (and the ALERT pin) when an input of alertPads is touched, when it is released (releaseAlert),
+ * and, for the inputs of repeatPads held longer than holdMs, every repeatMs. readPadEvents() decodes them. The times
+ * are rounded down to the 35 ms steps of the chip (35 ms to 560 ms). The registers are part of the saved configuration.
+ *
+ * @param alertPads Inputs that raise INT, bit 0 = CS1 (Interrupt Enable).
+ * @param repeatPads Inputs repeated while held (Repeat Rate Enable).
+ * @param holdMs Time before a held input starts repeating (Sensor Input Configuration 2, M_PRESS).
+ * @param repeatMs Repeat period (Sensor Input Configuration, RPT_RATE).
+ * @param releaseAlert Raise INT on a release as well (Configuration 2, INT_REL_n).
+ */
+void CAP1208::configurePadEvents(uint8_t alertPads, uint8_t repeatPads, uint16_t holdMs, uint16_t repeatMs,
+                                 bool releaseAlert) {
+  uint8_t hold = holdMs < 70 ? 0 : (holdMs >= 560 ? 15 : holdMs / 35 - 1);
+  uint8_t repeat = repeatMs < 70 ? 0 : (repeatMs >= 560 ? 15 : repeatMs / 35 - 1);
+
+  updateRegister(INT_ENABLE_CS::of(alertPads));
+  updateRegister(REPEAT_RATE_CS::of(repeatPads));
+  updateRegister(SENSINCONF1_RPT_RATE::of(repeat));
+  updateRegister(SENSINCONF2_M_PRESS::of(hold));
+  updateRegister(CONFIG2_INT_REL_N::of(releaseAlert ? 0 : 1));
+  _repeatPads = repeatPads;
+  _releaseAlert = releaseAlert;
+}
+
+/**
+ * @brief Decode the inputs status into ordered press, repeat and release events.
+ *
+ * One burst read of Main Control to Sensor Input Status gives INT and the latched inputs: an input that was touched
+ * at any time since INT was last cleared stays set. Without INT (and with the release alert on) nothing changed and
+ * the read ends there. Otherwise INT is cleared, which drops the inputs no longer touched, and the inputs are read
+ * again: the latched inputs that were not held are presses, the held or pressed inputs that are gone are releases (a
+ * tap between two reads gives both, in that order). An INT with no press and no release is a hardware repeat of the
+ * held inputs; a repeat that comes with a press or a release in the same read is not reported.
+ *
+ * @param frame Inputs and events of this read.
+ * @return false if a transaction failed (INT stays set, the events come with the next read).
+ */
+bool CAP1208::readPadEvents(CAP1208_PadFrame &frame) {
+  uint32_t errors = _i2cErrors;
+  uint8_t status[4];  // Main Control, (reserved), General Status, Sensor Input Status
+  readRegisters(MAIN_CTRL_REG, status, sizeof(status));
+  if (_i2cErrors != errors) {
+    return false;
+  }
+  frame.count = 0;
+  frame.alert = MAIN_CTRL_INT::get(status[0]);
+  frame.latched = SENSOR_INPUTS_CS::get(status[3]);
+#ifdef CAP1208_FAULT_INJECTION
+  if (_injecting) {
+    frame.latched = (frame.latched & ~_faults.stuckMask) | (_faults.stuckValue & _faults.stuckMask);
+  }
+#endif
+  frame.live = frame.latched;
+  if (frame.alert || !_releaseAlert) {
+    writeRegister(MAIN_CTRL_REG, status[0] & ~MAIN_CTRL_INT::mask);
+    frame.live = readInputs();
+    if (_i2cErrors != errors) {
+      return false;
+    }
+  }
+
+  uint8_t pressed = frame.latched & ~_heldPads;
+  uint8_t released = (_heldPads | pressed) & ~frame.live;
+  uint8_t repeated = frame.alert && pressed == 0 && released == 0 ? _heldPads & _repeatPads : 0;
+  _heldPads = frame.live;
+
+  const uint8_t masks[3] = {pressed, repeated, released};
+  for (uint8_t type = CAP1208_PAD_PRESS; type <= CAP1208_PAD_RELEASE; type++) {
+    for (uint8_t mask = masks[type]; mask != 0; mask &= mask - 1) {
+      frame.events[frame.count].type = type;
+      frame.events[frame.count].pad = __builtin_ctz(mask);
+      frame.count++;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Get the I2C transaction statistics.
+ *
+ * @param stats Structure to fill with the cycles spent per register transaction (zeroed if TOUCHSLIDER_STATS is not defined)
+ */
+void CAP1208::getStats(SliderStageStats &stats) {
+#ifdef TOUCHSLIDER_STATS
+  portENTER_CRITICAL(&_statsMux);
+  _i2cStats.summary(stats);
+  portEXIT_CRITICAL(&_statsMux);
+#else
+  memset(&stats, 0, sizeof(stats));
+#endif
+}
+
+/**
+ * @brief Get the overhead of the I2C transaction statistics.
+ *
+ * @retval Cycles spent recording the transactions since the last resetStats() (0 if TOUCHSLIDER_STATS is not defined)
+ */
+uint32_t CAP1208::getStatsCycles() {
+#ifdef TOUCHSLIDER_STATS
+  return _statsCycles.load(std::memory_order_relaxed);
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Clear the I2C transaction statistics.
+ */
+void CAP1208::resetStats() {
+#ifdef TOUCHSLIDER_STATS
+  portENTER_CRITICAL(&_statsMux);
+  _i2cStats.reset();
+  portEXIT_CRITICAL(&_statsMux);
+  _statsCycles.store(0, std::memory_order_relaxed);
+#endif
+}
+
+#ifdef TOUCHSLIDER_STATS
+/**
+ * @brief  Record the duration of a register transaction
+ *
+ * The update (Ticker) and the configuration calls from loop() both make transactions, on different cores of the
+ * ESP32, so the histogram is only touched under a lock. The cycles spent here, lock included, are the overhead of
+ * the instrumentation (getStatsCycles()).
+ *
+ * @param  start: Cycle count at the start of the transaction
+ */
+void CAP1208::recordTransaction(uint32_t start) {
+  uint32_t end = ESP.getCycleCount();
+  portENTER_CRITICAL(&_statsMux);
+  _i2cStats.record(end - start);
+  portEXIT_CRITICAL(&_statsMux);
+  _statsCycles.fetch_add(ESP.getCycleCount() - end, std::memory_order_relaxed);
+}
+#endif
+
+/**
+ * @brief Reads the delta counts of all the inputs
+ * @note  See datasheet on Sensor Input Delta Count Registers, the 8 registers are read in one transaction
+ *
+ * @param deltas: Array to store the signed delta counts (input 1 first)
+ */
+void CAP1208::getDeltaCounts(int8_t deltas[8]) {
+  readRegisters(SENS1DELTACOUNT, (byte *)deltas, 8);
+}
+
+/**
+ * @brief Reads the general status register
+ * @note  See datasheet on General Status Register
+ * @retval The register value (TOUCH, MTP, MULT, PWR, ACAL_FAIL and BC_OUT bits)
+ */
+uint8_t CAP1208::getGeneralStatus() {
+  return readRegister(GEN_STATUS);
+}
+
+/**
+ * @brief Reads the base counts of the 8 inputs in one transaction
+ * @note  See datasheet on Sensor Input Base Count Registers
+ * @param counts Array to fill, first input first
+ */
+void CAP1208::getBaseCounts(uint8_t counts[8]) {
+  readRegisters(S1BASECOUNT, counts, 8);
+}
+
+/**
+ * @brief Reads the noise flag status register
+ * @retval Bit n set if input n+1 saw noise above the noise threshold
+ */
+uint8_t CAP1208::getNoiseFlags() {
+  return readRegister(NOISE_FLAG);
+}
+
+/**
+ * @brief Reads the calibration activate and status register
+ * @retval Bit n set while input n+1 is being calibrated
+ */
+uint8_t CAP1208::getCalibrationStatus() {
+  return readRegister(CAL_ACTIV);
+}
+
+/**
+ * @brief Reads the base count out of limit register
+ * @retval Bit n set if the last calibration of input n+1 could not bring its base count into range
+ */
+uint8_t CAP1208::getBaseCountOutOfLimit() {
+  return readRegister(BASECOUNT);
 }
 
 /**
@@ -306,17 +903,30 @@ void CAP1208::getTouchData(bool data[8]) {
  * @retval Value of the register
  */
 byte CAP1208::readRegister(CAP1208_Register reg) {
+  if (!acquireBus(1)) {
+    return 0;
+  }
+  CAP1208_INJECT_NACK(0);
+  SLIDER_STATS_STAMP(start);
   _i2cPort->beginTransmission(_deviceAddress);
   _i2cPort->write(reg);
-  _i2cPort->endTransmission(false);                // endTransmission but keep the connection active
-  _i2cPort->requestFrom(_deviceAddress, (byte)1);  // Ask for 1 byte, once done, bus is released by default
+  uint8_t status = _i2cPort->endTransmission(false);  // endTransmission but keep the connection active
+  _i2cPort->requestFrom(_deviceAddress, (byte)1);     // Ask for 1 byte, once done, bus is released by default
 
   // Wait for the data to come back
-  if (_i2cPort->available()) {
-    return _i2cPort->read();  // Return this one byte
-  } else {
-    return 0;
+  byte value = 0;
+  bool received = _i2cPort->available();
+  CAP1208_INJECT_SHORT_READ(received);
+  if (received) {
+    value = _i2cPort->read();  // Return this one byte
   }
+  CAP1208_INJECT_LATENCY();
+#ifdef TOUCHSLIDER_STATS
+  recordTransaction(start);
+#endif
+  checkTransaction(status == 0 && received);  // While the bus is ours, it may change the clock
+  releaseBus();
+  return value;
 }
 
 /**
@@ -327,17 +937,30 @@ byte CAP1208::readRegister(CAP1208_Register reg) {
  * @param  len: Number of bytes to read
  */
 void CAP1208::readRegisters(CAP1208_Register reg, byte *buffer, byte len) {
+  if (!acquireBus(len)) {
+    return;
+  }
+  CAP1208_INJECT_NACK();
+  SLIDER_STATS_STAMP(start);
   _i2cPort->beginTransmission(_deviceAddress);
   _i2cPort->write(reg);
-  _i2cPort->endTransmission(false);            // endTransmission but keep the connection active
-  _i2cPort->requestFrom(_deviceAddress, len);  // Ask for bytes, once done, bus is released by default
+  uint8_t status = _i2cPort->endTransmission(false);  // endTransmission but keep the connection active
+  _i2cPort->requestFrom(_deviceAddress, len);         // Ask for bytes, once done, bus is released by default
 
   // Wait for data to come back
-  if (_i2cPort->available() == len) {
+  bool received = _i2cPort->available() == len;
+  CAP1208_INJECT_SHORT_READ(received);
+  CAP1208_INJECT_LATENCY();
+  if (received) {
     // Iterate through data from buffer
     for (int i = 0; i < len; i++)
       buffer[i] = _i2cPort->read();
   }
+#ifdef TOUCHSLIDER_STATS
+  recordTransaction(start);
+#endif
+  checkTransaction(status == 0 && received);  // While the bus is ours, it may change the clock
+  releaseBus();
 }
 
 /**
@@ -350,6 +973,50 @@ void CAP1208::writeRegister(CAP1208_Register reg, byte data) {
   writeRegisters(reg, &data, 1);
 }
 
+/**
+ * @brief  Take the shared bus for one transaction, if the bus is shared
+ *
+ * A timeout counts as an I2C error (the transaction is skipped) but not in the error rate of the clock tuning, the
+ * bus itself is fine.
+ *
+ * @param  bytes: Data bytes of the transaction
+ * @retval false if the bus was not granted
+ */
+bool CAP1208::acquireBus(uint8_t bytes) {
+  if (_bus == NULL || _bus->acquire(_busClient, _bus->transferUs(bytes))) {
+    return true;
+  }
+  _i2cErrors++;
+  return false;
+}
+
+/**
+ * @brief  Writes some fields of a register in one read-modify-write
+ *
+ * The read is skipped when the fields cover the whole register, the write when the fields already hold the bits or
+ * when the read failed (the other fields would be written as 0).
+ *
+ * @param  reg: Register to update
+ * @param  mask: Bits of the fields to write
+ * @param  bits: New value of the fields (outside the mask are ignored)
+ */
+void CAP1208::updateRegister(CAP1208_Register reg, uint8_t mask, uint8_t bits) {
+  if (mask == 0xFF) {
+    writeRegister(reg, bits);
+    return;
+  }
+  uint32_t errors = _i2cErrors;
+  uint8_t value = readRegister(reg);
+  if (_i2cErrors != errors) {
+    log_w("Register 0x%02X not updated, its read failed", reg);
+    return;
+  }
+  uint8_t updated = (value & ~mask) | (bits & mask);
+  if (updated != value) {
+    writeRegister(reg, updated);
+  }
+}
+
 /**
  * @brief  Writes a multiple registers
  * 
@@ -357,10 +1024,24 @@ void CAP1208::writeRegister(CAP1208_Register reg, byte data) {
  * @param  *buffer: Data to write
  * @param  len: Number of bytes to write
  */
-void CAP1208::writeRegisters(CAP1208_Register reg, byte *buffer, byte len) {
+void CAP1208::writeRegisters(CAP1208_Register reg, const byte *buffer, byte len) {
+  if (!acquireBus(len)) {
+    return;
+  }
+  CAP1208_INJECT_NACK();
+  SLIDER_STATS_STAMP(start);
   _i2cPort->beginTransmission(_deviceAddress);
   _i2cPort->write(reg);
   for (int i = 0; i < len; i++)
     _i2cPort->write(buffer[i]);
-  _i2cPort->endTransmission();  // Stop transmitting
+  uint8_t status = _i2cPort->endTransmission();  // Stop transmitting
+  CAP1208_INJECT_LATENCY();
+#ifdef TOUCHSLIDER_STATS
+  recordTransaction(start);
+#endif
+  checkTransaction(status == 0);  // While the bus is ours, it may change the clock
+  releaseBus();
+  if (status == 0) {
+    trackConfig(reg, buffer, len);
+  }
 }
\ No newline at end of file
@@ -9,8 +9,11 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include <atomic>
 
 #include "CAP1208_Registers.h"
+#include "SharedI2CBus.h"
+#include "SliderStats.h"
 
 // Capacitive sensor input (pg. 23)
 #define OFF 0x00  // No touch detecetd
@@ -22,6 +25,16 @@
 #define PWR_TIME_1120_MS 0x02  // 1.12 sec
 #define PWR_TIME_2240_MS 0x03  // 2.24 sec
 
+// I2C bus clock tuning (SMBus/I2C up to 400 kHz, pg. 12)
+#define CAP1208_MAX_CLOCK 400000       // Highest clock probed by tuneBusClock()
+#define CAP1208_TUNE_ITERATIONS 20     // Verification passes per clock step
+#define CAP1208_ERROR_WINDOW 256       // Transactions per error-rate window
+#define CAP1208_ERROR_THRESHOLD 4      // Errors in one window that make the clock step down
+
+// Configuration kept by saveConfig() and restored by checkConfig() after a chip reset
+#define CAP1208_CONFIG_BYTES 11        // Sensitivity to Averaging and Sampling, Interrupt Enable, Repeat Rate, Multiple Touch, Recalibration, Configuration 2
+// #define CAP1208_FAULT_INJECTION     // Inject bus and chip faults (see setFaults()), uncomment this line or add -D CAP1208_FAULT_INJECTION
+
 // Sensitivity for touch detection (pg. 25)
 #define SENSITIVITY_128X 0x00  // Most sensitive
 #define SENSITIVITY_64X 0x01
@@ -32,124 +45,80 @@
 #define SENSITIVITY_2X 0x06
 #define SENSITIVITY_1X 0x07  // Least sensitive
 
-// Sensitivity Control Reg (pg. 25)
-typedef union {
-  struct
-  {
-    uint8_t BASE_SHIFT : 4;
-    uint8_t DELTA_SENSE : 3;
-    uint8_t EMPTY_1 : 1;
-  } SENSITIVITY_CONTROL_FIELDS;
-  uint8_t SENSITIVITY_CONTROL_COMBINED;
-} SENSITIVITY_CONTROL_REG;
-
-// General Status Reg (pg. 23)
-typedef union {
-  struct
-  {
-    uint8_t TOUCH : 1;
-    uint8_t MTP : 1;
-    uint8_t MULT : 1;
-    uint8_t EMPTY_1 : 1;
-    uint8_t PWR : 1;
-    uint8_t ACAL_FAIL : 1;
-    uint8_t BC_OUT : 1;
-    uint8_t EMPTY_2 : 1;
-  } GENERAL_STATUS_FIELDS;
-  uint8_t GENERAL_STATUS_COMBINED;
-} GENERAL_STATUS_REG;
-
-// Sensor Input Status Reg (pg. 23)
-typedef union {
-  struct
-  {
-    uint8_t CS1 : 1;
-    uint8_t CS2 : 1;
-    uint8_t CS3 : 1;
-    uint8_t CS4 : 1;
-    uint8_t CS5 : 1;
-    uint8_t CS6 : 1;
-    uint8_t CS7 : 1;
-    uint8_t CS8 : 1;
-  } SENSOR_INPUT_STATUS_FIELDS;
-  uint8_t SENSOR_INPUT_STATUS_COMBINED;
-} SENSOR_INPUT_STATUS_REG;
-
-// Main Control Register (pg. 22)
-typedef union {
-  struct
-  {
-    uint8_t INT : 1;
-    uint8_t EMPTY_1 : 3;
-    uint8_t DSLEEP : 1;
-    uint8_t STBY : 1;
-    uint8_t EMPTY_2 : 2;
-  } MAIN_CONTROL_FIELDS;
-  uint8_t MAIN_CONTROL_COMBINED;
-} MAIN_CONTROL_REG;
-
-// Power Button Register (pg. 43)
-typedef union {
-  struct
-  {
-    uint8_t PWR_BTN : 3;
-    uint8_t EMPTY_1 : 5;
-  } POWER_BUTTON_FIELDS;
-  uint8_t POWER_BUTTON_COMBINED;
-} POWER_BUTTON_REG;
-
-// Power Button Configuration Register (pg. 43)
-typedef union {
-  struct
-  {
-    uint8_t PWR_TIME : 2;
-    uint8_t PWR_EN : 1;
-    uint8_t EMPTY_1 : 1;
-    uint8_t STBY_PWR_TIME : 2;
-    uint8_t STBY_PWR_EN : 1;
-    uint8_t EMPTY_2 : 1;
-  } POWER_BUTTON_CONFIG_FIELDS;
-  uint8_t POWER_BUTTON_CONFIG_COMBINED;
-} POWER_BUTTON_CONFIG_REG;
-
-// Interrupt Enable Register (pg. 33)
-typedef union {
-  struct
-  {
-    uint8_t CS1_INT_EN : 1;
-    uint8_t CS2_INT_EN : 1;
-    uint8_t CS3_INT_EN : 1;
-    uint8_t CS4_INT_EN : 1;
-    uint8_t CS5_INT_EN : 1;
-    uint8_t CS6_INT_EN : 1;
-    uint8_t CS7_INT_EN : 1;
-    uint8_t CS8_INT_EN : 1;
-  } INTERRUPT_ENABLE_FIELDS;
-  uint8_t INTERRUPT_ENABLE_COMBINED;
-} INTERRUPT_ENABLE_REG;
-
-typedef union {
-  struct
-  {
-    uint8_t EMPTY_1 : 2;
-    uint8_t B_MULT_T : 2;
-    u_int8_t EMPTY_2 : 4;
-    uint8_t MULT_BLK_EN : 1;
-  } MULTI_TOUCH_FIELDS;
-  uint8_t MULTI_TOUCH_COMBINED;
-} MULTI_TOUCH_REG;
-
-typedef union {
-  struct
-  {
-    uint8_t MTP_ALERT : 1;
-    uint8_t COMP_PTRN : 1;
-    uint8_t MTP_THRESHOLD : 2;
-    uint8_t EMPTY_1 : 3;
-    uint8_t MTP_EN : 1;
-  } PATTERN_FIELDS;
-  uint8_t PATTERN_COMBINED;
-} MULTI_TOUCH_PATTERN_REG;
+// Acquisition profile measurement (see measureProfile())
+#define CAP1208_PROFILE_NOISE_FRAMES 64    // Chip cycles sampled for the noise
+#define CAP1208_PROFILE_CYCLE_CHANGES 33   // Delta count updates timed for the cycle time
+
+// Acquisition profile: how the chip samples the inputs (Averaging and Sampling Configuration, Configuration, Recalibration)
+typedef struct {
+  const char *name;
+  uint8_t averaging;      // Samples averaged per measurement, 1 << averaging (0 to 7: 1 to 128)
+  uint8_t sampleTime;     // Time of one sample, 320 us << sampleTime (0 to 3: 320 us to 2.56 ms)
+  uint8_t cycleTime;      // Target time between measurements, 35 ms * (cycleTime + 1) (0 to 3: 35 to 140 ms)
+  bool noiseFilters;      // Digital and analog noise filters (a noisy sample is not counted as a touch)
+  uint8_t recalibration;  // Automatic recalibration speed, RECALCONFIG CAL_CFG (0 = fastest update)
+  uint16_t pollMs;        // TouchSlider update interval that matches the cycle
+} CAP1208_Profile;
+
+// Presets. The chip stretches the cycle when 8 inputs x averaging x sample time do not fit in the cycle time. With
+// TouchSlider::setAutoProfiles() the slider polls at the faster pollMs of the two profiles: an idle low-power profile
+// saves power in the chip, not in the polling.
+enum CAP1208_ProfileId : uint8_t {
+  CAP1208_PROFILE_LOW_LATENCY,  // 1 x 320 us per input, 35 ms cycle: fastest response, most noise
+  CAP1208_PROFILE_BALANCED,     // 4 x 640 us per input, 35 ms cycle (20 ms of sampling)
+  CAP1208_PROFILE_LOW_NOISE,    // 16 x 640 us per input, 82 ms cycle: stable deltas for noisy panels
+  CAP1208_PROFILE_LOW_POWER,    // 1 x 320 us per input, 140 ms cycle: the chip sleeps 98% of the time
+  CAP1208_PROFILE_COUNT
+};
+
+extern const CAP1208_Profile CAP1208_PROFILES[CAP1208_PROFILE_COUNT];
+
+typedef struct {
+  uint32_t cycleUs;      // Measured time between two measurements of the chip (median), 0 if not measurable
+  uint16_t noiseRms[8];  // RMS of the delta counts per input, in 1/16 counts
+  uint8_t noisePeak[8];  // Largest absolute delta count per input
+  uint8_t noiseFlags;    // Inputs that raised their noise flag during the measurement
+} CAP1208_ProfileReport;
+
+// Hardware press, hold-repeat and release events (see configurePadEvents() and readPadEvents())
+#define CAP1208_PAD_EVENTS_MAX 24      // A press, a repeat and a release per input
+
+enum CAP1208_PadEventType : uint8_t {
+  CAP1208_PAD_PRESS,    // The input started being touched (also for a tap that ended before the read)
+  CAP1208_PAD_REPEAT,   // The chip repeated a held input (Repeat Rate)
+  CAP1208_PAD_RELEASE,  // The input stopped being touched
+};
+
+typedef struct {
+  uint8_t type;  // CAP1208_PadEventType
+  uint8_t pad;   // Input, 0 = CS1
+} CAP1208_PadEvent;
+
+typedef struct {
+  uint8_t latched;  // Inputs touched since the previous read (taps included), as getTouchData()
+  uint8_t live;     // Inputs touched now, as getLiveInputs()
+  bool alert;       // INT was set: the chip signalled a press, a repeat or a release
+  uint8_t count;    // Events in order: presses, repeats, releases (a tap gives its press then its release)
+  CAP1208_PadEvent events[CAP1208_PAD_EVENTS_MAX];
+} CAP1208_PadFrame;
+
+// Faults injected into the register transactions when CAP1208_FAULT_INJECTION is defined (soak and recovery tests)
+typedef struct {
+  uint32_t nack;        // Transactions not acknowledged (nothing reaches the chip), per million
+  uint32_t shortRead;   // Reads that return fewer bytes than requested, per million
+  uint32_t reset;       // Transactions after which the chip is back to its register defaults, per million
+  uint32_t latency;     // Transactions that hold the bus latencyUs longer, per million
+  uint16_t latencyUs;   // Length of a latency spike
+  uint8_t stuckMask;    // Sensor Input Status bits stuck at stuckValue
+  uint8_t stuckValue;
+} CAP1208_Faults;
+
+typedef struct {
+  uint32_t nacks;
+  uint32_t shortReads;
+  uint32_t resets;
+  uint32_t latencySpikes;
+} CAP1208_FaultCounts;
 
 ////////////////////////////////
 // CAP1208 Class Declearation //
@@ -159,7 +128,7 @@ class CAP1208 {
   // Constructor
   CAP1208(byte addr = CAP1208ADDR);
 
-  bool begin(TwoWire &wirePort = Wire, uint8_t deviceAddress = CAP1208ADDR);
+  bool begin(TwoWire &wirePort = Wire, uint8_t deviceAddress = CAP1208ADDR, bool autoTuneClock = false);
   bool start();
   bool isConnected();
   void setSensitivity(uint8_t sensitivity);
@@ -170,12 +139,26 @@ class CAP1208 {
   void ActiveMode();
   void SleepMode();
   void ConfigureMultiTouch(uint8_t number);
+  bool setProfile(const CAP1208_Profile &profile);                               // Apply in one burst write
+  bool measureProfile(const CAP1208_Profile &profile, CAP1208_ProfileReport &report);  // Cycle time and noise, untouched pads
 
   // Gett the Touch Data
-  void getTouchData(bool data[8]);
+  bool getTouchData(bool data[8]);        // false if the read failed (data and the latch are left as they were)
+  uint8_t getLiveInputs();                // Inputs touched now (call after getTouchData(), which clears the latch), 0xFF if the read failed
+  void getDeltaCounts(int8_t deltas[8]);  // Signed delta counts of the 8 inputs
+  uint8_t getGeneralStatus();             // Raw General Status register
+  void getBaseCounts(uint8_t counts[8]);  // Base counts of the 8 inputs
+  uint8_t getNoiseFlags();                // Raw Noise Flag Status register
+  uint8_t getCalibrationStatus();         // Raw Calibration Activate and Status register
+  uint8_t getBaseCountOutOfLimit();       // Raw Base Count Out of Limit register
 
   bool isTouched();
 
+  // Hardware pad events
+  void configurePadEvents(uint8_t alertPads = 0xFF, uint8_t repeatPads = 0xFF, uint16_t holdMs = 280,
+                          uint16_t repeatMs = 175, bool releaseAlert = true);
+  bool readPadEvents(CAP1208_PadFrame &frame);  // Decode the status since the previous read, false if the read failed
+
   // Clears INT bit
   void clearInterrupt();
 
@@ -189,15 +172,93 @@ class CAP1208 {
 
   uint8_t readID();
 
+  // I2C bus clock
+  uint32_t tuneBusClock(uint32_t maxClock = CAP1208_MAX_CLOCK);  // Select the fastest reliable clock
+  uint32_t getBusClock() { return _busClock; };                    // Clock in use, 0 if never tuned
+  uint16_t getTransactionTimeUs() { return _transactionTimeUs; };  // Measured time of a one-byte register read
+  uint32_t getI2CErrors() { return _i2cErrors; };                  // NACKs and short reads since begin()
+
+  // Chip reset detection
+  bool saveConfig();                                    // Keep the current configuration (later writes of the library follow)
+  bool checkConfig();                                   // Restore the saved configuration if the chip lost it, true if it did
+  uint16_t getChipResets() { return _chipResets; };     // Configuration losses repaired by checkConfig()
+
+  // Fault injection (needs CAP1208_FAULT_INJECTION)
+  void setFaults(const CAP1208_Faults &faults, uint32_t seed = 1);
+  void clearFaults();
+  void getFaultCounts(CAP1208_FaultCounts &counts);  // Faults injected since setFaults()
+
+  // Shared bus (see SharedI2CBus.h)
+  void setBus(SharedI2CBus *bus, int8_t client) { _bus = bus; _busClient = client; };  // Arbitrate every transaction, NULL to stop
+
+  // Instrumentation (needs TOUCHSLIDER_STATS, see SliderStats.h)
+  void getStats(SliderStageStats &stats);  // Cycles per I2C transaction
+  uint32_t getStatsCycles();               // Cycles spent recording them
+  void resetStats();
+
  private:
   TwoWire *_i2cPort = NULL;  // The generic connection to user's chosen I2C hardware
   uint8_t _deviceAddress;    // Keeps track of I2C address. setI2CAddress changes this.
 
+#ifdef TOUCHSLIDER_STATS
+  SliderHistogram _i2cStats;  // Duration of every register transaction
+  std::atomic<uint32_t> _statsCycles{0};                  // Cycles spent in recordTransaction()
+  portMUX_TYPE _statsMux = portMUX_INITIALIZER_UNLOCKED;  // Transactions come from the Ticker and from loop()
+#endif
+
+  int8_t _clockStep = -1;            // Index in the clock steps, -1 if the clock is not managed
+  uint32_t _busClock = 0;
+  uint16_t _transactionTimeUs = 0;
+  uint32_t _i2cErrors = 0;
+  uint16_t _windowTransactions = 0;  // Transactions in the current error-rate window
+  uint8_t _windowErrors = 0;         // Errors in the current error-rate window
+  SharedI2CBus *_bus = NULL;         // Arbiter of a shared bus, NULL if the bus is not shared
+  int8_t _busClient = -1;
+
+  uint8_t _heldPads = 0;             // Inputs touched at the previous readPadEvents()
+  uint8_t _repeatPads = 0xFF;        // Inputs with the hardware repeat enabled
+  bool _releaseAlert = true;         // INT is raised on a release too (CONFIG2 INT_REL_n = 0, default)
+
+  uint8_t _config[CAP1208_CONFIG_BYTES];  // Saved configuration, in the order of the configuration ranges
+  bool _configSaved = false;
+  uint16_t _chipResets = 0;
+
+#ifdef CAP1208_FAULT_INJECTION
+  CAP1208_Faults _faults = {};
+  CAP1208_FaultCounts _faultCounts = {};
+  uint32_t _faultRandom = 1;  // xorshift32 state
+  bool _injecting = false;    // Faults are being injected (off while a reset is emulated)
+#endif
+
+  bool verifyBus();
+  uint16_t measureTransactionTime();
+  void checkTransaction(bool ok);
+  uint8_t readInputs();
+#ifdef TOUCHSLIDER_STATS
+  void recordTransaction(uint32_t start);
+#endif
+  bool acquireBus(uint8_t bytes);
+  void releaseBus() { if (_bus != NULL) _bus->release(_busClient); };
+  void trackConfig(uint8_t reg, const byte *buffer, byte len);
+  bool readConfig(uint8_t config[CAP1208_CONFIG_BYTES]);
+  void writeConfig(const uint8_t config[CAP1208_CONFIG_BYTES]);
+#ifdef CAP1208_FAULT_INJECTION
+  bool faultHit(uint32_t perMillion);
+  bool injectBefore();
+  void injectShortRead(bool &received);
+  void injectLatency();
+#endif
+
   // Read and write to registers
   byte readRegister(CAP1208_Register reg);
   void readRegisters(CAP1208_Register reg, byte *buffer, byte len);
   void writeRegister(CAP1208_Register reg, byte data);
-  void writeRegisters(CAP1208_Register reg, byte *buffer, byte len);
+  void writeRegisters(CAP1208_Register reg, const byte *buffer, byte len);
+  void updateRegister(CAP1208_Register reg, uint8_t mask, uint8_t bits);
+
+  // Write some fields of a register, the others are kept (see CAP1208_Registers.h)
+  template <CAP1208_Register REG>
+  void updateRegister(CAP1208_Value<REG> value) { updateRegister(REG, value.mask, value.bits); }
 };
 
 #endif
\ No newline at end of file
@@ -7,9 +7,12 @@
 #ifndef CAP1208_REGISTERS_H
 #define CAP1208_REGISTERS_H
 
+#include <stdint.h>
+
 #define CAP1208ADDR	  0x28		    // 0x28 - not shifted
 
 #define PROD_ID_VALUE 0x6B        // Product ID - always the same (pg. 22)
+#define MAN_ID_VALUE  0x5D        // Manufacturer ID - always the same (pg. 22)
 
 enum CAP1208_Register
 {
@@ -84,4 +87,126 @@ enum CAP1208_Register
   REV =						    0xFF,	
 };
 
+/*********************** REGISTER FIELDS **********************/
+
+/*
+ * Every field is a type giving its register, position and width. Values are built at compile time and the fields of
+ * one register combine with |, so a multi-field update is a single mask and set:
+ *
+ *   updateRegister(MAIN_CTRL_STBY::set<0>() | MAIN_CTRL_DSLEEP::set<1>());   // constant values, checked widths
+ *   updateRegister(SENSITIVITY_DELTA_SENSE::of(sensitivity));                  // run-time value, truncated
+ *   MAIN_CTRL_INT::get(readRegister(MAIN_CTRL_REG));                           // extract a field
+ *
+ * A constant that does not fit its field and fields of different registers combined with | do not compile.
+ */
+
+// Bits of some fields of a register, with the mask of those fields
+template <CAP1208_Register REG>
+struct CAP1208_Value {
+  uint8_t mask;
+  uint8_t bits;
+
+  constexpr CAP1208_Value operator|(CAP1208_Value other) const {
+    return {(uint8_t)(mask | other.mask), (uint8_t)(bits | other.bits)};
+  }
+};
+
+template <CAP1208_Register REG, uint8_t SHIFT, uint8_t WIDTH>
+struct CAP1208_Field {
+  static_assert(WIDTH >= 1 && SHIFT + WIDTH <= 8, "A field must fit in its 8-bit register");
+
+  static constexpr CAP1208_Register reg = REG;
+  static constexpr uint8_t max = (1u << WIDTH) - 1;
+  static constexpr uint8_t mask = max << SHIFT;
+
+  static constexpr uint8_t get(uint8_t value) { return (value & mask) >> SHIFT; }
+
+  static constexpr CAP1208_Value<REG> of(uint8_t value) { return {mask, (uint8_t)((value << SHIFT) & mask)}; }
+
+  template <uint8_t VALUE>
+  static constexpr CAP1208_Value<REG> set() {
+    static_assert(VALUE <= max, "Value too wide for the field");
+    return {mask, (uint8_t)(VALUE << SHIFT)};
+  }
+};
+
+// Main Control (pg. 22)
+typedef CAP1208_Field<MAIN_CTRL_REG, 5, 1> MAIN_CTRL_STBY;
+typedef CAP1208_Field<MAIN_CTRL_REG, 4, 1> MAIN_CTRL_DSLEEP;
+typedef CAP1208_Field<MAIN_CTRL_REG, 0, 1> MAIN_CTRL_INT;
+
+// General Status (pg. 23)
+typedef CAP1208_Field<GEN_STATUS, 6, 1> GEN_STATUS_BC_OUT;
+typedef CAP1208_Field<GEN_STATUS, 5, 1> GEN_STATUS_ACAL_FAIL;
+typedef CAP1208_Field<GEN_STATUS, 4, 1> GEN_STATUS_PWR;
+typedef CAP1208_Field<GEN_STATUS, 2, 1> GEN_STATUS_MULT;
+typedef CAP1208_Field<GEN_STATUS, 1, 1> GEN_STATUS_MTP;
+typedef CAP1208_Field<GEN_STATUS, 0, 1> GEN_STATUS_TOUCH;
+
+// Sensor Input Status (pg. 23), bit n = input n+1
+typedef CAP1208_Field<SENSOR_INPUTS, 0, 8> SENSOR_INPUTS_CS;
+
+// Sensitivity Control (pg. 25)
+typedef CAP1208_Field<SENSITIVITY, 4, 3> SENSITIVITY_DELTA_SENSE;
+typedef CAP1208_Field<SENSITIVITY, 0, 4> SENSITIVITY_BASE_SHIFT;
+
+// Configuration
+typedef CAP1208_Field<CONFIG1, 7, 1> CONFIG1_TIMEOUT;
+typedef CAP1208_Field<CONFIG1, 5, 1> CONFIG1_DIS_DIG_NOISE;
+typedef CAP1208_Field<CONFIG1, 4, 1> CONFIG1_DIS_ANA_NOISE;
+typedef CAP1208_Field<CONFIG1, 3, 1> CONFIG1_MAX_DUR_EN;
+
+// Sensor Input Configuration 1 and 2
+typedef CAP1208_Field<SENSINCONF1, 4, 4> SENSINCONF1_MAX_DUR;
+typedef CAP1208_Field<SENSINCONF1, 0, 4> SENSINCONF1_RPT_RATE;
+typedef CAP1208_Field<SENSINCONF2, 0, 4> SENSINCONF2_M_PRESS;
+
+// Averaging and Sampling Configuration
+typedef CAP1208_Field<AVERAGE_SAMP_CONF, 4, 3> AVERAGE_SAMP_AVG;
+typedef CAP1208_Field<AVERAGE_SAMP_CONF, 2, 2> AVERAGE_SAMP_SAMP_TIME;
+typedef CAP1208_Field<AVERAGE_SAMP_CONF, 0, 2> AVERAGE_SAMP_CYCLE_TIME;
+
+// Interrupt Enable and Repeat Rate Enable (pg. 33), bit n = input n+1
+typedef CAP1208_Field<INT_ENABLE, 0, 8> INT_ENABLE_CS;
+typedef CAP1208_Field<REPEAT_RATE, 0, 8> REPEAT_RATE_CS;
+
+// Multiple Touch Configuration
+typedef CAP1208_Field<MULTITOUCH, 7, 1> MULTITOUCH_MULT_BLK_EN;
+typedef CAP1208_Field<MULTITOUCH, 2, 2> MULTITOUCH_B_MULT_T;
+
+// Multiple Touch Pattern Configuration
+typedef CAP1208_Field<MULTIPATCONF, 7, 1> MULTIPATCONF_MTP_EN;
+typedef CAP1208_Field<MULTIPATCONF, 2, 2> MULTIPATCONF_MTP_TH;
+typedef CAP1208_Field<MULTIPATCONF, 1, 1> MULTIPATCONF_COMP_PTRN;
+typedef CAP1208_Field<MULTIPATCONF, 0, 1> MULTIPATCONF_MTP_ALERT;
+
+// Recalibration Configuration
+typedef CAP1208_Field<RECALCONFIG, 7, 1> RECALCONFIG_BUT_LD_TH;
+typedef CAP1208_Field<RECALCONFIG, 6, 1> RECALCONFIG_NO_CLR_INTD;
+typedef CAP1208_Field<RECALCONFIG, 5, 1> RECALCONFIG_NO_CLR_NEG;
+typedef CAP1208_Field<RECALCONFIG, 3, 2> RECALCONFIG_NEG_DELTA_CNT;
+typedef CAP1208_Field<RECALCONFIG, 0, 3> RECALCONFIG_CAL_CFG;
+
+// Configuration 2
+typedef CAP1208_Field<CONFIG2, 6, 1> CONFIG2_BC_OUT_RECAL;
+typedef CAP1208_Field<CONFIG2, 5, 1> CONFIG2_BLK_PWR_CTRL;
+typedef CAP1208_Field<CONFIG2, 4, 1> CONFIG2_BC_OUT_INT;
+typedef CAP1208_Field<CONFIG2, 3, 1> CONFIG2_SHOW_RF_NOISE;
+typedef CAP1208_Field<CONFIG2, 2, 1> CONFIG2_DIS_RF_NOISE;
+typedef CAP1208_Field<CONFIG2, 1, 1> CONFIG2_ACAL_FAIL_INT;
+typedef CAP1208_Field<CONFIG2, 0, 1> CONFIG2_INT_REL_N;
+
+// Power Button (pg. 43)
+typedef CAP1208_Field<PWR_BUTTON, 0, 3> PWR_BUTTON_PWR_BTN;
+typedef CAP1208_Field<PWR_CONFIG, 6, 1> PWR_CONFIG_STBY_PWR_EN;
+typedef CAP1208_Field<PWR_CONFIG, 4, 2> PWR_CONFIG_STBY_PWR_TIME;
+typedef CAP1208_Field<PWR_CONFIG, 2, 1> PWR_CONFIG_PWR_EN;
+typedef CAP1208_Field<PWR_CONFIG, 0, 2> PWR_CONFIG_PWR_TIME;
+
+// The layout the unions of the previous versions described, checked at compile time
+static_assert((MAIN_CTRL_STBY::set<1>() | MAIN_CTRL_DSLEEP::set<1>() | MAIN_CTRL_INT::set<1>()).bits == 0x31, "Main Control layout");
+static_assert((MULTITOUCH_MULT_BLK_EN::set<1>() | MULTITOUCH_B_MULT_T::set<3>()).bits == 0x8C, "Multiple Touch layout");
+static_assert(SENSITIVITY_DELTA_SENSE::mask == 0x70 && SENSITIVITY_BASE_SHIFT::mask == 0x0F, "Sensitivity layout");
+static_assert((AVERAGE_SAMP_AVG::mask | AVERAGE_SAMP_SAMP_TIME::mask | AVERAGE_SAMP_CYCLE_TIME::mask) == 0x7F, "Averaging layout");
+
 #endif
\ No newline at end of file
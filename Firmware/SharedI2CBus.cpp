@@ -0,0 +1,400 @@
+#include "SharedI2CBus.h"
+
+/**
+ * @brief Create the arbiter of a Wire bus.
+ *
+ * @param wire Bus shared by the clients.
+ */
+SharedI2CBus::SharedI2CBus(TwoWire& wire) : _wire(&wire) {}
+
+/**
+ * @brief Read the bus clock and start the statistics.
+ */
+void SharedI2CBus::begin() {
+  uint32_t clock = _wire->getClock();
+  _clockHz = clock != 0 ? clock : 100000;
+  resetStats();
+}
+
+/**
+ * @brief Register a client that uses the bus when it needs to. Register all the clients before using the bus.
+ *
+ * @param name Name in the statistics.
+ * @param priority Higher goes first when several clients wait.
+ * @param deadlineUs Longest acceptable wait for the bus, longer waits are counted as misses (0 = no deadline).
+ * @return Client id, -1 if the table is full.
+ */
+int8_t SharedI2CBus::addClient(const char* name, uint8_t priority, uint32_t deadlineUs) {
+  if (_count >= SHARED_I2C_MAX_CLIENTS) {
+    log_e("No room for I2C client %s", name);
+    return -1;
+  }
+  Client& c = _clients[_count];
+  memset(&c, 0, sizeof(c));
+  c.name = name;
+  c.priority = priority;
+  c.deadlineUs = deadlineUs;
+  return _count++;
+}
+
+/**
+ * @brief Register a periodic client, such as the touch poll, whose slot is kept free from lower priority transfers.
+ *
+ * @param name Name in the statistics.
+ * @param priority Higher goes first; only clients of lower priority are kept out of the slot.
+ * @param periodUs Time between two polls.
+ * @param slotUs Time the client needs the bus for at each poll (all its transactions).
+ * @param deadlineUs Longest acceptable wait for the bus (0 = no deadline).
+ * @return Client id, -1 if the table is full.
+ */
+int8_t SharedI2CBus::addPeriodicClient(const char* name, uint8_t priority, uint32_t periodUs, uint32_t slotUs,
+                                       uint32_t deadlineUs) {
+  int8_t id = addClient(name, priority, deadlineUs);
+  if (id >= 0) {
+    _clients[id].periodUs = periodUs;
+    _clients[id].slotUs = slotUs;
+  }
+  return id;
+}
+
+/**
+ * @brief Change the period of a periodic client, the phase is learned again from its next grant.
+ */
+void SharedI2CBus::setPeriod(int8_t client, uint32_t periodUs) {
+  if (!valid(client)) {
+    return;
+  }
+  portENTER_CRITICAL(&_mux);
+  _clients[client].periodUs = periodUs;
+  _clients[client].slotKnown = false;
+  portEXIT_CRITICAL(&_mux);
+}
+
+/**
+ * @brief Replace the clock and the waits of acquire(), e.g. by a simulated clock on the host.
+ *
+ * @param now Time in microseconds, as micros().
+ * @param wait Waits a number of microseconds, it must let the simulated time run. NULL for delayMicroseconds() and
+ *             delay().
+ */
+void SharedI2CBus::setClock(unsigned long (*now)(), void (*wait)(uint32_t us)) {
+  _now = now;
+  _wait = wait != NULL ? wait : sleepUs;
+}
+
+/**
+ * @brief Default wait of acquire(): a short spin, or sleep whole ticks so the owner can run on the same core.
+ */
+void SharedI2CBus::sleepUs(uint32_t us) {
+  if (us < 1000) {
+    delayMicroseconds(us);
+  } else {
+    delay(us / 1000);
+  }
+}
+
+/**
+ * @brief Wait for the bus.
+ *
+ * While the owner should still be transferring (from its estimate) the wait spins, after that it sleeps one tick
+ * between attempts so the owner can run on the same core. The time and the waits go through the clock of setClock().
+ *
+ * @param client Client id.
+ * @param durationUs Estimated time the client will hold the bus (transferUs()), 0 if short.
+ * @return false if the bus was not granted within SHARED_I2C_TIMEOUT_MS (counted as a deadline miss).
+ */
+bool SharedI2CBus::acquire(int8_t client, uint32_t durationUs) {
+  if (!valid(client)) {
+    return false;
+  }
+  uint32_t start = _now();
+  while (!tryAcquire(client, durationUs)) {
+    if (_now() - start >= SHARED_I2C_TIMEOUT_MS * 1000UL) {
+      cancel(client);
+      portENTER_CRITICAL(&_mux);
+      _clients[client].stats.deadlineMisses++;
+      portEXIT_CRITICAL(&_mux);
+      log_w("I2C client %s timed out", _clients[client].name);
+      return false;
+    }
+    if ((int32_t)(_now() - _grantUs) < (int32_t)(SHARED_I2C_GUARD_US)) {
+      _wait(20);  // The owner has just started, it should be done soon
+    } else {
+      _wait(1000);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Take the bus if the arbitration allows it now, without waiting.
+ *
+ * The first call of a request starts the wait of the client; it stays queued (taking precedence over the clients of
+ * lower priority) until a call succeeds or cancel() is called.
+ *
+ * @param client Client id.
+ * @param durationUs Estimated time the client will hold the bus (transferUs()), 0 if short (one byte).
+ * @return true if the client now owns the bus.
+ */
+bool SharedI2CBus::tryAcquire(int8_t client, uint32_t durationUs) {
+  if (!valid(client)) {
+    return false;
+  }
+  if (durationUs == 0) {
+    durationUs = transferUs(1);  // Even a short transfer must not start inside a reserved slot
+  }
+  portENTER_CRITICAL(&_mux);
+  uint32_t now = _now();
+  Client& c = _clients[client];
+  if (!c.waiting) {
+    c.waiting = true;
+    c.deferred = false;
+    c.requestUs = now;
+  }
+
+  bool granted = _owner < 0;
+  for (uint8_t i = 0; granted && i < _count; i++) {
+    granted = i == client || !_clients[i].waiting || _clients[i].priority <= c.priority;  // Higher priority first
+  }
+  bool conflict = false;
+  if (granted) {
+    uint32_t gapUs;
+    uint32_t freeUs = freeUntil(client, now, gapUs);
+    if (freeUs == 0 || durationUs > freeUs) {
+      // Never inside a slot or its guard. A transfer longer than any gap would wait forever: let it start early in a
+      // gap and report it
+      conflict = durationUs > gapUs && freeUs != 0 && freeUs >= gapUs / 2;
+      granted = conflict;
+      if (!granted && !c.deferred) {
+        c.deferred = true;
+        c.stats.deferrals++;
+      }
+    }
+  }
+
+  if (granted) {
+    _owner = client;
+    _grantUs = now;
+    c.waiting = false;
+    uint32_t wait = now - c.requestUs;
+    c.stats.transfers++;
+    c.stats.maxWaitUs = wait > c.stats.maxWaitUs ? wait : c.stats.maxWaitUs;
+    if (c.deadlineUs != 0 && wait > c.deadlineUs) {
+      c.stats.deadlineMisses++;
+    }
+    if (conflict) {
+      c.stats.slotConflicts++;
+    }
+    if (c.periodUs != 0 && (!c.slotKnown || c.requestUs - c.slotStartUs >= c.periodUs / 2)) {
+      c.slotStartUs = c.requestUs;  // First request of a poll: the slot starts there, even if this grant came late
+      c.slotKnown = true;
+    }
+  }
+  portEXIT_CRITICAL(&_mux);
+  return granted;
+}
+
+/**
+ * @brief Leave the queue after tryAcquire() failed and the client gives up.
+ */
+void SharedI2CBus::cancel(int8_t client) {
+  if (!valid(client)) {
+    return;
+  }
+  portENTER_CRITICAL(&_mux);
+  _clients[client].waiting = false;
+  portEXIT_CRITICAL(&_mux);
+}
+
+/**
+ * @brief Give the bus back.
+ *
+ * The bus clock is read again: the owner may have changed it (CAP1208 steps it down on errors), and the estimates of
+ * transferUs() and fitBytes() must follow before the next client is granted.
+ */
+void SharedI2CBus::release(int8_t client) {
+  uint32_t clock = _wire->getClock();
+  portENTER_CRITICAL(&_mux);
+  if (client == _owner) {
+    _clients[client].stats.busyUs += _now() - _grantUs;
+    _owner = -1;
+    if (clock != 0) {
+      _clockHz = clock;
+    }
+  }
+  portEXIT_CRITICAL(&_mux);
+}
+
+/**
+ * @brief Time to read or write some bytes of a register-addressed device: address, register, repeated address and
+ *        the data, 9 clocks each.
+ */
+uint32_t SharedI2CBus::transferUs(uint16_t bytes) const {
+  return (uint32_t)(((uint64_t)bytes + 3) * 9 * 1000000 / _clockHz);
+}
+
+/**
+ * @brief Bytes the client can move now and still leave the next reserved slot free.
+ */
+uint16_t SharedI2CBus::fitBytes(int8_t client) const {
+  if (!valid(client)) {
+    return 0;
+  }
+  uint32_t gapUs;
+  uint32_t freeUs = freeUntil(client, _now(), gapUs);
+  uint64_t bytes = (uint64_t)freeUs * _clockHz / 9 / 1000000;
+  return bytes <= 3 ? 0 : bytes - 3 > 0xFFFF ? 0xFFFF : bytes - 3;
+}
+
+/**
+ * @brief Read consecutive registers in chunks that fit between the reserved slots.
+ *
+ * The device must increment the register address on its own (most sensors, fuel gauges and EEPROMs with 8-bit
+ * addresses); each chunk starts at reg plus the bytes already read.
+ *
+ * @return false if a chunk could not be read (NACK, short read or bus timeout).
+ */
+bool SharedI2CBus::readChunked(int8_t client, uint8_t address, uint8_t reg, uint8_t* buffer, uint16_t len) {
+  for (uint16_t done = 0; done < len;) {
+    uint16_t chunk = len - done < SHARED_I2C_MAX_CHUNK ? len - done : SHARED_I2C_MAX_CHUNK;
+    uint16_t fit = fitBytes(client);
+    if (fit >= SHARED_I2C_MIN_CHUNK && fit < chunk) {
+      chunk = fit;
+    }
+    if (!acquire(client, transferUs(chunk))) {
+      return false;
+    }
+    _wire->beginTransmission(address);
+    _wire->write((uint8_t)(reg + done));
+    bool ok = _wire->endTransmission(false) == 0;
+    ok = ok && _wire->requestFrom(address, (uint8_t)chunk) == chunk;
+    for (uint16_t i = 0; ok && i < chunk; i++) {
+      buffer[done + i] = _wire->read();
+    }
+    release(client);
+    if (!ok) {
+      return false;
+    }
+    done += chunk;
+  }
+  return true;
+}
+
+/**
+ * @brief Write consecutive registers in chunks that fit between the reserved slots (see readChunked()).
+ *
+ * @return false if a chunk was not acknowledged or the bus timed out.
+ */
+bool SharedI2CBus::writeChunked(int8_t client, uint8_t address, uint8_t reg, const uint8_t* buffer, uint16_t len) {
+  for (uint16_t done = 0; done < len;) {
+    uint16_t chunk = len - done < SHARED_I2C_MAX_CHUNK ? len - done : SHARED_I2C_MAX_CHUNK;
+    uint16_t fit = fitBytes(client);
+    if (fit >= SHARED_I2C_MIN_CHUNK && fit < chunk) {
+      chunk = fit;
+    }
+    if (!acquire(client, transferUs(chunk))) {
+      return false;
+    }
+    _wire->beginTransmission(address);
+    _wire->write((uint8_t)(reg + done));
+    _wire->write(buffer + done, chunk);
+    bool ok = _wire->endTransmission() == 0;
+    release(client);
+    if (!ok) {
+      return false;
+    }
+    done += chunk;
+  }
+  return true;
+}
+
+/**
+ * @brief Get the statistics of a client.
+ *
+ * @return false if the id is not a client.
+ */
+bool SharedI2CBus::getClientStats(int8_t client, SharedI2CClientStats& stats) const {
+  if (!valid(client)) {
+    return false;
+  }
+  stats = _clients[client].stats;
+  return true;
+}
+
+/**
+ * @brief Log the bus occupancy and the deadline misses of every client since the last reset.
+ */
+void SharedI2CBus::printStats() const {
+  uint32_t window = getStatsWindowUs();
+  (void)window;  // Unused when the log level leaves log_i out
+  for (uint8_t i = 0; i < _count; i++) {
+    const SharedI2CClientStats& s = _clients[i].stats;
+    (void)s;
+    log_i("%-8s n=%lu busy=%.1f%% maxWait=%luus misses=%lu deferred=%lu conflicts=%lu", _clients[i].name,
+          (unsigned long)s.transfers, window ? 100.0f * s.busyUs / window : 0.0f, (unsigned long)s.maxWaitUs,
+          (unsigned long)s.deadlineMisses, (unsigned long)s.deferrals, (unsigned long)s.slotConflicts);
+  }
+}
+
+/**
+ * @brief Clear the statistics of every client.
+ */
+void SharedI2CBus::resetStats() {
+  portENTER_CRITICAL(&_mux);
+  for (uint8_t i = 0; i < _count; i++) {
+    memset(&_clients[i].stats, 0, sizeof(_clients[i].stats));
+  }
+  _statsSinceUs = _now();
+  portEXIT_CRITICAL(&_mux);
+}
+
+/**
+ * @brief Start of the slot of a periodic client that is running or comes next.
+ *
+ * @param slotStartUs Start of the last slot of the client.
+ * @param periodUs Period of the client.
+ * @param slotUs Length of its slot.
+ * @param now Current time.
+ * @param start Start of the slot (in the past if it is running, or if the client is late for it).
+ * @return false if the client has no slot to protect (phase unknown, or it stopped polling).
+ */
+static bool slotAround(uint32_t slotStartUs, uint32_t periodUs, uint32_t slotUs, uint32_t now, uint32_t& start) {
+  uint32_t since = now - slotStartUs;
+  if (since >= periodUs * SHARED_I2C_SLOT_TIMEOUT) {
+    return false;
+  }
+  uint32_t periods = since / periodUs;
+  start = slotStartUs + periods * periodUs;
+  if (since - periods * periodUs >= slotUs) {
+    start += periodUs;  // The slot of this period is over, protect the next one
+  }
+  return true;
+}
+
+/**
+ * @brief Time the client can hold the bus from now without entering a slot reserved by a client of higher priority.
+ *
+ * @param client Client id.
+ * @param now Current time.
+ * @param gapUs Free time between two slots of the closest reserving client (the longest transfer that can ever fit).
+ * @return Free time, 0 inside a reserved slot or its guard, 0xFFFFFFFF if nothing is reserved.
+ */
+uint32_t SharedI2CBus::freeUntil(int8_t client, uint32_t now, uint32_t& gapUs) const {
+  uint32_t freeUs = 0xFFFFFFFF;
+  gapUs = 0xFFFFFFFF;
+  for (uint8_t i = 0; i < _count; i++) {
+    const Client& p = _clients[i];
+    uint32_t start;
+    if (i == client || p.periodUs == 0 || !p.slotKnown || p.priority <= _clients[client].priority ||
+        !slotAround(p.slotStartUs, p.periodUs, p.slotUs, now, start)) {
+      continue;
+    }
+    int32_t untilGuard = (int32_t)(start - SHARED_I2C_GUARD_US - now);
+    uint32_t available = untilGuard > 0 ? untilGuard : 0;
+    if (available < freeUs) {
+      freeUs = available;
+      gapUs = p.periodUs > p.slotUs + SHARED_I2C_GUARD_US ? p.periodUs - p.slotUs - SHARED_I2C_GUARD_US : 0;
+    }
+  }
+  return freeUs;
+}
@@ -0,0 +1,108 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SHAREDI2CBUS_H
+#define SHAREDI2CBUS_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/FreeRTOS.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SHARED_I2C_MAX_CLIENTS 6      // Size of the static client table
+#define SHARED_I2C_GUARD_US 300       // Margin kept free before a reserved slot
+#define SHARED_I2C_TIMEOUT_MS 50      // Longest wait of acquire() before giving up
+#define SHARED_I2C_MAX_CHUNK 32       // Largest chunk of readChunked()/writeChunked() (Wire buffer)
+#define SHARED_I2C_MIN_CHUNK 4        // Smaller gaps before a slot are not used by the chunked transfers
+#define SHARED_I2C_SLOT_TIMEOUT 4     // Periods without a poll before the reservation of a periodic client is dropped
+
+/*********************** LIBRARY OPTIONS **********************/
+
+typedef struct {
+  uint32_t transfers;       // Bus grants
+  uint32_t busyUs;          // Time holding the bus
+  uint32_t maxWaitUs;       // Longest wait for the bus
+  uint32_t deadlineMisses;  // Grants later than the deadline of the client, and timeouts
+  uint32_t deferrals;       // Requests held back so a reserved slot stays free
+  uint32_t slotConflicts;   // Transfers too long for any gap, granted over a reserved slot
+} SharedI2CClientStats;
+
+/**
+ * @brief Arbitration of one Wire bus between several drivers.
+ *
+ * Each driver registers as a client with a priority and a deadline (longest acceptable wait for the bus). A periodic
+ * client, such as the touch poll, also reserves a slot: the bus is kept free from SHARED_I2C_GUARD_US before its next
+ * expected poll until slotUs after it. A client of lower priority is only granted the bus if its transfer, estimated
+ * from its length (transferUs()), ends before the next slot; readChunked() and writeChunked() split the large
+ * register transfers so they fit the gaps. When the bus is released, the waiting client of highest priority goes
+ * first. The phase of a slot is learned from the requests of its client, so it follows the Ticker.
+ *
+ * The transfers are not preempted: the worst case wait of the periodic client is the transfer started just before
+ * the guard, which is why the estimates matter. tryAcquire() never blocks, and the clock and the waits of acquire()
+ * can be replaced (setClock()), so the arbitration can be simulated on the host.
+ */
+class SharedI2CBus {
+ public:
+  SharedI2CBus(TwoWire& wire = Wire);
+
+  void begin();  // Read the bus clock used by transferUs() (call after Wire.begin()/setClock(), release() reads it again)
+  int8_t addClient(const char* name, uint8_t priority, uint32_t deadlineUs = 0);
+  int8_t addPeriodicClient(const char* name, uint8_t priority, uint32_t periodUs, uint32_t slotUs, uint32_t deadlineUs = 0);
+  void setPeriod(int8_t client, uint32_t periodUs);  // e.g. after an acquisition profile changed the poll interval
+
+  bool acquire(int8_t client, uint32_t durationUs = 0);     // Wait for the bus, false after SHARED_I2C_TIMEOUT_MS
+  bool tryAcquire(int8_t client, uint32_t durationUs = 0);  // Take the bus if the arbitration allows it now
+  void cancel(int8_t client);                               // Stop waiting after a failed tryAcquire()
+  void release(int8_t client);
+
+  uint32_t transferUs(uint16_t bytes) const;  // Time to move bytes (plus address and register) at the bus clock
+  uint16_t fitBytes(int8_t client) const;     // Bytes the client can move now without touching a reserved slot
+  bool readChunked(int8_t client, uint8_t address, uint8_t reg, uint8_t* buffer, uint16_t len);
+  bool writeChunked(int8_t client, uint8_t address, uint8_t reg, const uint8_t* buffer, uint16_t len);
+  TwoWire& wire() { return *_wire; }
+
+  bool getClientStats(int8_t client, SharedI2CClientStats& stats) const;
+  uint32_t getStatsWindowUs() const { return _now() - _statsSinceUs; }  // Time covered by the statistics
+  void printStats() const;
+  void resetStats();
+
+  void setClock(unsigned long (*now)(), void (*wait)(uint32_t us) = NULL);  // Replace micros() and the waits, for a simulation
+
+ private:
+  typedef struct {
+    const char* name;
+    uint8_t priority;
+    uint32_t deadlineUs;
+    uint32_t periodUs;    // 0 for an aperiodic client
+    uint32_t slotUs;
+    uint32_t slotStartUs; // Start of the last slot, learned from the requests (the first of each poll)
+    bool slotKnown;
+    bool waiting;
+    bool deferred;        // The current request was already counted as deferred
+    uint32_t requestUs;   // Start of the current wait
+    SharedI2CClientStats stats;
+  } Client;
+
+  TwoWire* _wire;
+  uint32_t _clockHz = 100000;
+  unsigned long (*_now)() = micros;
+  void (*_wait)(uint32_t us) = sleepUs;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+  Client _clients[SHARED_I2C_MAX_CLIENTS] = {};
+  uint8_t _count = 0;
+  int8_t _owner = -1;
+  uint32_t _grantUs = 0;
+  uint32_t _statsSinceUs = 0;
+
+  bool valid(int8_t client) const { return client >= 0 && client < _count; }
+  static void sleepUs(uint32_t us);
+  uint32_t freeUntil(int8_t client, uint32_t now, uint32_t& gapUs) const;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "SliderClassifier.h"
+
+#include "SliderGestureModel.h"
+
+static int8_t saturate8(int16_t value) {
+  return value > 127 ? 127 : value < -128 ? -128 : value;
+}
+
+/**
+ * @brief Create a classifier with the model of SliderGestureModel.h.
+ */
+SliderClassifier::SliderClassifier() {
+  setModel(SLIDER_GESTURE_TREE, SLIDER_GESTURE_TREE_NODES);
+  reset();
+}
+
+/**
+ * @brief Use another model (e.g. one just trained by SliderTrainer).
+ *
+ * @param tree Nodes of the tree, the root first. The table must outlive the classifier.
+ * @param nodes Number of nodes.
+ */
+void SliderClassifier::setModel(const SliderTreeNode* tree, uint8_t nodes) {
+  _tree = tree;
+  _nodes = nodes;
+}
+
+/**
+ * @brief Forget the current contact and the history.
+ */
+void SliderClassifier::reset() {
+  memset(_window, -1, sizeof(_window));
+  memset(_features, 0, sizeof(_features));
+  _features[SLIDER_FEATURE_POSITION] = -1;
+  _windowHead = 0;
+  _active = false;
+  _gap = 0;
+}
+
+/**
+ * @brief Classify one frame.
+ *
+ * @param padMask Touched pads, bit 0 = first pad.
+ * @param deltas Delta counts of the pads (first pad first), or NULL.
+ * @return Event to emit in this frame.
+ */
+SliderGestureClass SliderClassifier::update(uint8_t padMask, const int8_t* deltas) {
+  extract(padMask, deltas);
+  SliderGestureClass decision = gate(predict(_tree, _nodes, _features));
+  commit(decision);
+  return decision;
+}
+
+/**
+ * @brief Walk the tree, at most SLIDER_CLASSIFIER_MAX_DEPTH comparisons.
+ */
+SliderGestureClass SliderClassifier::predict(const SliderTreeNode* tree, uint8_t nodes, const int8_t* features) {
+  uint8_t i = 0;
+  for (uint8_t depth = 0; depth <= SLIDER_CLASSIFIER_MAX_DEPTH && i < nodes; depth++) {
+    const SliderTreeNode& node = tree[i];
+    if (node.feature < 0) {
+      return node.left < SLIDER_CLASS_COUNT ? (SliderGestureClass)node.left : SLIDER_CLASS_NONE;
+    }
+    i = features[node.feature] <= node.threshold ? node.left : node.right;
+  }
+  return SLIDER_CLASS_NONE;  // Malformed model
+}
+
+/**
+ * @brief Update the contact state and compute the features of a frame.
+ */
+void SliderClassifier::extract(uint8_t padMask, const int8_t* deltas) {
+  padMask &= (1 << _pads) - 1;
+  int8_t position = -1;
+
+  if (padMask != 0) {
+    position = __builtin_ctz(padMask) + (31 - __builtin_clz(padMask));  // First plus last pad, in half pads
+    int8_t velocity = _active ? position - _position : 0;
+    if (!_active) {  // New contact
+      _active = true;
+      _start = position;
+      _low = position;
+      _high = position;
+      _swipeAnchor = position;
+      _age = 0;
+      _swipes = 0;
+      _fineDone = false;
+      memset(_window, -1, sizeof(_window));
+    }
+    _position = position;
+    _low = position < _low ? position : _low;
+    _high = position > _high ? position : _high;
+    _age = _age < 127 ? _age + 1 : 127;
+    _gap = 0;
+    _features[SLIDER_FEATURE_VELOCITY] = velocity;
+  } else if (_active) {
+    _gap++;
+    _features[SLIDER_FEATURE_VELOCITY] = 0;
+  }
+
+  _window[_windowHead] = position;
+  _windowHead = (_windowHead + 1) & (SLIDER_CLASSIFIER_WINDOW - 1);
+
+  if (!_active) {
+    memset(_features, 0, sizeof(_features));
+    _features[SLIDER_FEATURE_POSITION] = -1;
+    return;
+  }
+
+  int8_t oldest = _position;  // Oldest touched position of the contact in the window
+  for (uint8_t i = 0; i < SLIDER_CLASSIFIER_WINDOW; i++) {
+    int8_t p = _window[(_windowHead + i) & (SLIDER_CLASSIFIER_WINDOW - 1)];
+    if (p >= 0) {
+      oldest = p;
+      break;
+    }
+  }
+
+  int16_t strength = 0;
+  if (deltas != NULL) {
+    for (uint8_t i = 0; i < _pads; i++) {
+      strength += deltas[i] > 0 ? deltas[i] : 0;
+    }
+  }
+
+  _features[SLIDER_FEATURE_POSITION] = _position;
+  _features[SLIDER_FEATURE_START] = _start;
+  _features[SLIDER_FEATURE_START_TO_END] = (_pads - 1) * 2 - _start;
+  _features[SLIDER_FEATURE_TRAVEL] = _position - _start;
+  _features[SLIDER_FEATURE_WINDOW_TRAVEL] = _position - oldest;
+  _features[SLIDER_FEATURE_SINCE_SWIPE] = _position - _swipeAnchor;
+  _features[SLIDER_FEATURE_SPAN] = _high - _low;
+  _features[SLIDER_FEATURE_AGE] = _age;
+  _features[SLIDER_FEATURE_PADS] = __builtin_popcount(padMask);
+  _features[SLIDER_FEATURE_GAP] = _gap;
+  _features[SLIDER_FEATURE_SWIPES] = _swipes;
+  _features[SLIDER_FEATURE_STRENGTH] = saturate8(strength / 8);
+}
+
+/**
+ * @brief Drop the decisions the contact does not allow.
+ *
+ * A swipe needs a touched frame and SLIDER_CLASSIFIER_STEP of travel in its direction since the previous swipe; a
+ * swipe fine needs a released frame and no other swipe fine in the contact.
+ */
+SliderGestureClass SliderClassifier::gate(SliderGestureClass decision) const {
+  if (!_active) {
+    return SLIDER_CLASS_NONE;
+  }
+  int8_t sinceSwipe = _position - _swipeAnchor;
+  switch (decision) {
+    case SLIDER_CLASS_SWIPE_UP:
+      return _gap == 0 && sinceSwipe <= -SLIDER_CLASSIFIER_STEP ? decision : SLIDER_CLASS_NONE;
+    case SLIDER_CLASS_SWIPE_DOWN:
+      return _gap == 0 && sinceSwipe >= SLIDER_CLASSIFIER_STEP ? decision : SLIDER_CLASS_NONE;
+    case SLIDER_CLASS_SWIPE_FINE_UP:
+    case SLIDER_CLASS_SWIPE_FINE_DOWN:
+      return _gap != 0 && !_fineDone ? decision : SLIDER_CLASS_NONE;
+    default:
+      return SLIDER_CLASS_NONE;
+  }
+}
+
+/**
+ * @brief Record the event emitted in this frame and end the contact after its hold time.
+ */
+void SliderClassifier::commit(SliderGestureClass emitted) {
+  if (emitted == SLIDER_CLASS_SWIPE_UP || emitted == SLIDER_CLASS_SWIPE_DOWN) {
+    _swipeAnchor = _position;
+    _swipes = _swipes < 127 ? _swipes + 1 : 127;
+  } else if (emitted == SLIDER_CLASS_SWIPE_FINE_UP || emitted == SLIDER_CLASS_SWIPE_FINE_DOWN) {
+    _fineDone = true;
+  }
+  if (_active && _gap >= SLIDER_CLASSIFIER_HOLD) {
+    _active = false;
+  }
+}
@@ -0,0 +1,123 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERCLASSIFIER_H
+#define SLIDERCLASSIFIER_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_CLASSIFIER_WINDOW 8         // Frames of position history (power of two)
+#define SLIDER_CLASSIFIER_MAX_DEPTH 10     // Longest path of a tree, bounds the inference time
+#define SLIDER_CLASSIFIER_MAX_NODES 255    // Nodes of a tree (8-bit child indices)
+#define SLIDER_CLASSIFIER_HOLD 2           // Frames without touch before a contact ends (release decisions happen here)
+#define SLIDER_CLASSIFIER_STEP 1           // Travel between two swipes of a contact, half pads (as the raw detector)
+
+/*********************** LIBRARY OPTIONS **********************/
+
+// Decisions of the classifier, one per frame
+enum SliderGestureClass : uint8_t {
+  SLIDER_CLASS_NONE,
+  SLIDER_CLASS_SWIPE_UP,
+  SLIDER_CLASS_SWIPE_DOWN,
+  SLIDER_CLASS_SWIPE_FINE_UP,
+  SLIDER_CLASS_SWIPE_FINE_DOWN,
+  SLIDER_CLASS_COUNT
+};
+
+// Features of a frame, int8 (positions in half pads: 0 is the first pad, 2 the second...)
+enum SliderGestureFeature : uint8_t {
+  SLIDER_FEATURE_POSITION,        // Center of the contact, -1 without contact
+  SLIDER_FEATURE_START,           // Center at the start of the contact
+  SLIDER_FEATURE_START_TO_END,    // Distance from the start to the last pad
+  SLIDER_FEATURE_TRAVEL,          // Position minus start
+  SLIDER_FEATURE_VELOCITY,        // Position change since the previous touched frame
+  SLIDER_FEATURE_WINDOW_TRAVEL,   // Position change over the window
+  SLIDER_FEATURE_SINCE_SWIPE,     // Position change since the last swipe of the contact
+  SLIDER_FEATURE_SPAN,            // Highest minus lowest position of the contact
+  SLIDER_FEATURE_AGE,             // Touched frames of the contact (saturated)
+  SLIDER_FEATURE_PADS,            // Pads touched now
+  SLIDER_FEATURE_GAP,             // Frames since the last touch of the contact (0 while touched)
+  SLIDER_FEATURE_SWIPES,          // Swipes already emitted by the contact (saturated)
+  SLIDER_FEATURE_STRENGTH,        // Sum of the positive delta counts / 8 (0 without deltas)
+  SLIDER_FEATURE_COUNT
+};
+
+typedef struct {
+  int8_t feature;    // SliderGestureFeature, -1 for a leaf
+  int8_t threshold;  // Go to the left child if feature <= threshold
+  uint8_t left;      // Index of the left child, or the SliderGestureClass of a leaf
+  uint8_t right;     // Index of the right child
+} SliderTreeNode;
+
+/*
+ * Compile-time checks of a model: every child comes after its parent (so a walk always ends) and no path is longer than
+ * SLIDER_CLASSIFIER_MAX_DEPTH. Use them in static_asserts next to the tables.
+ */
+constexpr bool sliderTreeValid(const SliderTreeNode* tree, uint8_t nodes, uint8_t i = 0) {
+  return i >= nodes ? true
+         : tree[i].feature < 0 ? tree[i].left < SLIDER_CLASS_COUNT && sliderTreeValid(tree, nodes, i + 1)
+         : tree[i].feature < SLIDER_FEATURE_COUNT && tree[i].left > i && tree[i].right > i && tree[i].left < nodes &&
+               tree[i].right < nodes && sliderTreeValid(tree, nodes, i + 1);
+}
+
+constexpr uint8_t sliderTreeDepth(const SliderTreeNode* tree, uint8_t i = 0) {
+  return tree[i].feature < 0 ? 0
+         : 1 + (sliderTreeDepth(tree, tree[i].left) > sliderTreeDepth(tree, tree[i].right) ? sliderTreeDepth(tree, tree[i].left)
+                                                                                           : sliderTreeDepth(tree, tree[i].right));
+}
+
+/**
+ * @brief Gesture classifier: features of a sliding window of frames, classified by a decision tree.
+ *
+ * Each frame is turned into SLIDER_FEATURE_COUNT int8 features describing the current contact, then a decision tree
+ * (SliderGestureModel.h, generated by SliderTrainer) tells which event to emit in this frame. The walk is bounded by
+ * SLIDER_CLASSIFIER_MAX_DEPTH comparisons and nothing is allocated, so it runs in the Ticker context.
+ * A swipe needs the contact to travel SLIDER_CLASSIFIER_STEP since the previous one and a swipe fine is emitted at most
+ * once per contact, whatever the model says.
+ */
+class SliderClassifier {
+ public:
+  SliderClassifier();
+
+  void setModel(const SliderTreeNode* tree, uint8_t nodes);
+  void setPads(uint8_t pads) { _pads = pads; }
+  void reset();
+
+  SliderGestureClass update(uint8_t padMask, const int8_t* deltas);
+
+  // Steps of update(), used by the trainer to replace the prediction with the label
+  void extract(uint8_t padMask, const int8_t* deltas);
+  SliderGestureClass gate(SliderGestureClass decision) const;
+  void commit(SliderGestureClass emitted);
+
+  const int8_t* features() const { return _features; }
+  static SliderGestureClass predict(const SliderTreeNode* tree, uint8_t nodes, const int8_t* features);
+
+ private:
+  const SliderTreeNode* _tree;
+  uint8_t _nodes;
+  uint8_t _pads = 8;
+
+  int8_t _features[SLIDER_FEATURE_COUNT];
+  int8_t _window[SLIDER_CLASSIFIER_WINDOW];  // Positions of the last frames, -1 without touch
+  uint8_t _windowHead;
+
+  bool _active;         // A contact is touched or in its hold time
+  int8_t _position;     // Last touched position
+  int8_t _start;
+  int8_t _low;
+  int8_t _high;
+  int8_t _swipeAnchor;  // Position of the last swipe
+  uint8_t _age;
+  uint8_t _gap;
+  uint8_t _swipes;
+  bool _fineDone;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "SliderContacts.h"
+
+/**
+ * @brief Forget every contact.
+ */
+void SliderContacts::reset() {
+  _count = 0;
+  _nextId = 0;
+  _pairFrames = 0;
+  _pairMid = 0;
+  _distanceAnchor = 0;
+  _midAnchor = 0;
+  _pinchSteps = 0;
+  _scrollSteps = 0;
+}
+
+/**
+ * @brief Segment and track one frame.
+ *
+ * @param padMask Touched pads, bit 0 = first pad.
+ * @param deltas Delta counts of the pads (first pad first), or NULL to use the pad mask only.
+ * @param pads Pads along the slider (up to 8).
+ * @return Number of contacts.
+ */
+uint8_t SliderContacts::update(uint8_t padMask, const int8_t* deltas, uint8_t pads) {
+  SliderContact contacts[SLIDER_CONTACTS_MAX];
+  uint8_t count = segment(padMask, deltas, pads, contacts);
+  track(contacts, count);
+  detectPairGestures();
+  return _count;
+}
+
+/**
+ * @brief Split the touched pads into contacts, ordered from the first pad.
+ *
+ * Extra contacts beyond SLIDER_CONTACTS_MAX are merged into the last one.
+ */
+uint8_t SliderContacts::segment(uint8_t padMask, const int8_t* deltas, uint8_t pads, SliderContact* contacts) {
+  // Strongest delta at or after each pad in the same run, for the valley test
+  int8_t peakAfter[8] = {};
+  if (deltas != NULL) {
+    int8_t peak = 0;
+    for (int8_t i = pads - 1; i >= 0; i--) {
+      peak = ((padMask >> i) & 0x01) ? max(peak, deltas[i]) : (int8_t)0;
+      peakAfter[i] = peak;
+    }
+  }
+
+  uint8_t count = 0;
+  bool open = false;
+  int8_t peakBefore = 0;
+  int32_t weightSum = 0;
+  int32_t positionSum = 0;
+
+  for (uint8_t i = 0; i <= pads; i++) {
+    bool touched = i < pads && ((padMask >> i) & 0x01);
+    bool valley = false;
+    if (touched && open && deltas != NULL && i + 1 < pads) {
+      int8_t weakestPeak = min(peakBefore, peakAfter[i + 1]);
+      valley = deltas[i] * 100 < weakestPeak * SLIDER_CONTACTS_VALLEY;
+    }
+
+    // Close the open contact at the end of a run or at a valley (the valley pad belongs to neither finger)
+    if (open && (!touched || valley)) {
+      SliderContact& c = contacts[count - 1];
+      c.position = weightSum > 0 ? positionSum / weightSum : (c.first + c.last) * (SLIDER_CONTACTS_ONE_PAD / 2);
+      open = false;
+      continue;
+    }
+    if (!touched) {
+      continue;
+    }
+
+    if (!open) {
+      if (count < SLIDER_CONTACTS_MAX) {
+        count++;
+        contacts[count - 1].first = i;
+        weightSum = 0;
+        positionSum = 0;
+      }  // Else keep extending the last contact
+      open = true;
+      peakBefore = 0;
+    }
+    SliderContact& c = contacts[count - 1];
+    c.last = i;
+    if (deltas != NULL && deltas[i] > 0) {
+      weightSum += deltas[i];
+      positionSum += (int32_t)deltas[i] * i * SLIDER_CONTACTS_ONE_PAD;
+      peakBefore = max(peakBefore, deltas[i]);
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief Give every contact the id of the nearest contact of the previous frame, or a new id.
+ */
+void SliderContacts::track(SliderContact* contacts, uint8_t count) {
+  bool matched[SLIDER_CONTACTS_MAX] = {};
+
+  for (uint8_t j = 0; j < count; j++) {
+    int8_t best = -1;
+    int16_t bestDistance = SLIDER_CONTACTS_GATE + 1;
+    for (uint8_t i = 0; i < _count; i++) {
+      int16_t distance = abs(contacts[j].position - _contacts[i].position);
+      if (!matched[i] && distance < bestDistance) {
+        best = i;
+        bestDistance = distance;
+      }
+    }
+
+    if (best >= 0) {
+      matched[best] = true;
+      contacts[j].id = _contacts[best].id;
+      contacts[j].age = _contacts[best].age < 0xFFFF ? _contacts[best].age + 1 : 0xFFFF;
+    } else {
+      contacts[j].id = _nextId++;
+      contacts[j].age = 0;
+    }
+  }
+
+  // The same pair as before keeps its gesture anchors
+  bool samePair = count == 2 && _count == 2 && contacts[0].age > 0 && contacts[1].age > 0;
+  _pairFrames = samePair ? _pairFrames + 1 : 0;
+
+  memcpy(_contacts, contacts, count * sizeof(SliderContact));
+  _count = count;
+}
+
+/**
+ * @brief Turn the motion of a pair of contacts into pinch/spread and scroll steps.
+ *
+ * The dominant motion wins: one finger moving changes the distance twice as much as the midpoint (pinch/spread), both
+ * fingers moving together change the midpoint only (scroll). The anchor of the other motion follows, so a small drift
+ * never adds up to a second gesture.
+ */
+void SliderContacts::detectPairGestures() {
+  _pinchSteps = 0;
+  _scrollSteps = 0;
+  if (_count != 2) {
+    _pairFrames = 0;
+    return;
+  }
+
+  int16_t distance = _contacts[1].position - _contacts[0].position;
+  _pairMid = (_contacts[0].position + _contacts[1].position) / 2;
+  if (_pairFrames == 0) {
+    _distanceAnchor = distance;
+    _midAnchor = _pairMid;
+    return;
+  }
+
+  int16_t spread = distance - _distanceAnchor;
+  int16_t scroll = _pairMid - _midAnchor;
+  if (abs(spread) >= SLIDER_CONTACTS_GESTURE_STEP && abs(spread) > abs(scroll)) {
+    _pinchSteps = spread / SLIDER_CONTACTS_GESTURE_STEP;
+    _distanceAnchor += _pinchSteps * SLIDER_CONTACTS_GESTURE_STEP;
+    _midAnchor = _pairMid;
+  } else if (abs(scroll) >= SLIDER_CONTACTS_GESTURE_STEP && abs(scroll) > abs(spread)) {
+    _scrollSteps = scroll / SLIDER_CONTACTS_GESTURE_STEP;
+    _midAnchor += _scrollSteps * SLIDER_CONTACTS_GESTURE_STEP;
+    _distanceAnchor = distance;
+  }
+}
@@ -0,0 +1,71 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERCONTACTS_H
+#define SLIDERCONTACTS_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_CONTACTS_MAX 4              // Contacts tracked at once (the CAP1208 reports up to 4 touches)
+#define SLIDER_CONTACTS_ONE_PAD 256        // Q8 fixed point: one pad is 256
+#define SLIDER_CONTACTS_GATE 384           // A contact moving more than 1.5 pads (Q8) between frames is a new contact
+#define SLIDER_CONTACTS_GESTURE_STEP 256   // Change of finger distance or midpoint (Q8) per two-finger event
+#define SLIDER_CONTACTS_VALLEY 50          // With deltas: a pad under this percentage of the peaks on both sides splits a run
+
+/*********************** LIBRARY OPTIONS **********************/
+
+typedef struct {
+  uint8_t id;         // Stable while the contact lasts
+  uint8_t first;      // First pad of the contact
+  uint8_t last;       // Last pad of the contact
+  int16_t position;   // Center, Q8 pads (weighted by the delta counts when they are given)
+  uint16_t age;       // Frames since the contact started
+} SliderContact;
+
+/**
+ * @brief Split the touched pads into separate contacts and track them across frames.
+ *
+ * A contact is a run of adjacent touched pads; with the delta counts, a run is also split at a clear valley between two
+ * peaks (two fingers on neighbouring pads). Contacts are matched to the previous frame by position to keep their id.
+ * With exactly two contacts, the change of their distance gives pinch/spread steps and the move of their midpoint
+ * gives two-finger scroll steps. Every update is O(pads) with static storage.
+ */
+class SliderContacts {
+ public:
+  SliderContacts() { reset(); }
+
+  void reset();
+  uint8_t update(uint8_t padMask, const int8_t* deltas, uint8_t pads);
+
+  uint8_t count() const { return _count; }
+  const SliderContact& contact(uint8_t index) const { return _contacts[index]; }  // Ordered from the first pad
+  bool isPair() const { return _count == 2 && _pairFrames > 0; }                   // Same two contacts as the previous frame
+
+  int8_t getPinchSteps() const { return _pinchSteps; }    // This frame: > 0 spread (apart), < 0 pinch (together)
+  int8_t getScrollSteps() const { return _scrollSteps; }  // This frame: > 0 towards the last pad, < 0 towards the first
+  int16_t getPairMidpoint() const { return _pairMid; }    // Midpoint of the pair, Q8 pads
+
+ private:
+  SliderContact _contacts[SLIDER_CONTACTS_MAX];
+  uint8_t _count;
+  uint8_t _nextId;
+
+  uint16_t _pairFrames;      // Frames with the same pair of contacts
+  int16_t _pairMid;
+  int16_t _distanceAnchor;   // Distance at the last pinch/spread step
+  int16_t _midAnchor;        // Midpoint at the last scroll step
+  int8_t _pinchSteps;
+  int8_t _scrollSteps;
+
+  uint8_t segment(uint8_t padMask, const int8_t* deltas, uint8_t pads, SliderContact* contacts);
+  void track(SliderContact* contacts, uint8_t count);
+  void detectPairGestures();
+};
+
+#endif
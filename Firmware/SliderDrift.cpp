@@ -0,0 +1,358 @@
+#include "SliderDrift.h"
+
+#include <stdio.h>
+
+static uint8_t* putVarint(uint8_t* p, uint32_t value) {
+  while (value >= 0x80) {
+    *p++ = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  *p++ = value;
+  return p;
+}
+
+static uint32_t zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+/*********************** STORAGE **********************/
+
+/**
+ * @brief Allocate the log, in PSRAM if available. The content is kept if begin() is called again.
+ *
+ * @return false if the memory could not be allocated.
+ */
+bool SliderDriftRamStorage::begin() {
+  if (_data != NULL) {
+    return true;
+  }
+  _size -= _size % SLIDER_DRIFT_SECTOR_SIZE;
+  _data = (uint8_t*)(psramFound() ? ps_malloc(_size) : malloc(_size));
+  if (_data == NULL) {
+    log_e("Cannot allocate %u bytes for the drift log", (unsigned)_size);
+    return false;
+  }
+  memset(_data, SLIDER_DRIFT_ERASED, _size);
+  return true;
+}
+
+bool SliderDriftRamStorage::erase(uint16_t sector) {
+  if (_data == NULL || sector >= sectorCount()) {
+    return false;
+  }
+  memset(&_data[(uint32_t)sector * SLIDER_DRIFT_SECTOR_SIZE], SLIDER_DRIFT_ERASED, SLIDER_DRIFT_SECTOR_SIZE);
+  return true;
+}
+
+bool SliderDriftRamStorage::write(uint32_t address, const uint8_t* data, size_t length) {
+  if (_data == NULL || address + length > _size) {
+    return false;
+  }
+  memcpy(&_data[address], data, length);
+  return true;
+}
+
+bool SliderDriftRamStorage::read(uint32_t address, uint8_t* data, size_t length) {
+  if (_data == NULL || address + length > _size) {
+    return false;
+  }
+  memcpy(data, &_data[address], length);
+  return true;
+}
+
+/**
+ * @brief Find the data partition holding the log.
+ *
+ * @return false if the partition table has no data partition with this label.
+ */
+bool SliderDriftFlashStorage::begin() {
+  _partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, _label);
+  if (_partition == NULL) {
+    log_e("Partition %s not found", _label);
+    return false;
+  }
+  return true;
+}
+
+bool SliderDriftFlashStorage::erase(uint16_t sector) {
+  return _partition != NULL &&
+         esp_partition_erase_range(_partition, (uint32_t)sector * SLIDER_DRIFT_SECTOR_SIZE, SLIDER_DRIFT_SECTOR_SIZE) == ESP_OK;
+}
+
+bool SliderDriftFlashStorage::write(uint32_t address, const uint8_t* data, size_t length) {
+  return _partition != NULL && esp_partition_write(_partition, address, data, length) == ESP_OK;
+}
+
+bool SliderDriftFlashStorage::read(uint32_t address, uint8_t* data, size_t length) {
+  return _partition != NULL && esp_partition_read(_partition, address, data, length) == ESP_OK;
+}
+
+/*********************** RECORDER **********************/
+
+/**
+ * @brief Open the log and start a new session after the data already stored.
+ *
+ * @return false if the storage is not available or too small (at least two sectors).
+ */
+bool SliderDrift::begin() {
+  _running = false;
+  if (!_storage.begin() || _storage.sectorCount() < 2) {
+    log_e("Drift log storage not available");
+    return false;
+  }
+
+  // The newest sector holds the end of the log
+  uint16_t count = _storage.sectorCount();
+  bool found = false;
+  uint16_t newest = 0;
+  uint32_t newestSequence = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    uint8_t header[SLIDER_DRIFT_HEADER_SIZE];
+    uint32_t sequence;
+    if (_storage.read((uint32_t)i * SLIDER_DRIFT_SECTOR_SIZE, header, sizeof(header)) &&
+        SliderDriftDecoder::readHeader(header, sizeof(header), sequence) &&
+        (!found || (int32_t)(sequence - newestSequence) > 0)) {
+      found = true;
+      newest = i;
+      newestSequence = sequence;
+    }
+  }
+
+  bool opened;
+  if (!found) {
+    _session = 0;
+    opened = openSector(0, 0);
+  } else {
+    uint8_t* sector = (uint8_t*)malloc(SLIDER_DRIFT_SECTOR_SIZE);
+    if (sector == NULL) {
+      log_e("Cannot allocate the sector buffer");
+      return false;
+    }
+
+    // Find the end of the data and the last session
+    SliderDriftDecoder decoder;
+    SliderDriftSample sample;
+    bool readable = _storage.read((uint32_t)newest * SLIDER_DRIFT_SECTOR_SIZE, sector, SLIDER_DRIFT_SECTOR_SIZE) &&
+                    decoder.begin(sector, SLIDER_DRIFT_SECTOR_SIZE);
+    while (readable && decoder.next(sample)) {
+    }
+    free(sector);
+
+    _session = decoder.getSession() + 1;
+    if (readable && !decoder.isCorrupt() && decoder.getOffset() + SLIDER_DRIFT_MAX_RECORD <= SLIDER_DRIFT_SECTOR_SIZE) {
+      _sector = newest;
+      _sequence = newestSequence;
+      _offset = decoder.getOffset();
+      opened = true;
+    } else {
+      opened = openSector((newest + 1) % count, newestSequence + 1);  // Never write after damaged data
+    }
+  }
+  if (!opened) {
+    log_e("Cannot open the drift log");
+    return false;
+  }
+
+  _head = 0;
+  _tail = 0;
+  _posted = false;
+  _lastPost = millis();
+  _seconds = 0;
+  _milliseconds = 0;
+  _sinceKeyframe = SLIDER_DRIFT_KEYFRAME_INTERVAL;  // The session starts with a keyframe
+  _samples = 0;
+  _bytes = 0;
+  _running = true;
+  log_i("Drift log session %lu, sector %u offset %lu", (unsigned long)_session, _sector, (unsigned long)_offset);
+  return true;
+}
+
+/**
+ * @brief Queue a sample for the log. Called from the sensing context when isDue() is true.
+ *
+ * Only copies the sample: the encoding and the storage write happen in flush(). If the queue is full the sample is
+ * dropped and counted.
+ *
+ * @param sample Sample to record, its time is set here.
+ * @param now millis().
+ */
+void SliderDrift::post(SliderDriftSample& sample, uint32_t now) {
+  uint32_t elapsed = _milliseconds + (now - _lastPost);  // Wrap-safe, the session clock outlives millis()
+  _seconds += elapsed / 1000;
+  _milliseconds = elapsed % 1000;
+  _lastPost = now;
+  _posted = true;
+  sample.time = _seconds;
+
+  uint8_t head = _head;
+  uint8_t next = (head + 1) & (SLIDER_DRIFT_QUEUE_SIZE - 1);
+  if (next == _tail) {
+    _dropped++;
+    return;
+  }
+  _queue[head] = sample;
+  __sync_synchronize();  // The slot must be written before the consumer sees the new head
+  _head = next;
+}
+
+/**
+ * @brief Encode the queued samples and append them to the storage.
+ *
+ * Call it from the application task, e.g. in loop(). It may erase a sector (tens of milliseconds on flash).
+ *
+ * @return Number of samples written.
+ */
+uint8_t SliderDrift::flush() {
+  uint8_t count = 0;
+  uint8_t tail = _tail;
+  while (_running && tail != _head) {
+    __sync_synchronize();  // Read the slot after seeing the head that published it
+    SliderDriftSample sample = _queue[tail];
+    tail = (tail + 1) & (SLIDER_DRIFT_QUEUE_SIZE - 1);
+    _tail = tail;
+
+    uint8_t buffer[SLIDER_DRIFT_MAX_RECORD];
+    SliderDriftSample recorded;
+    bool keyframe = _sinceKeyframe >= SLIDER_DRIFT_KEYFRAME_INTERVAL;
+    size_t length = encode(sample, keyframe, buffer, recorded);
+    if (_offset + length > SLIDER_DRIFT_SECTOR_SIZE) {
+      if (!openSector((_sector + 1) % _storage.sectorCount(), _sequence + 1)) {
+        log_e("Cannot open drift log sector %u", (_sector + 1) % _storage.sectorCount());
+        _running = false;
+        break;
+      }
+      keyframe = true;
+      length = encode(sample, keyframe, buffer, recorded);
+    }
+
+    if (!_storage.write((uint32_t)_sector * SLIDER_DRIFT_SECTOR_SIZE + _offset, buffer, length)) {
+      log_e("Drift log write failed");
+      _running = false;
+      break;
+    }
+    _offset += length;
+    _bytes += length;
+    _samples++;
+    _sinceKeyframe = keyframe ? 1 : _sinceKeyframe + 1;
+    _last = recorded;  // The next delta is taken against what the decoder will see
+    count++;
+  }
+  return count;
+}
+
+/**
+ * @brief Decode the whole log, oldest sample first, and print it as CSV.
+ *
+ * @param out Destination, e.g. Serial.
+ */
+void SliderDrift::printCsv(Print& out) {
+  uint8_t* sector = (uint8_t*)malloc(SLIDER_DRIFT_SECTOR_SIZE);
+  if (sector == NULL) {
+    log_e("Cannot allocate the sector buffer");
+    return;
+  }
+
+  char line[160];
+  SliderDriftDecoder::formatCsvHeader(line, sizeof(line));
+  out.println(line);
+
+  // Sectors are filled in ring order, the oldest one follows the current one
+  uint16_t count = _storage.sectorCount();
+  for (uint16_t i = 1; i <= count; i++) {
+    uint16_t index = (_sector + i) % count;
+    SliderDriftDecoder decoder;
+    SliderDriftSample sample;
+    if (!_storage.read((uint32_t)index * SLIDER_DRIFT_SECTOR_SIZE, sector, SLIDER_DRIFT_SECTOR_SIZE) ||
+        !decoder.begin(sector, SLIDER_DRIFT_SECTOR_SIZE)) {
+      continue;
+    }
+    while (decoder.next(sample)) {
+      SliderDriftDecoder::formatCsv(line, sizeof(line), decoder.getSession(), sample);
+      out.println(line);
+    }
+  }
+  free(sector);
+}
+
+/**
+ * @brief Erase a sector and write its header.
+ */
+bool SliderDrift::openSector(uint16_t sector, uint32_t sequence) {
+  uint8_t header[SLIDER_DRIFT_HEADER_SIZE] = {'S', 'D', SLIDER_DRIFT_VERSION, 0xFF, (uint8_t)sequence,
+                                              (uint8_t)(sequence >> 8), (uint8_t)(sequence >> 16),
+                                              (uint8_t)(sequence >> 24)};
+  if (!_storage.erase(sector) || !_storage.write((uint32_t)sector * SLIDER_DRIFT_SECTOR_SIZE, header, sizeof(header))) {
+    return false;
+  }
+  _sector = sector;
+  _sequence = sequence;
+  _offset = SLIDER_DRIFT_HEADER_SIZE;
+  return true;
+}
+
+/**
+ * @brief Encode a sample as a keyframe or as a delta against the previous sample.
+ *
+ * @param buffer Destination, SLIDER_DRIFT_MAX_RECORD bytes.
+ * @param recorded Filled with the sample as the decoder will rebuild it (delta counts within the deadband are kept
+ *                 at their previous value).
+ * @return Length of the record.
+ */
+size_t SliderDrift::encode(const SliderDriftSample& sample, bool keyframe, uint8_t* buffer, SliderDriftSample& recorded) {
+  uint8_t* p = buffer;
+  recorded = sample;
+
+  if (keyframe) {
+    *p++ = SLIDER_DRIFT_TAG_KEYFRAME;
+    p = putVarint(p, _session);
+    p = putVarint(p, sample.time);
+    memcpy(p, sample.base, SLIDER_DRIFT_PADS);
+    p += SLIDER_DRIFT_PADS;
+    memcpy(p, sample.delta, SLIDER_DRIFT_PADS);
+    p += SLIDER_DRIFT_PADS;
+    memcpy(p, sample.flags, SLIDER_DRIFT_FLAG_COUNT);
+    p += SLIDER_DRIFT_FLAG_COUNT;
+    return p - buffer;
+  }
+
+  uint8_t baseMask = 0;
+  uint8_t deltaMask = 0;
+  uint8_t flagMask = 0;
+  for (uint8_t i = 0; i < SLIDER_DRIFT_PADS; i++) {
+    baseMask |= (sample.base[i] != _last.base[i]) << i;
+    if (abs(sample.delta[i] - _last.delta[i]) > SLIDER_DRIFT_DELTA_DEADBAND) {
+      deltaMask |= 1 << i;
+    } else {
+      recorded.delta[i] = _last.delta[i];
+    }
+  }
+  for (uint8_t i = 0; i < SLIDER_DRIFT_FLAG_COUNT; i++) {
+    flagMask |= (sample.flags[i] != _last.flags[i]) << i;
+  }
+
+  *p++ = SLIDER_DRIFT_TAG_DELTA | (baseMask ? SLIDER_DRIFT_TAG_BASE : 0) | (deltaMask ? SLIDER_DRIFT_TAG_DELTAS : 0) |
+         (flagMask << SLIDER_DRIFT_TAG_FLAGS_SHIFT);
+  p = putVarint(p, sample.time - _last.time);
+  if (baseMask) {
+    *p++ = baseMask;
+  }
+  if (deltaMask) {
+    *p++ = deltaMask;
+  }
+  for (uint8_t i = 0; i < SLIDER_DRIFT_PADS; i++) {
+    if ((baseMask >> i) & 0x01) {
+      p = putVarint(p, zigzag((int32_t)sample.base[i] - _last.base[i]));
+    }
+  }
+  for (uint8_t i = 0; i < SLIDER_DRIFT_PADS; i++) {
+    if ((deltaMask >> i) & 0x01) {
+      p = putVarint(p, zigzag((int32_t)sample.delta[i] - _last.delta[i]));
+    }
+  }
+  for (uint8_t i = 0; i < SLIDER_DRIFT_FLAG_COUNT; i++) {
+    if ((flagMask >> i) & 0x01) {
+      *p++ = sample.flags[i];
+    }
+  }
+  return p - buffer;
+}
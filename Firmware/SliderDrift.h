@@ -0,0 +1,130 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERDRIFT_H
+#define SLIDERDRIFT_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "SliderDriftDecoder.h"  // Log format and host decoder
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_DRIFT_INTERVAL_MS 60000     // Default time between two samples
+#define SLIDER_DRIFT_KEYFRAME_INTERVAL 64  // Samples between two keyframes (a keyframe also opens every sector)
+#define SLIDER_DRIFT_QUEUE_SIZE 4          // Samples waiting for flush() (power of two)
+#define SLIDER_DRIFT_SECTOR_SIZE 4096      // Erase unit of the storage
+#define SLIDER_DRIFT_DELTA_DEADBAND 2      // Delta count changes up to this are not recorded (idle noise), 0 = lossless
+
+/*********************** LIBRARY OPTIONS **********************/
+
+/**
+ * @brief Erasable storage of the drift log, split in sectors of SLIDER_DRIFT_SECTOR_SIZE bytes.
+ */
+class SliderDriftStorage {
+ public:
+  virtual ~SliderDriftStorage() {}
+
+  virtual bool begin() = 0;
+  virtual uint16_t sectorCount() const = 0;
+  virtual bool erase(uint16_t sector) = 0;                                  // Set the whole sector to 0xFF
+  virtual bool write(uint32_t address, const uint8_t* data, size_t length) = 0;
+  virtual bool read(uint32_t address, uint8_t* data, size_t length) = 0;
+};
+
+/**
+ * @brief Drift log kept in RAM, in PSRAM when the board has it. Lost on reset.
+ */
+class SliderDriftRamStorage : public SliderDriftStorage {
+ public:
+  SliderDriftRamStorage(size_t size) : _size(size) {}
+  ~SliderDriftRamStorage() { free(_data); }
+
+  bool begin();
+  uint16_t sectorCount() const { return _size / SLIDER_DRIFT_SECTOR_SIZE; }
+  bool erase(uint16_t sector);
+  bool write(uint32_t address, const uint8_t* data, size_t length);
+  bool read(uint32_t address, uint8_t* data, size_t length);
+
+ private:
+  size_t _size;
+  uint8_t* _data = NULL;
+};
+
+/**
+ * @brief Drift log kept in a data partition of the flash. Survives resets and power cycles.
+ */
+class SliderDriftFlashStorage : public SliderDriftStorage {
+ public:
+  SliderDriftFlashStorage(const char* label) : _label(label) {}
+
+  bool begin();
+  uint16_t sectorCount() const { return _partition ? _partition->size / SLIDER_DRIFT_SECTOR_SIZE : 0; }
+  bool erase(uint16_t sector);
+  bool write(uint32_t address, const uint8_t* data, size_t length);
+  bool read(uint32_t address, uint8_t* data, size_t length);
+
+ private:
+  const char* _label;
+  const esp_partition_t* _partition = NULL;
+};
+
+/**
+ * @brief Low rate recorder of the base counts, delta counts, noise flags and calibration status.
+ *
+ * The sensing context only copies a sample into a small queue (post()); the encoding and the storage writes happen
+ * in flush(), called from the application task, so a flash erase never delays an update. Every begin() starts a new
+ * session in the log, appended after the data of the previous ones.
+ */
+class SliderDrift {
+ public:
+  SliderDrift(SliderDriftStorage& storage, uint32_t intervalMs = SLIDER_DRIFT_INTERVAL_MS)
+      : _storage(storage), _intervalMs(intervalMs) {}
+
+  bool begin();
+  void setInterval(uint32_t ms) { _intervalMs = ms; }
+  bool isDue(uint32_t now) const { return _running && (!_posted || now - _lastPost >= _intervalMs); }  // now is millis()
+  void post(SliderDriftSample& sample, uint32_t now);
+  uint8_t flush();
+
+  void printCsv(Print& out);
+
+  uint32_t getSession() const { return _session; }
+  uint32_t getSamples() const { return _samples; }  // Samples written in this session
+  uint32_t getBytes() const { return _bytes; }      // Bytes written in this session
+  uint32_t getDropped() const { return _dropped; }  // Samples lost because flush() was not called in time
+
+ private:
+  SliderDriftStorage& _storage;
+  uint32_t _intervalMs;
+  bool _running = false;
+
+  // Producer side (sensing context)
+  bool _posted = false;  // The first sample of the session has been taken
+  uint32_t _lastPost = 0;
+  uint32_t _seconds = 0;
+  uint16_t _milliseconds = 0;
+  SliderDriftSample _queue[SLIDER_DRIFT_QUEUE_SIZE];
+  volatile uint8_t _head = 0;
+  volatile uint8_t _tail = 0;
+  uint32_t _dropped = 0;
+
+  // Consumer side (flush)
+  uint32_t _session = 0;
+  uint16_t _sector = 0;
+  uint32_t _sequence = 0;
+  uint32_t _offset = 0;  // Write position in the current sector
+  uint8_t _sinceKeyframe = 0;
+  SliderDriftSample _last;
+  uint32_t _samples = 0;
+  uint32_t _bytes = 0;
+
+  bool openSector(uint16_t sector, uint32_t sequence);
+  size_t encode(const SliderDriftSample& sample, bool keyframe, uint8_t* buffer, SliderDriftSample& recorded);
+};
+
+#endif
@@ -0,0 +1,150 @@
+#include "SliderDriftDecoder.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int32_t unzigzag(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 0x01);
+}
+
+/**
+ * @brief Check the header of a sector.
+ *
+ * @param sector Start of the sector.
+ * @param size Bytes available.
+ * @param sequence Filled with the sequence number of the sector.
+ * @return false if the sector does not hold drift log data (erased, other format).
+ */
+bool SliderDriftDecoder::readHeader(const uint8_t* sector, size_t size, uint32_t& sequence) {
+  if (size < SLIDER_DRIFT_HEADER_SIZE || sector[0] != 'S' || sector[1] != 'D' || sector[2] != SLIDER_DRIFT_VERSION) {
+    return false;
+  }
+  sequence = (uint32_t)sector[4] | ((uint32_t)sector[5] << 8) | ((uint32_t)sector[6] << 16) | ((uint32_t)sector[7] << 24);
+  return true;
+}
+
+/**
+ * @brief Start decoding a sector.
+ *
+ * @param sector Start of the sector.
+ * @param size Size of the sector.
+ * @return false if the sector does not hold drift log data.
+ */
+bool SliderDriftDecoder::begin(const uint8_t* sector, size_t size) {
+  uint32_t sequence;
+  _data = NULL;
+  _corrupt = false;
+  _synced = false;
+  if (!readHeader(sector, size, sequence)) {
+    return false;
+  }
+  _data = sector;
+  _size = size;
+  _offset = SLIDER_DRIFT_HEADER_SIZE;
+  return true;
+}
+
+/**
+ * @brief Decode the next sample.
+ *
+ * @param sample Filled with the sample.
+ * @return false at the end of the data of the sector, or on an invalid record (see isCorrupt()).
+ */
+bool SliderDriftDecoder::next(SliderDriftSample& sample) {
+  if (_data == NULL || _offset >= _size || _data[_offset] == SLIDER_DRIFT_ERASED) {
+    return false;
+  }
+
+  size_t start = _offset;
+  uint8_t tag = _data[_offset++];
+  bool ok = false;
+
+  if (tag == SLIDER_DRIFT_TAG_KEYFRAME) {
+    const size_t fixed = 2 * SLIDER_DRIFT_PADS + SLIDER_DRIFT_FLAG_COUNT;
+    ok = readVarint(_session) && readVarint(sample.time) && _offset + fixed <= _size;
+    if (ok) {
+      memcpy(sample.base, &_data[_offset], SLIDER_DRIFT_PADS);
+      memcpy(sample.delta, &_data[_offset + SLIDER_DRIFT_PADS], SLIDER_DRIFT_PADS);
+      memcpy(sample.flags, &_data[_offset + 2 * SLIDER_DRIFT_PADS], SLIDER_DRIFT_FLAG_COUNT);
+      _offset += fixed;
+      _synced = true;
+    }
+  } else if ((tag & SLIDER_DRIFT_TAG_TYPE_MASK) == SLIDER_DRIFT_TAG_DELTA && _synced) {
+    uint32_t step = 0;
+    uint8_t baseMask = 0;
+    uint8_t deltaMask = 0;
+    ok = readVarint(step) && (!(tag & SLIDER_DRIFT_TAG_BASE) || readByte(baseMask)) &&
+         (!(tag & SLIDER_DRIFT_TAG_DELTAS) || readByte(deltaMask));
+
+    sample = _last;
+    sample.time += step;
+    for (uint8_t i = 0; ok && i < SLIDER_DRIFT_PADS; i++) {
+      uint32_t value;
+      if ((baseMask >> i) & 0x01) {
+        ok = readVarint(value);
+        sample.base[i] += unzigzag(value);
+      }
+    }
+    for (uint8_t i = 0; ok && i < SLIDER_DRIFT_PADS; i++) {
+      uint32_t value;
+      if ((deltaMask >> i) & 0x01) {
+        ok = readVarint(value);
+        sample.delta[i] += unzigzag(value);
+      }
+    }
+    for (uint8_t i = 0; ok && i < SLIDER_DRIFT_FLAG_COUNT; i++) {
+      if ((tag >> (SLIDER_DRIFT_TAG_FLAGS_SHIFT + i)) & 0x01) {
+        ok = readByte(sample.flags[i]);
+      }
+    }
+  }
+
+  if (!ok) {
+    _offset = start;
+    _corrupt = true;
+    return false;
+  }
+  _last = sample;
+  return true;
+}
+
+/**
+ * @brief Write the CSV column names.
+ */
+size_t SliderDriftDecoder::formatCsvHeader(char* buffer, size_t size) {
+  return snprintf(buffer, size,
+                  "session,time_s,b1,b2,b3,b4,b5,b6,b7,b8,d1,d2,d3,d4,d5,d6,d7,d8,noise,calibration,base_out,status");
+}
+
+/**
+ * @brief Write a sample as one CSV line (no line terminator).
+ */
+size_t SliderDriftDecoder::formatCsv(char* buffer, size_t size, uint32_t session, const SliderDriftSample& sample) {
+  const uint8_t* b = sample.base;
+  const int8_t* d = sample.delta;
+  const uint8_t* f = sample.flags;
+  return snprintf(buffer, size,
+                  "%lu,%lu,%u,%u,%u,%u,%u,%u,%u,%u,%d,%d,%d,%d,%d,%d,%d,%d,0x%02x,0x%02x,0x%02x,0x%02x",
+                  (unsigned long)session, (unsigned long)sample.time, b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7],
+                  d[0], d[1], d[2], d[3], d[4], d[5], d[6], d[7], f[0], f[1], f[2], f[3]);
+}
+
+bool SliderDriftDecoder::readVarint(uint32_t& value) {
+  value = 0;
+  for (uint8_t shift = 0; shift < 35 && _offset < _size; shift += 7) {
+    uint8_t byte = _data[_offset++];
+    value |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SliderDriftDecoder::readByte(uint8_t& value) {
+  if (_offset >= _size) {
+    return false;
+  }
+  value = _data[_offset++];
+  return true;
+}
@@ -0,0 +1,101 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERDRIFTDECODER_H
+#define SLIDERDRIFTDECODER_H
+
+/*
+ * Format of the drift log written by SliderDrift (SliderDrift.h) and its decoder. Nothing here depends on Arduino:
+ * host tools build this header and SliderDriftDecoder.cpp on their own (see extras/host/drift_decode.cpp).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Log layout. The storage is a ring of sectors, each sector starts with an 8 byte header:
+ *
+ *   0  2  magic ('S' 'D')
+ *   2  1  format version (SLIDER_DRIFT_VERSION)
+ *   3  1  reserved (0xFF)
+ *   4  4  sector sequence number, little endian, incremented every time a sector is opened
+ *
+ * followed by records until the first 0xFF byte (erased flash). The first byte of a record is its tag:
+ *
+ *   tag & 0x03 == 0x01  keyframe: varint session, varint time, 8 base counts, 8 delta counts, 4 flag bytes
+ *   tag & 0x03 == 0x00  delta record, against the previous sample:
+ *                         bit 2: base counts changed, a mask byte follows the time
+ *                         bit 3: delta counts changed, a mask byte follows
+ *                         bits 4-7: flag bytes changed (noise, calibration, base out of limit, status)
+ *                       varint time step, [base mask], [delta mask], one zigzag varint per changed base count,
+ *                       one zigzag varint per changed delta count, one raw byte per changed flag byte
+ *
+ * Every sector opens with a keyframe, so any sector decodes on its own when older ones have been overwritten.
+ * A sample where nothing changed beyond the delta deadband is 2 bytes: at one sample a minute an idle slider fills
+ * about 4 KB a day, a 512 KB partition keeps about four months.
+ */
+#define SLIDER_DRIFT_VERSION 1
+#define SLIDER_DRIFT_PADS 8  // Inputs per sample
+#define SLIDER_DRIFT_HEADER_SIZE 8
+#define SLIDER_DRIFT_MAX_RECORD 44  // Worst-case delta record
+
+#define SLIDER_DRIFT_TAG_TYPE_MASK 0x03
+#define SLIDER_DRIFT_TAG_DELTA 0x00     // Delta record
+#define SLIDER_DRIFT_TAG_KEYFRAME 0x01  // Keyframe record
+#define SLIDER_DRIFT_TAG_BASE 0x04      // Delta record: base counts changed
+#define SLIDER_DRIFT_TAG_DELTAS 0x08    // Delta record: delta counts changed
+#define SLIDER_DRIFT_TAG_FLAGS_SHIFT 4  // Delta record: bit per changed flag byte
+#define SLIDER_DRIFT_ERASED 0xFF        // Erased flash, end of the data of a sector
+
+// Flag bytes of a sample
+enum SliderDriftFlag : uint8_t {
+  SLIDER_DRIFT_NOISE,        // NOISE_FLAG
+  SLIDER_DRIFT_CALIBRATION,  // CAL_ACTIV
+  SLIDER_DRIFT_BASE_OUT,     // BASECOUNT (base count out of limit)
+  SLIDER_DRIFT_STATUS,       // GEN_STATUS (ACAL_FAIL, BC_OUT...)
+  SLIDER_DRIFT_FLAG_COUNT
+};
+
+typedef struct {
+  uint32_t time;                             // Seconds since the session started
+  uint8_t base[SLIDER_DRIFT_PADS];           // S1BASECOUNT to S8BASECOUNT
+  int8_t delta[SLIDER_DRIFT_PADS];           // SENS1DELTACOUNT to SENS8DELTACOUNT
+  uint8_t flags[SLIDER_DRIFT_FLAG_COUNT];    // Indexed by SliderDriftFlag
+} SliderDriftSample;
+
+/**
+ * @brief Decoder of one sector of the drift log.
+ *
+ * To rebuild the whole history, order the sectors of a storage dump by sequence number and decode them in turn.
+ */
+class SliderDriftDecoder {
+ public:
+  static bool readHeader(const uint8_t* sector, size_t size, uint32_t& sequence);
+
+  bool begin(const uint8_t* sector, size_t size);
+  bool next(SliderDriftSample& sample);
+
+  uint32_t getSession() const { return _session; }  // Session of the last sample decoded
+  size_t getOffset() const { return _offset; }      // Where decoding stopped
+  bool isCorrupt() const { return _corrupt; }       // Stopped on an invalid record instead of erased space
+
+  static size_t formatCsvHeader(char* buffer, size_t size);
+  static size_t formatCsv(char* buffer, size_t size, uint32_t session, const SliderDriftSample& sample);
+
+ private:
+  const uint8_t* _data = NULL;
+  size_t _size = 0;
+  size_t _offset = 0;
+  bool _corrupt = false;
+  bool _synced = false;  // A keyframe has been decoded
+  uint32_t _session = 0;
+  SliderDriftSample _last;
+
+  bool readVarint(uint32_t& value);
+  bool readByte(uint8_t& value);
+};
+
+#endif
@@ -0,0 +1,327 @@
+#include "SliderEffects.h"
+
+/*********************** LOOKUP TABLES **********************/
+
+// The tables are built by the compiler and stored in flash: nothing is computed at run time.
+
+namespace {
+
+template <uint16_t... I>
+struct Indices {};
+template <uint16_t N, uint16_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <uint16_t... I>
+struct MakeIndices<0, I...> {
+  typedef Indices<I...> type;
+};
+
+struct ByteTable {
+  uint8_t v[256];
+};
+struct ColorTable {
+  SliderFxColor v[256];
+};
+
+constexpr uint32_t isqrt(uint32_t x, uint32_t lo = 0, uint32_t hi = 4097) {
+  return lo + 1 >= hi ? lo : ((lo + hi) / 2) * ((lo + hi) / 2) <= x ? isqrt(x, (lo + hi) / 2, hi) : isqrt(x, lo, (lo + hi) / 2);
+}
+
+// Gamma 2.5: 255 * (x / 255)^2.5 = x^2 * sqrt(x) / (255 * sqrt(255)), with the square roots in Q8
+constexpr uint8_t gamma(uint32_t x) {
+  return (x * x * isqrt(x << 16) + 255 * isqrt(255 << 16) / 2) / (255 * isqrt(255 << 16));
+}
+
+// CIE 1931 lightness to luminance, both 0 to 255: equal steps of the input look like equal steps of brightness
+constexpr uint64_t cube(uint64_t x) { return x * x * x; }
+constexpr uint8_t lightness(uint32_t x) {
+  return x <= 20 ? (x * 2000 + 9033) / 18066  // L* <= 8: linear segment, Y = L* / 903.3
+                 : (255 * cube(x * 100 + 16 * 255) + cube(116 * 255) / 2) / cube(116 * 255);
+}
+
+// Full saturation and value hue wheel in six linear segments, hue 0 to 255
+constexpr uint8_t hueFraction(uint32_t h) { return (h * 6) & 0xFF; }
+constexpr uint8_t hueRed(uint32_t h) {
+  return (h * 6 >> 8) == 0 || (h * 6 >> 8) == 5 ? 255 : (h * 6 >> 8) == 1 ? 255 - hueFraction(h) : (h * 6 >> 8) == 4 ? hueFraction(h) : 0;
+}
+constexpr uint8_t hueGreen(uint32_t h) {
+  return (h * 6 >> 8) == 1 || (h * 6 >> 8) == 2 ? 255 : (h * 6 >> 8) == 0 ? hueFraction(h) : (h * 6 >> 8) == 3 ? 255 - hueFraction(h) : 0;
+}
+constexpr uint8_t hueBlue(uint32_t h) {
+  return (h * 6 >> 8) == 3 || (h * 6 >> 8) == 4 ? 255 : (h * 6 >> 8) == 2 ? hueFraction(h) : (h * 6 >> 8) == 5 ? 255 - hueFraction(h) : 0;
+}
+
+template <uint16_t... I>
+constexpr ByteTable makeGamma(Indices<I...>) {
+  return {{gamma(I)...}};
+}
+template <uint16_t... I>
+constexpr ByteTable makeLightness(Indices<I...>) {
+  return {{lightness(I)...}};
+}
+template <uint16_t... I>
+constexpr ColorTable makeHue(Indices<I...>) {
+  return {{{hueRed(I), hueGreen(I), hueBlue(I)}...}};
+}
+
+constexpr ByteTable GAMMA = makeGamma(MakeIndices<256>::type());
+constexpr ByteTable LIGHTNESS = makeLightness(MakeIndices<256>::type());
+constexpr ColorTable HUE = makeHue(MakeIndices<256>::type());
+
+static_assert(GAMMA.v[0] == 0 && GAMMA.v[255] == 255 && GAMMA.v[128] == 46, "Gamma table");
+static_assert(LIGHTNESS.v[0] == 0 && LIGHTNESS.v[20] == 2 && LIGHTNESS.v[128] == 47 && LIGHTNESS.v[255] == 255,
+              "Lightness table");
+static_assert(HUE.v[0].r == 255 && HUE.v[0].g == 0 && HUE.v[85].g > 250 && HUE.v[171].b > 250, "Hue table");
+
+// Fixed-point helpers, Q8 (256 = 1.0)
+inline uint8_t scale8(uint8_t value, uint16_t scale) {
+  return (value * scale) >> 8;
+}
+
+inline uint8_t add8(uint8_t a, uint8_t b) {
+  uint16_t sum = a + b;
+  return sum > 255 ? 255 : sum;
+}
+
+inline SliderFxColor blend(SliderFxColor a, SliderFxColor b, uint16_t alpha) {
+  SliderFxColor c = {(uint8_t)(a.r + (((b.r - a.r) * (int16_t)alpha) >> 8)), (uint8_t)(a.g + (((b.g - a.g) * (int16_t)alpha) >> 8)),
+                     (uint8_t)(a.b + (((b.b - a.b) * (int16_t)alpha) >> 8))};
+  return c;
+}
+
+}  // namespace
+
+/*********************** ENGINE **********************/
+
+/**
+ * @brief Create the effect engine.
+ *
+ * @param pixels LEDs along the slider (up to SLIDER_FX_MAX_PIXELS), the first LED is next to the first pad.
+ * @param pads Pads along the slider.
+ */
+SliderEffects::SliderEffects(uint8_t pixels, uint8_t pads) {
+  _pixels = pixels > SLIDER_FX_MAX_PIXELS ? SLIDER_FX_MAX_PIXELS : pixels;
+  _pads = pads > 0 ? pads : 1;
+  dirtyAll();
+}
+
+void SliderEffects::setEffects(uint8_t effects) {
+  _effects = effects;
+  dirtyAll();
+}
+
+void SliderEffects::setColor(SliderFxColor color) {
+  _color = color;
+  dirtyAll();
+}
+
+void SliderEffects::setBarColor(SliderFxColor color) {
+  _barColor = color;
+  dirtyAll();
+}
+
+void SliderEffects::setBrightness(uint8_t brightness) {
+  _brightness = brightness;
+  dirtyAll();
+}
+
+/**
+ * @brief Set the brightness on a perceptual scale: 128 looks half as bright as 255 (about 19% of the light).
+ *
+ * @param lightness 0 (off) to 255 (full), mapped through the lightness table to the linear brightness.
+ */
+void SliderEffects::setLightness(uint8_t lightness) {
+  setBrightness(LIGHTNESS.v[lightness]);
+}
+
+void SliderEffects::setHueShift(uint8_t shift) {
+  if (shift != _hueShift) {
+    _hueShift = shift;
+    dirtyAll();
+  }
+}
+
+/**
+ * @brief Update the touched pads. Only the pixels of the pads that changed are recomputed.
+ *
+ * @param padMask Touched pads, bit 0 = first pad.
+ */
+void SliderEffects::setTouch(uint8_t padMask) {
+  uint8_t changed = padMask ^ _padMask;
+  if (changed == 0) {
+    return;
+  }
+
+  uint8_t pressed = padMask & ~_padMask;
+  _padMask = padMask;
+  _touched = pixelsOf(padMask);
+  _dirty |= pixelsOf(changed);
+
+  if (pressed != 0 && (_effects & SLIDER_FX_RIPPLE)) {
+    // The ring starts at the center of the new press
+    uint8_t first = __builtin_ctz(pressed);
+    uint8_t last = 31 - __builtin_clz(pressed);
+    uint16_t span = _pads > 1 ? _pads - 1 : 1;
+    _dirty |= ripplePixels();  // Clear the previous ring
+    _rippleCenter = (uint32_t)(first + last) * (_pixels - 1) * 128 / span;
+    _rippleRadius = 0;
+    _rippleIntensity = 255;
+  }
+}
+
+/**
+ * @brief Update the bar length. Only the pixels between the old and the new end are recomputed.
+ *
+ * @param level 0 (off) to 255 (every pixel lit).
+ */
+void SliderEffects::setLevel(uint8_t level) {
+  uint16_t levelQ8 = (uint16_t)((uint32_t)level * _pixels * 256 / 255);
+  if (levelQ8 == _levelQ8) {
+    return;
+  }
+
+  uint16_t low = (levelQ8 < _levelQ8 ? levelQ8 : _levelQ8) >> 8;
+  uint16_t high = ((levelQ8 > _levelQ8 ? levelQ8 : _levelQ8) + 255) >> 8;
+  for (uint16_t i = low; i < high && i < _pixels; i++) {
+    _dirty |= 1UL << i;
+  }
+  _levelQ8 = levelQ8;
+}
+
+/**
+ * @brief Compute one frame.
+ *
+ * Advances the animations (trail, ripple) and recomputes the dirty pixels. Call it at the frame rate of the strip,
+ * show() does it and sends the result.
+ *
+ * @return Mask of the pixels whose color changed.
+ */
+uint32_t SliderEffects::render() {
+  uint32_t start = ESP.getCycleCount();
+
+  // Touch and trail intensity
+  uint32_t animated = 0;
+  for (uint32_t pixels = _dirty | _animated; pixels != 0; pixels &= pixels - 1) {
+    uint8_t i = __builtin_ctz(pixels);
+    if ((_touched >> i) & 0x01) {
+      _intensity[i] = 255;
+    } else if (_effects & SLIDER_FX_TRAIL) {
+      _intensity[i] = scale8(_intensity[i], _trailDecay);
+    } else {
+      _intensity[i] = 0;
+    }
+    if (_intensity[i] != 0 && !((_touched >> i) & 0x01)) {
+      animated |= 1UL << i;
+    }
+  }
+  _dirty |= _animated;  // The pixels that faded this frame
+  _animated = animated;
+
+  // Ripple, the pixels it leaves and the ones it reaches
+  if (_rippleIntensity != 0) {
+    _dirty |= ripplePixels();
+    _rippleRadius += SLIDER_FX_RIPPLE_SPEED;
+    _rippleIntensity = _rippleIntensity > SLIDER_FX_RIPPLE_FADE ? _rippleIntensity - SLIDER_FX_RIPPLE_FADE : 0;
+    _dirty |= ripplePixels();
+  }
+
+  uint32_t changed = 0;
+  for (uint32_t pixels = _dirty; pixels != 0; pixels &= pixels - 1) {
+    uint8_t i = __builtin_ctz(pixels);
+    uint32_t color = compose(i);
+    if (color != _out[i]) {
+      _out[i] = color;
+      changed |= 1UL << i;
+    }
+  }
+  _dirty = 0;
+
+  _frameCycles = ESP.getCycleCount() - start;
+  if (_frameCycles > _maxFrameCycles) {
+    _maxFrameCycles = _frameCycles;
+  }
+  return changed;
+}
+
+/**
+ * @brief Pad under a pixel.
+ */
+uint8_t SliderEffects::padOf(uint8_t pixel) const {
+  if (_pixels < 2) {
+    return 0;
+  }
+  return ((uint16_t)pixel * (_pads - 1) * 2 + (_pixels - 1)) / (2 * (_pixels - 1));
+}
+
+/**
+ * @brief Pixels over a set of pads.
+ */
+uint32_t SliderEffects::pixelsOf(uint8_t padMask) const {
+  uint32_t pixels = 0;
+  for (uint8_t i = 0; i < _pixels; i++) {
+    if ((padMask >> padOf(i)) & 0x01) {
+      pixels |= 1UL << i;
+    }
+  }
+  return pixels;
+}
+
+/**
+ * @brief Pixels lit by the ripple ring (one pixel either side of the radius).
+ */
+uint32_t SliderEffects::ripplePixels() const {
+  if (_rippleIntensity == 0) {
+    return 0;
+  }
+  uint32_t pixels = 0;
+  int16_t sides[2] = {(int16_t)(_rippleCenter - _rippleRadius), (int16_t)(_rippleCenter + _rippleRadius)};
+  for (uint8_t s = 0; s < 2; s++) {
+    int16_t pixel = sides[s] >> 8;  // Floor, the ring covers this pixel and the next one
+    for (int16_t i = pixel; i <= pixel + 1; i++) {
+      if (i >= 0 && i < _pixels) {
+        pixels |= 1UL << i;
+      }
+    }
+  }
+  return pixels;
+}
+
+/**
+ * @brief Compose the color of a pixel from the effects, then apply the gamma and the brightness.
+ *
+ * @return Packed color, 0x00RRGGBB.
+ */
+uint32_t SliderEffects::compose(uint8_t pixel) const {
+  SliderFxColor black = {0, 0, 0};
+  SliderFxColor palette = _color;
+  if (_effects & SLIDER_FX_RAINBOW) {
+    palette = HUE.v[(uint8_t)(pixel * 256 / _pixels + _hueShift)];
+  }
+
+  SliderFxColor c = black;
+  if (_effects & SLIDER_FX_BAR) {
+    int32_t cover = (int32_t)_levelQ8 - pixel * 256;  // Part of this pixel under the bar, Q8
+    if (cover > 0) {
+      c = blend(black, _barColor, cover > 256 ? 256 : cover);
+    }
+  }
+
+  // Touch and trail over the bar
+  if (_intensity[pixel] != 0) {
+    c = blend(c, palette, _intensity[pixel] + 1);
+  }
+
+  // Ripple: triangle profile one pixel wide either side of the ring, added to the rest
+  if (_rippleIntensity != 0) {
+    int32_t distance = abs(abs(pixel * 256 - (int32_t)_rippleCenter) - (int32_t)_rippleRadius);
+    if (distance < 256) {
+      uint8_t weight = scale8(_rippleIntensity, 256 - distance);
+      c.r = add8(c.r, scale8(palette.r, weight + 1));
+      c.g = add8(c.g, scale8(palette.g, weight + 1));
+      c.b = add8(c.b, scale8(palette.b, weight + 1));
+    }
+  }
+
+  uint16_t brightness = _brightness + 1;
+  return ((uint32_t)scale8(GAMMA.v[c.r], brightness) << 16) | ((uint32_t)scale8(GAMMA.v[c.g], brightness) << 8) |
+         scale8(GAMMA.v[c.b], brightness);
+}
@@ -0,0 +1,117 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDEREFFECTS_H
+#define SLIDEREFFECTS_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_FX_MAX_PIXELS 32       // Size of the pixel buffers (one bit per pixel in the dirty masks)
+#define SLIDER_FX_TRAIL_DECAY 200     // Trail intensity kept per frame after a release, Q8
+#define SLIDER_FX_RIPPLE_SPEED 96     // Ripple growth per frame, Q8 pixels
+#define SLIDER_FX_RIPPLE_FADE 12      // Ripple intensity lost per frame
+
+/*********************** LIBRARY OPTIONS **********************/
+
+// Effects, combine them with |
+enum SliderEffect : uint8_t {
+  SLIDER_FX_BAR = 0x01,      // Level bar from the first pixel, with an anti-aliased end (setLevel())
+  SLIDER_FX_RAINBOW = 0x02,  // Touched pixels, trail and ripple take the hue of their position instead of the color
+  SLIDER_FX_TRAIL = 0x04,    // Touched pixels fade out after the release instead of switching off
+  SLIDER_FX_RIPPLE = 0x08,   // A ring expands from every new press
+};
+
+typedef struct {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+} SliderFxColor;
+
+/**
+ * @brief LED effects driven by the slider state, for a strip laid along the pads.
+ *
+ * Colors are composed in 8-bit linear RGB with fixed-point blending, then corrected with a gamma table generated at
+ * compile time (as are the hue wheel and the lightness table of setLightness()). Only the pixels whose inputs
+ * changed, or that are animated, are recomputed on each frame, and only the pixels whose output changed are sent to
+ * the strip.
+ */
+class SliderEffects {
+ public:
+  SliderEffects(uint8_t pixels, uint8_t pads = 8);
+
+  void setEffects(uint8_t effects);
+  void setColor(SliderFxColor color);             // Color of the touch, trail and ripple (without rainbow)
+  void setBarColor(SliderFxColor color);
+  void setBrightness(uint8_t brightness);         // Linear scale applied after the gamma correction
+  void setLightness(uint8_t lightness);           // The same on a perceptual scale (CIE lightness table)
+  void setHueShift(uint8_t shift);                // Rotate the rainbow
+  void setTrailDecay(uint8_t decay) { _trailDecay = decay; }  // Intensity kept per frame, Q8
+
+  void setTouch(uint8_t padMask);                 // Touched pads, bit 0 = first pad (TouchSlider::getPadMask())
+  void setLevel(uint8_t level);                   // Bar length, 0 to 255 (e.g. from SliderValue)
+
+  uint32_t render();                              // Compute one frame, returns the mask of pixels that changed
+  uint32_t getPixel(uint8_t i) const { return _out[i]; }  // Gamma corrected, packed as 0x00RRGGBB
+  bool isAnimating() const { return _animated != 0 || _rippleIntensity != 0; }
+
+  uint32_t getFrameCycles() const { return _frameCycles; }  // Duration of the last render()
+  uint32_t getMaxFrameCycles() const { return _maxFrameCycles; }
+
+  /**
+   * @brief Render a frame and send the changed pixels to a strip (e.g. Adafruit_NeoPixel).
+   *
+   * @return true if the strip was updated.
+   */
+  template <class Strip>
+  bool show(Strip& strip) {
+    uint32_t changed = render();
+    if (changed == 0) {
+      return false;
+    }
+    for (; changed != 0; changed &= changed - 1) {
+      uint8_t i = __builtin_ctz(changed);
+      strip.setPixelColor(i, _out[i]);
+    }
+    strip.show();
+    return true;
+  }
+
+ private:
+  uint8_t _pixels;
+  uint8_t _pads;
+  uint8_t _effects = SLIDER_FX_RAINBOW;
+  SliderFxColor _color = {0, 0, 255};
+  SliderFxColor _barColor = {0, 255, 0};
+  uint8_t _brightness = 255;
+  uint8_t _hueShift = 0;
+  uint8_t _trailDecay = SLIDER_FX_TRAIL_DECAY;
+
+  uint8_t _padMask = 0;
+  uint32_t _touched = 0;    // Pixels over a touched pad
+  uint16_t _levelQ8 = 0;    // Bar length in Q8 pixels
+  uint8_t _intensity[SLIDER_FX_MAX_PIXELS] = {};  // Touch and trail intensity
+  uint32_t _animated = 0;   // Pixels with a fading trail
+  uint32_t _dirty = 0;      // Pixels to recompute on the next frame
+
+  uint16_t _rippleCenter = 0;   // Q8 pixels
+  uint16_t _rippleRadius = 0;   // Q8 pixels
+  uint8_t _rippleIntensity = 0;
+
+  uint32_t _out[SLIDER_FX_MAX_PIXELS] = {};
+  uint32_t _frameCycles = 0;
+  uint32_t _maxFrameCycles = 0;
+
+  uint8_t padOf(uint8_t pixel) const;
+  uint32_t pixelsOf(uint8_t padMask) const;
+  uint32_t ripplePixels() const;
+  uint32_t compose(uint8_t pixel) const;
+  void dirtyAll() { _dirty = _pixels >= 32 ? 0xFFFFFFFF : (1UL << _pixels) - 1; }
+};
+
+#endif
@@ -0,0 +1,167 @@
+#include "SliderEvents.h"
+
+/**
+ * @brief Register a handler for an event type.
+ *
+ * @param type Event type to listen to.
+ * @param handler Function called for every matching event.
+ * @param context Pointer passed back to the handler.
+ * @param padMask Only events on these pads are delivered (bit 0 = first pad), SLIDER_EVENTS_ALL_PADS for all.
+ * @return The subscription id, -1 if the table is full.
+ */
+int8_t SliderEvents::subscribe(TouchSliderEventType type, TouchSliderHandler handler, void* context, uint8_t padMask) {
+  if (handler == NULL || type >= SLIDER_EVENT_COUNT) {
+    return -1;
+  }
+
+  for (uint8_t i = 0; i < SLIDER_EVENTS_MAX_HANDLERS; i++) {
+    Subscription& s = _handlers[i];
+    if (s.handler == NULL) {
+      memset(&s.stats, 0, sizeof(s.stats));
+      s.context = context;
+      s.type = type;
+      s.padMask = padMask;
+      s.handler = handler;  // Written last, the slot becomes visible to dispatch() here
+      updateSubscribedTypes();
+      return i;
+    }
+  }
+
+  log_e("Handler table full (%d entries)", SLIDER_EVENTS_MAX_HANDLERS);
+  return -1;
+}
+
+/**
+ * @brief Remove a handler.
+ *
+ * @param id Subscription id returned by subscribe().
+ */
+void SliderEvents::unsubscribe(int8_t id) {
+  if (id < 0 || id >= SLIDER_EVENTS_MAX_HANDLERS) {
+    return;
+  }
+  _handlers[id].handler = NULL;
+  updateSubscribedTypes();
+}
+
+/**
+ * @brief Deliver an event, now (inline mode) or through the queue (deferred mode).
+ *
+ * Called from the sensing context. In deferred mode the event is dropped, and counted, if the queue is full.
+ *
+ * @param event The event to deliver.
+ */
+void SliderEvents::post(const TouchSliderEvent& event) {
+  if (!isSubscribed((TouchSliderEventType)event.type)) {
+    return;
+  }
+
+  if (_mode == SLIDER_DISPATCH_INLINE) {
+    dispatch(event);
+    return;
+  }
+
+  uint8_t head = _head;
+  uint8_t next = (head + 1) & (SLIDER_EVENTS_QUEUE_SIZE - 1);
+  if (next == _tail) {
+    _dropped++;
+    return;
+  }
+  _queue[head] = event;
+  __sync_synchronize();  // The slot must be written before the consumer sees the new head
+  _head = next;
+}
+
+/**
+ * @brief Run the handlers of the queued events (deferred mode).
+ *
+ * Call it from the application task, e.g. at the start of loop().
+ *
+ * @return Number of events dispatched.
+ */
+uint8_t SliderEvents::dispatchPending() {
+  uint8_t count = 0;
+  uint8_t tail = _tail;
+  while (tail != _head) {
+    __sync_synchronize();  // Read the slot after seeing the head that published it
+    TouchSliderEvent event = _queue[tail];
+    tail = (tail + 1) & (SLIDER_EVENTS_QUEUE_SIZE - 1);
+    _tail = tail;
+    dispatch(event);
+    count++;
+  }
+  return count;
+}
+
+/**
+ * @brief Get the timing of a handler.
+ *
+ * @param id Subscription id returned by subscribe().
+ * @param stats Structure to fill.
+ * @return false if the id is not subscribed.
+ */
+bool SliderEvents::getHandlerStats(int8_t id, TouchSliderHandlerStats& stats) const {
+  if (id < 0 || id >= SLIDER_EVENTS_MAX_HANDLERS || _handlers[id].handler == NULL) {
+    return false;
+  }
+  stats = _handlers[id].stats;
+  return true;
+}
+
+/**
+ * @brief Print one line per handler with its calls, worst-case time and budget overruns.
+ */
+void SliderEvents::printStats() const {
+  for (uint8_t i = 0; i < SLIDER_EVENTS_MAX_HANDLERS; i++) {
+    const Subscription& s = _handlers[i];
+    if (s.handler == NULL) {
+      continue;
+    }
+    log_i("handler %u type=%u pads=0x%02x calls=%lu max=%.1fus overruns=%lu", i, s.type, s.padMask,
+          (unsigned long)s.stats.calls, s.stats.maxCycles / (float)ESP.getCpuFreqMHz(), (unsigned long)s.stats.overruns);
+  }
+  log_i("dispatch %s, dropped=%lu", _mode == SLIDER_DISPATCH_INLINE ? "inline" : "deferred", (unsigned long)_dropped);
+}
+
+/**
+ * @brief Call every handler matching the event and time it.
+ */
+void SliderEvents::dispatch(const TouchSliderEvent& event) {
+  for (uint8_t i = 0; i < SLIDER_EVENTS_MAX_HANDLERS; i++) {
+    Subscription& s = _handlers[i];
+    TouchSliderHandler handler = s.handler;
+    if (handler == NULL || s.type != event.type || (event.pad < 8 && !((s.padMask >> event.pad) & 0x01))) {
+      continue;
+    }
+
+    uint32_t start = ESP.getCycleCount();
+    handler(event, s.context);
+    uint32_t cycles = ESP.getCycleCount() - start;
+
+    s.stats.calls++;
+    if (cycles > s.stats.maxCycles) {
+      s.stats.maxCycles = cycles;
+    }
+    if (_budgetCycles == 0 && _budgetUs != 0) {
+      _budgetCycles = _budgetUs * ESP.getCpuFreqMHz();
+    }
+    if (_budgetCycles != 0 && cycles > _budgetCycles) {
+      if (s.stats.overruns++ == 0) {
+        log_w("Handler %u took %lu cycles, budget is %lu", i, (unsigned long)cycles, (unsigned long)_budgetCycles);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Rebuild the bit mask of subscribed event types.
+ */
+void SliderEvents::updateSubscribedTypes() {
+  uint16_t types = 0;
+  for (uint8_t i = 0; i < SLIDER_EVENTS_MAX_HANDLERS; i++) {
+    if (_handlers[i].handler != NULL) {
+      types |= 1 << _handlers[i].type;
+    }
+  }
+  _subscribedTypes = types;
+}
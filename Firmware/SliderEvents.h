@@ -0,0 +1,107 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDEREVENTS_H
+#define SLIDEREVENTS_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_EVENTS_MAX_HANDLERS 8       // Size of the static handler table
+#define SLIDER_EVENTS_QUEUE_SIZE 16        // Events buffered in deferred mode (power of two)
+#define SLIDER_EVENTS_ALL_PADS 0xFF        // Pad mask that matches every pad
+#define SLIDER_EVENTS_BUDGET_US 1000       // Handlers running longer than this are reported (0 = no budget)
+
+/*********************** LIBRARY OPTIONS **********************/
+
+// Events produced by the gesture analysis
+enum TouchSliderEventType : uint8_t {
+  SLIDER_EVENT_SWIPE_UP,
+  SLIDER_EVENT_SWIPE_DOWN,
+  SLIDER_EVENT_SWIPE_FINE_UP,
+  SLIDER_EVENT_SWIPE_FINE_DOWN,
+  SLIDER_EVENT_PRESS,    // A pad started being touched
+  SLIDER_EVENT_RELEASE,  // A pad stopped being touched
+  SLIDER_EVENT_PINCH,        // Two contacts moved one step closer (multi-touch)
+  SLIDER_EVENT_SPREAD,       // Two contacts moved one step apart (multi-touch)
+  SLIDER_EVENT_SCROLL_UP,    // Two contacts moved one step together towards the first pad (multi-touch)
+  SLIDER_EVENT_SCROLL_DOWN,  // Two contacts moved one step together towards the last pad (multi-touch)
+  SLIDER_EVENT_REPEAT,       // A held pad repeated (hardware pad events, see TouchSlider::enablePadEvents())
+  SLIDER_EVENT_COUNT
+};
+
+// Where the handlers run
+enum TouchSliderDispatch : uint8_t {
+  SLIDER_DISPATCH_INLINE,    // In the sensing context (Ticker), as soon as the event is detected
+  SLIDER_DISPATCH_DEFERRED,  // In the application task, when it calls dispatchEvents()
+};
+
+typedef struct {
+  uint8_t type;        // TouchSliderEventType
+  uint8_t pad;         // Pad where the event happened (first touched pad for swipes, edge pad for swipe fine, midpoint for two contacts)
+  uint8_t padMask;     // Touched pads when the event was detected
+  uint32_t timestamp;  // millis() when the event was detected
+} TouchSliderEvent;
+
+typedef void (*TouchSliderHandler)(const TouchSliderEvent& event, void* context);
+
+typedef struct {
+  uint32_t calls;       // Times the handler ran
+  uint32_t maxCycles;   // Worst-case duration of one call
+  uint32_t overruns;    // Calls longer than the dispatch budget
+} TouchSliderHandlerStats;
+
+/**
+ * @brief Static table of event handlers with inline or deferred dispatch.
+ *
+ * No heap: handlers are plain function pointers with a context pointer. Each call is timed so the worst case of
+ * every handler can be checked against the tick budget. In deferred mode the events go through a single-producer
+ * single-consumer ring, the producer is the sensing context and the consumer the task calling dispatchPending().
+ */
+class SliderEvents {
+ public:
+  int8_t subscribe(TouchSliderEventType type, TouchSliderHandler handler, void* context, uint8_t padMask);
+  void unsubscribe(int8_t id);
+  bool isSubscribed(TouchSliderEventType type) const { return (_subscribedTypes >> type) & 0x01; }
+
+  void setMode(TouchSliderDispatch mode) { _mode = mode; }
+  TouchSliderDispatch getMode() const { return _mode; }
+  void setBudget(uint32_t us) { _budgetUs = us; _budgetCycles = 0; }  // Longest acceptable handler call (0 = no budget)
+
+  void post(const TouchSliderEvent& event);
+  uint8_t dispatchPending();
+
+  bool getHandlerStats(int8_t id, TouchSliderHandlerStats& stats) const;
+  uint32_t getDropped() const { return _dropped; }
+  void printStats() const;
+
+ private:
+  typedef struct {
+    TouchSliderHandler handler;
+    void* context;
+    uint8_t type;
+    uint8_t padMask;
+    TouchSliderHandlerStats stats;
+  } Subscription;
+
+  Subscription _handlers[SLIDER_EVENTS_MAX_HANDLERS] = {};
+  uint16_t _subscribedTypes = 0;  // Bit per event type with at least one handler
+  TouchSliderDispatch _mode = SLIDER_DISPATCH_INLINE;
+  uint32_t _budgetUs = SLIDER_EVENTS_BUDGET_US;
+  uint32_t _budgetCycles = 0;     // _budgetUs in cycles, computed on first use
+
+  TouchSliderEvent _queue[SLIDER_EVENTS_QUEUE_SIZE];
+  volatile uint8_t _head = 0;     // Written by the producer only
+  volatile uint8_t _tail = 0;     // Written by the consumer only
+  uint32_t _dropped = 0;          // Events lost because the queue was full
+
+  void dispatch(const TouchSliderEvent& event);
+  void updateSubscribedTypes();
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Gesture classifier model, generated by SliderTrainer::printModel(). Do not edit: train again.
+ * 76372 samples (6860 swipe up, 6584 swipe down, 1060 fine up, 1082 fine down), 41 nodes
+ * Trained with: gesture_train -n 2000 -d 10 -l 16 -s 7 ../traces
+ * */
+
+#ifndef SLIDERGESTUREMODEL_H
+#define SLIDERGESTUREMODEL_H
+
+#include "SliderClassifier.h"
+
+// Feature, threshold, left (or class), right
+constexpr SliderTreeNode SLIDER_GESTURE_TREE[] = {
+    {SLIDER_FEATURE_VELOCITY, -1, 1, 14},  // 0
+    {SLIDER_FEATURE_TRAVEL, -1, 2, 13},  // 1
+    {SLIDER_FEATURE_SINCE_SWIPE, -1, 3, 12},  // 2
+    {SLIDER_FEATURE_START, 1, 4, 5},  // 3
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 4
+    {SLIDER_FEATURE_TRAVEL, -2, 6, 7},  // 5
+    {-1, 0, SLIDER_CLASS_SWIPE_UP, 0},  // 6
+    {SLIDER_FEATURE_AGE, 3, 8, 9},  // 7
+    {-1, 0, SLIDER_CLASS_SWIPE_UP, 0},  // 8
+    {SLIDER_FEATURE_PADS, 1, 10, 11},  // 9
+    {-1, 0, SLIDER_CLASS_SWIPE_UP, 0},  // 10
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 11
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 12
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 13
+    {SLIDER_FEATURE_VELOCITY, 0, 15, 30},  // 14
+    {SLIDER_FEATURE_GAP, 0, 16, 17},  // 15
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 16
+    {SLIDER_FEATURE_START, 1, 18, 23},  // 17
+    {SLIDER_FEATURE_GAP, 1, 19, 22},  // 18
+    {SLIDER_FEATURE_SWIPES, 0, 20, 21},  // 19
+    {-1, 0, SLIDER_CLASS_SWIPE_FINE_DOWN, 0},  // 20
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 21
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 22
+    {SLIDER_FEATURE_POSITION, 12, 24, 25},  // 23
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 24
+    {SLIDER_FEATURE_GAP, 1, 26, 29},  // 25
+    {SLIDER_FEATURE_SWIPES, 0, 27, 28},  // 26
+    {-1, 0, SLIDER_CLASS_SWIPE_FINE_UP, 0},  // 27
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 28
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 29
+    {SLIDER_FEATURE_TRAVEL, 0, 31, 32},  // 30
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 31
+    {SLIDER_FEATURE_SINCE_SWIPE, 0, 33, 34},  // 32
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 33
+    {SLIDER_FEATURE_TRAVEL, 1, 35, 40},  // 34
+    {SLIDER_FEATURE_AGE, 3, 36, 37},  // 35
+    {-1, 0, SLIDER_CLASS_SWIPE_DOWN, 0},  // 36
+    {SLIDER_FEATURE_PADS, 1, 38, 39},  // 37
+    {-1, 0, SLIDER_CLASS_SWIPE_DOWN, 0},  // 38
+    {-1, 0, SLIDER_CLASS_NONE, 0},  // 39
+    {-1, 0, SLIDER_CLASS_SWIPE_DOWN, 0},  // 40
+};
+
+constexpr uint8_t SLIDER_GESTURE_TREE_NODES = sizeof(SLIDER_GESTURE_TREE) / sizeof(SLIDER_GESTURE_TREE[0]);
+
+static_assert(sliderTreeValid(SLIDER_GESTURE_TREE, SLIDER_GESTURE_TREE_NODES), "Malformed gesture model");
+static_assert(sliderTreeDepth(SLIDER_GESTURE_TREE) <= SLIDER_CLASSIFIER_MAX_DEPTH, "Gesture model too deep");
+
+#endif
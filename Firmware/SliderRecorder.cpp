@@ -0,0 +1,163 @@
+#include "SliderRecorder.h"
+
+#include <stdio.h>
+
+#include "TouchTrace.h"
+
+/**
+ * @brief Create the recorder, nothing is allocated before begin().
+ *
+ * @param frames Capacity of the ring, rounded down to a power of two.
+ */
+SliderRecorder::SliderRecorder(uint32_t frames) {
+  _requested = frames > 0 ? frames : 1;
+}
+
+SliderRecorder::~SliderRecorder() {
+  free(_buffer);
+}
+
+/**
+ * @brief Allocate the ring, in PSRAM if available, otherwise SLIDER_RECORDER_RAM_FRAMES frames in RAM.
+ *
+ * @return false if the allocation failed.
+ */
+bool SliderRecorder::begin() {
+  if (_buffer != NULL) {
+    return true;
+  }
+
+  uint32_t frames = psramFound() ? _requested : min(_requested, (uint32_t)SLIDER_RECORDER_RAM_FRAMES);
+  frames = 1UL << (31 - __builtin_clz(frames));  // The index is masked instead of divided
+  _buffer = (SliderRecord*)(psramFound() ? ps_malloc(frames * sizeof(SliderRecord)) : malloc(frames * sizeof(SliderRecord)));
+  if (_buffer == NULL) {
+    log_e("Flight recorder: cannot allocate %lu frames", (unsigned long)frames);
+    return false;
+  }
+
+  _indexMask = frames - 1;
+  _head = 0;
+  log_i("Flight recorder: %lu frames in %s", (unsigned long)frames, psramFound() ? "PSRAM" : "RAM");
+  return true;
+}
+
+/**
+ * @brief Freeze the recorder after a few more frames.
+ *
+ * A second trigger before resume() is ignored, so the window stays around the first problem.
+ *
+ * @param postFrames Frames recorded after this one, 0 freezes immediately.
+ */
+void SliderRecorder::trigger(uint16_t postFrames) {
+  if (_triggered || _frozen) {
+    return;
+  }
+  _triggerFrame = _head - 1;  // The newest frame
+  _postLeft = postFrames;
+  _triggered = true;
+  if (postFrames == 0) {
+    _frozen = true;
+  }
+}
+
+/**
+ * @brief Trigger the recorder when one of these events is published.
+ *
+ * @param events Bit per TouchSliderEventType, 0 to disable.
+ * @param postFrames Frames recorded after the event.
+ */
+void SliderRecorder::setTriggerEvents(uint16_t events, uint16_t postFrames) {
+  _postFrames = postFrames;
+  _triggerEvents = events;
+}
+
+/**
+ * @brief Clear the trigger and record again. The frames of the previous window are overwritten as new ones arrive.
+ */
+void SliderRecorder::resume() {
+  _triggered = false;
+  _postLeft = 0;
+  _frozen = false;
+}
+
+uint32_t SliderRecorder::getFrames() const {
+  uint32_t head = _head;
+  return _buffer == NULL ? 0 : head < getCapacity() ? head : getCapacity();
+}
+
+/**
+ * @brief Read a recorded frame.
+ *
+ * @param age 0 is the newest frame, getFrames() - 1 the oldest.
+ * @param record Frame read.
+ * @return false if the frame is not in the ring.
+ */
+bool SliderRecorder::getRecord(uint32_t age, SliderRecord& record) const {
+  if (age >= getFrames()) {
+    return false;
+  }
+  record = _buffer[(_head - 1 - age) & _indexMask];
+  return true;
+}
+
+/**
+ * @brief Freeze the recorder and print the window in the TouchTrace text format.
+ *
+ * A trace holds TOUCH_TRACE_MAX_FRAMES frames, so a longer window is split into parts of that many ticks. Each part
+ * starts with a "# TouchSlider flight recorder: part" comment and its ticks start at 0: save every part as its own
+ * .trace file. Frames with no pad touched, no event and no status flag are left out (missing ticks are empty frames)
+ * unless the delta counts were captured. The time, status and events of every frame follow as a comment, which
+ * TouchTrace::parseLine() ignores. Call resume() to record again.
+ *
+ * @param out Output, e.g. Serial.
+ * @param frames Newest frames to print, 0 for the whole ring.
+ */
+void SliderRecorder::exportTrace(Print& out, uint32_t frames) {
+  bool wasFrozen = _frozen;
+  _frozen = true;
+
+  // An update running while the recorder froze may still overwrite the oldest slot
+  uint32_t available = getFrames();
+  if (!wasFrozen && available == getCapacity()) {
+    available--;
+  }
+  if (frames == 0 || frames > available) {
+    frames = available;
+  }
+
+  char line[96];
+  uint32_t first = _head - frames;
+  uint32_t parts = (frames + TOUCH_TRACE_MAX_FRAMES - 1) / TOUCH_TRACE_MAX_FRAMES;
+  for (uint32_t part = 0; part < parts; part++) {
+    uint32_t start = first + part * TOUCH_TRACE_MAX_FRAMES;
+    uint32_t count = min(frames - part * TOUCH_TRACE_MAX_FRAMES, (uint32_t)TOUCH_TRACE_MAX_FRAMES);
+    snprintf(line, sizeof(line), "# TouchSlider flight recorder: part %lu of %lu, %lu frames%s%s",
+             (unsigned long)(part + 1), (unsigned long)parts, (unsigned long)count, _captureStatus ? ", status" : "",
+             _captureDeltas ? ", deltas" : "");
+    out.println(line);
+    if (_triggered && _triggerFrame - start < count) {
+      snprintf(line, sizeof(line), "# trigger at tick %lu", (unsigned long)(_triggerFrame - start));
+      out.println(line);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+      const SliderRecord& record = _buffer[(start + i) & _indexMask];
+      bool withDeltas = (record.status & SLIDER_RECORDER_DELTAS_VALID) != 0;
+      uint8_t status = record.status & ~SLIDER_RECORDER_DELTAS_VALID;
+      if (record.mask == 0 && record.events == 0 && status == 0 && !withDeltas && i != 0 && i != count - 1) {
+        continue;
+      }
+
+      TouchTraceFrame frame;
+      frame.tick = i;
+      frame.mask = record.mask;
+      memcpy(frame.delta, record.delta, TOUCH_TRACE_PADS);
+      size_t length = TouchTrace::formatFrame(line, sizeof(line), frame, withDeltas);
+      if (length < sizeof(line)) {
+        snprintf(line + length, sizeof(line) - length, " # t=%lu s=%02x e=%04x", (unsigned long)record.time, status,
+                 record.events);
+      }
+      out.println(line);
+    }
+  }
+}
@@ -0,0 +1,95 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERRECORDER_H
+#define SLIDERRECORDER_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_RECORDER_FRAMES 32768       // Frames kept in PSRAM (16 bytes each, 27 minutes at 20 Hz)
+#define SLIDER_RECORDER_RAM_FRAMES 512     // Frames kept when no PSRAM is found (25 seconds at 20 Hz)
+#define SLIDER_RECORDER_POST_FRAMES 40     // Frames still recorded after a trigger, so the window shows what followed
+#define SLIDER_RECORDER_DELTAS_VALID 0x80  // Flag in SliderRecord::status (a reserved bit of the General Status register)
+
+/*********************** LIBRARY OPTIONS **********************/
+
+typedef struct {
+  uint32_t time;     // millis() of the update
+  uint8_t mask;      // SENSOR_INPUTS, bit 0 = first pad
+  uint8_t status;    // General Status register (0 if not captured), SLIDER_RECORDER_DELTAS_VALID if delta is valid
+  uint16_t events;   // Bit per TouchSliderEventType published in the frame
+  int8_t delta[8];   // Delta counts, first pad first (0 if not captured)
+} SliderRecord;
+
+static_assert(sizeof(SliderRecord) == 16, "A record must stay 16 bytes");
+
+/**
+ * @brief Always-on circular recorder of the raw frames of a TouchSlider (flight recorder).
+ *
+ * Every update stores one 16-byte record in a ring in PSRAM, which costs a copy and an index increment. A trigger,
+ * called by the application or raised by an event type, lets the recorder run for a few more frames and then freezes
+ * it, so the window around the problem is kept until resume(). The window is exported in the TouchTrace text format
+ * and can be replayed through TouchSlider::processFrame() on the host or on the device.
+ */
+class SliderRecorder {
+ public:
+  SliderRecorder(uint32_t frames = SLIDER_RECORDER_FRAMES);
+  ~SliderRecorder();
+
+  bool begin();
+  void setCapture(bool status, bool deltas) { _captureStatus = status; _captureDeltas = deltas; }  // Extra I2C reads per update
+  bool capturesStatus() const { return _captureStatus; }
+  bool capturesDeltas() const { return _captureDeltas; }
+
+  /**
+   * @brief Store a frame, called by TouchSlider on every update.
+   */
+  void record(const SliderRecord& record) {
+    if (_frozen || _buffer == NULL) {
+      return;
+    }
+    _buffer[_head & _indexMask] = record;
+    _head++;
+    if ((record.events & _triggerEvents) && !_triggered) {
+      trigger(_postFrames);
+    } else if (_triggered && --_postLeft == 0) {
+      _frozen = true;
+    }
+  }
+
+  void trigger(uint16_t postFrames = SLIDER_RECORDER_POST_FRAMES);
+  void setTriggerEvents(uint16_t events, uint16_t postFrames = SLIDER_RECORDER_POST_FRAMES);  // Bit per TouchSliderEventType
+  void freeze() { _frozen = true; }
+  void resume();
+  bool isFrozen() const { return _frozen; }
+
+  uint32_t getCapacity() const { return _indexMask + 1; }
+  uint32_t getFrames() const;                   // Frames available in the ring
+  uint32_t getRecorded() const { return _head; }
+  bool getRecord(uint32_t age, SliderRecord& record) const;  // age 0 is the newest frame
+
+  void exportTrace(Print& out, uint32_t frames = 0);  // In parts of TOUCH_TRACE_MAX_FRAMES frames
+
+ private:
+  SliderRecord* _buffer = NULL;
+  uint32_t _requested;
+  uint32_t _indexMask = 0;
+  volatile uint32_t _head = 0;         // Frames recorded since begin(), the next slot is _head & _indexMask
+  volatile bool _frozen = false;
+  bool _captureStatus = false;
+  bool _captureDeltas = false;
+
+  uint16_t _triggerEvents = 0;
+  uint16_t _postFrames = SLIDER_RECORDER_POST_FRAMES;
+  volatile bool _triggered = false;
+  volatile uint16_t _postLeft = 0;
+  uint32_t _triggerFrame = 0;         // Newest frame when the trigger was raised
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERSNAPSHOT_H
+#define SLIDERSNAPSHOT_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+#include <atomic>
+
+// State of the slider after one update, published as a whole. The counters are cumulative since start() and wrap
+// around: a reader keeps the values it already consumed and works on the differences, so nothing is lost between
+// two reads. Readers of TouchSlider::getSnapshot() that keep their own previous values do not steal events from each
+// other; the get...Status() functions share one set of consumed values and belong to a single task.
+typedef struct {
+  uint32_t frame;          // Update number, +1 per update (a jump of more than one means frames were skipped)
+  uint32_t timestamp;      // millis() of the update
+  uint8_t padMask;         // Touched pads, bit 0 = first pad
+  int16_t position;        // Filtered finger position (Q8 pads), -1 if not tracked
+  uint16_t swipeUp;        // Swipes up
+  uint16_t swipeDown;      // Swipes down
+  uint16_t swipeFineUp;    // Swipes fine up
+  uint16_t swipeFineDown;  // Swipes fine down
+  uint16_t pinch;          // Pinch steps (multi-touch)
+  uint16_t spread;         // Spread steps (multi-touch)
+  uint16_t scrollUp;       // Two-finger scroll steps towards the first pad (multi-touch)
+  uint16_t scrollDown;     // Two-finger scroll steps towards the last pad (multi-touch)
+} TouchSliderSnapshot;
+
+/**
+ * @brief Single writer, many readers: lock-free publication of a small trivially copyable value.
+ *
+ * A seqlock with two copies (a "latch"): the sequence number tells the readers which copy is stable while the writer
+ * rewrites the other one, so a reader never waits for the writer, even when it preempts the writer on the same core,
+ * and the writer never waits for the readers. A reader retries only if the writer went through a whole publication
+ * during its copy. The copies are stored as relaxed 32-bit atomics ordered by fences, so there is no data race.
+ */
+template <typename T>
+class SliderSeqlock {
+ public:
+  SliderSeqlock() {
+    for (uint8_t slot = 0; slot < 2; slot++) {
+      for (uint8_t i = 0; i < WORDS; i++) {
+        _slots[slot][i].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Publish a new value (writer only)
+  void write(const T& value) {
+    uint32_t words[WORDS] = {};
+    memcpy(words, &value, sizeof(T));
+    uint32_t seq = _seq.load(std::memory_order_relaxed);
+
+    _seq.store(seq + 1, std::memory_order_release);  // Readers move to copy 1
+    std::atomic_thread_fence(std::memory_order_release);
+    store(0, words);
+    _seq.store(seq + 2, std::memory_order_release);  // Copy 0 complete, readers move back to it
+    std::atomic_thread_fence(std::memory_order_release);
+    store(1, words);
+  }
+
+  // Consistent copy of the last complete value (any context)
+  void read(T& value) const {
+    uint32_t words[WORDS];
+    uint32_t seq;
+    do {
+      seq = _seq.load(std::memory_order_acquire);
+      for (uint8_t i = 0; i < WORDS; i++) {
+        words[i] = _slots[seq & 1][i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while (_seq.load(std::memory_order_relaxed) != seq);
+    memcpy(&value, words, sizeof(T));
+  }
+
+ private:
+  static const uint8_t WORDS = (sizeof(T) + 3) / 4;
+
+  std::atomic<uint32_t> _seq{0};  // Even: copy 0 is stable, odd: copy 1 is stable
+  std::atomic<uint32_t> _slots[2][WORDS];
+
+  void store(uint8_t slot, const uint32_t* words) {
+    for (uint8_t i = 0; i < WORDS; i++) {
+      _slots[slot][i].store(words[i], std::memory_order_relaxed);
+    }
+  }
+};
+
+#endif
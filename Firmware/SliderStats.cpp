@@ -0,0 +1,91 @@
+#include "SliderStats.h"
+
+/**
+ * @brief Record one sample in the histogram.
+ *
+ * @param cycles Duration of the measured stage in CPU cycles.
+ */
+void SliderHistogram::record(uint32_t cycles) {
+  _buckets[bucketIndex(cycles)]++;
+  _count++;
+  if (cycles > _max) {
+    _max = cycles;
+  }
+}
+
+/**
+ * @brief Clear all the samples of the histogram.
+ */
+void SliderHistogram::reset() {
+  memset(_buckets, 0, sizeof(_buckets));
+  _count = 0;
+  _max = 0;
+}
+
+/**
+ * @brief Get a percentile of the recorded samples.
+ *
+ * @param pct Percentile to compute, 0 to 100.
+ * @return The upper bound of the bucket holding the percentile (never above the real maximum), 0 if empty.
+ */
+uint32_t SliderHistogram::percentile(uint8_t pct) const {
+  if (_count == 0) {
+    return 0;
+  }
+
+  uint32_t target = ((uint64_t)_count * pct + 99) / 100;  // Rank of the sample, rounded up
+  if (target == 0) {
+    target = 1;
+  }
+
+  uint32_t accumulated = 0;
+  for (uint8_t i = 0; i < SLIDER_STATS_BUCKETS; i++) {
+    accumulated += _buckets[i];
+    if (accumulated >= target) {
+      uint32_t bound = bucketUpperBound(i);
+      return (bound < _max) ? bound : _max;
+    }
+  }
+  return _max;
+}
+
+/**
+ * @brief Fill a summary (count, p50, p99, max) of the histogram.
+ *
+ * @param stats Structure to fill.
+ */
+void SliderHistogram::summary(SliderStageStats& stats) const {
+  stats.count = _count;
+  stats.p50 = percentile(50);
+  stats.p99 = percentile(99);
+  stats.max = _max;
+}
+
+/**
+ * @brief Map a value to its bucket.
+ *
+ * Values below 2^SLIDER_STATS_SUB_BITS get one bucket each, the rest are grouped by most significant bit
+ * and the SLIDER_STATS_SUB_BITS bits that follow it.
+ */
+uint8_t SliderHistogram::bucketIndex(uint32_t value) {
+  if (value < (1UL << SLIDER_STATS_SUB_BITS)) {
+    return value;
+  }
+  uint8_t msb = 31 - __builtin_clz(value);
+  uint8_t sub = (value >> (msb - SLIDER_STATS_SUB_BITS)) & ((1 << SLIDER_STATS_SUB_BITS) - 1);
+  return ((msb - SLIDER_STATS_SUB_BITS + 1) << SLIDER_STATS_SUB_BITS) | sub;
+}
+
+/**
+ * @brief Largest value that falls in a bucket.
+ */
+uint32_t SliderHistogram::bucketUpperBound(uint8_t index) {
+  if (index < (1 << SLIDER_STATS_SUB_BITS)) {
+    return index;
+  }
+  uint8_t msb = (index >> SLIDER_STATS_SUB_BITS) + SLIDER_STATS_SUB_BITS - 1;
+  uint8_t sub = index & ((1 << SLIDER_STATS_SUB_BITS) - 1);
+  uint8_t shift = msb - SLIDER_STATS_SUB_BITS;
+  uint32_t lower = ((uint32_t)((1 << SLIDER_STATS_SUB_BITS) | sub)) << shift;
+  return lower + ((1UL << shift) - 1);
+}
@@ -0,0 +1,66 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERSTATS_H
+#define SLIDERSTATS_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+// #define TOUCHSLIDER_STATS                   // Enable latency instrumentation (CAP1208 and TouchSlider), uncomment this line or add -D TOUCHSLIDER_STATS
+
+#define SLIDER_STATS_SUB_BITS 2                                        // Sub-buckets per power of two (2 bits -> 25% resolution)
+#define SLIDER_STATS_BUCKETS ((32 - SLIDER_STATS_SUB_BITS + 1) << SLIDER_STATS_SUB_BITS)  // Buckets needed to cover a uint32_t cycle count
+
+/*********************** LIBRARY OPTIONS **********************/
+
+// Cycle-count timestamps, they compile to nothing when TOUCHSLIDER_STATS is not defined
+#ifdef TOUCHSLIDER_STATS
+  #define SLIDER_STATS_STAMP(var)         uint32_t var = ESP.getCycleCount()
+  #define SLIDER_STATS_RECORD(hist, var)  (hist).record(ESP.getCycleCount() - (var))
+#else
+  #define SLIDER_STATS_STAMP(var)
+  #define SLIDER_STATS_RECORD(hist, var)
+#endif
+
+// Summary of one histogram, all values in CPU cycles
+typedef struct {
+  uint32_t count;  // Number of samples recorded
+  uint32_t p50;    // Median (upper bound of the bucket)
+  uint32_t p99;    // 99th percentile (upper bound of the bucket)
+  uint32_t max;    // Largest sample seen
+} SliderStageStats;
+
+/**
+ * @brief Fixed-bucket latency histogram.
+ *
+ * Samples are binned by their most significant bit plus SLIDER_STATS_SUB_BITS bits below it, so recording is
+ * O(1) and the percentiles are accurate to the width of one bucket. No allocation, safe to call from the Ticker.
+ */
+class SliderHistogram {
+ public:
+  SliderHistogram() { reset(); }
+
+  void record(uint32_t cycles);
+  void reset();
+  uint32_t percentile(uint8_t pct) const;
+  void summary(SliderStageStats& stats) const;
+
+  uint32_t count() const { return _count; }
+  uint32_t max() const { return _max; }
+
+ private:
+  uint32_t _buckets[SLIDER_STATS_BUCKETS];
+  uint32_t _count;
+  uint32_t _max;
+
+  static uint8_t bucketIndex(uint32_t value);
+  static uint32_t bucketUpperBound(uint8_t index);
+};
+
+#endif
@@ -0,0 +1,196 @@
+#include "SliderTelemetry.h"
+
+#include <stdio.h>
+
+/**
+ * @brief Send a frame, or drop it if the output is full.
+ *
+ * The sequence number of the frame is assigned here and the events of the skipped frames are merged into it.
+ *
+ * @param frame Frame to send (sequence and events are updated).
+ */
+void SliderTelemetry::send(SliderTelemetryFrame& frame) {
+  frame.sequence = _sequence++;
+  frame.events |= _pendingEvents;
+  _pendingEvents = 0;
+  _skipped = 0;
+
+  uint8_t buffer[SLIDER_TELEMETRY_FRAME_SIZE];
+  size_t length = encode(frame, buffer);
+  if (_out.availableForWrite() < (int)length) {
+    _overflows++;  // Never block the sensing context
+    return;
+  }
+  _out.write(buffer, length);
+  _sent++;
+}
+
+/**
+ * @brief Account for a frame that is not sent because of the decimation.
+ *
+ * The frame takes no sequence number: the host sees no gap for it.
+ *
+ * @param events Events published during the frame, they are carried to the next frame sent.
+ */
+void SliderTelemetry::skip(uint16_t events) {
+  _pendingEvents |= events;
+  _skipped++;
+  _decimated++;
+}
+
+/**
+ * @brief Serialize a frame.
+ *
+ * @param frame Frame to serialize.
+ * @param buffer Destination, SLIDER_TELEMETRY_FRAME_SIZE bytes.
+ * @return Number of bytes written.
+ */
+size_t SliderTelemetry::encode(const SliderTelemetryFrame& frame, uint8_t buffer[SLIDER_TELEMETRY_FRAME_SIZE]) {
+  buffer[0] = SLIDER_TELEMETRY_SYNC_1;
+  buffer[1] = SLIDER_TELEMETRY_SYNC_2;
+  buffer[2] = SLIDER_TELEMETRY_PAYLOAD_SIZE;
+  buffer[3] = SLIDER_TELEMETRY_TYPE_TOUCH;
+  buffer[4] = frame.sequence;
+  buffer[5] = frame.sequence >> 8;
+  buffer[6] = frame.timestamp;
+  buffer[7] = frame.timestamp >> 8;
+  buffer[8] = frame.timestamp >> 16;
+  buffer[9] = frame.timestamp >> 24;
+  buffer[10] = frame.padMask;
+  buffer[11] = frame.status;
+  buffer[12] = frame.events;
+  buffer[13] = frame.events >> 8;
+  memcpy(&buffer[14], frame.delta, SLIDER_TELEMETRY_PADS);
+
+  uint16_t crc = crc16(&buffer[2], SLIDER_TELEMETRY_FRAME_SIZE - 4);
+  buffer[22] = crc;
+  buffer[23] = crc >> 8;
+  return SLIDER_TELEMETRY_FRAME_SIZE;
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+ */
+uint16_t SliderTelemetry::crc16(const uint8_t* data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  while (length--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+/**
+ * @brief Forget any partial frame and the counters.
+ */
+void SliderTelemetryDecoder::reset() {
+  _length = 0;
+  _type = 0;
+  _synced = false;
+  _frames = 0;
+  _dropped = 0;
+  _crcErrors = 0;
+}
+
+/**
+ * @brief Feed one received byte.
+ *
+ * @param byte Received byte.
+ * @param frame Filled when a valid frame completes.
+ * @return true if a valid frame was decoded with this byte.
+ */
+bool SliderTelemetryDecoder::push(uint8_t byte, SliderTelemetryFrame& frame) {
+  _buffer[_length++] = byte;
+
+  // Hunt for the sync bytes and a plausible header
+  if (!validHeader(_buffer, _length)) {
+    resync();
+    return false;
+  }
+  uint8_t size = _length >= 3 ? _buffer[2] + 5 : SLIDER_TELEMETRY_FRAME_SIZE;  // Header, payload and CRC
+  if (_length < size) {
+    return false;
+  }
+
+  uint16_t crc = _buffer[size - 2] | (_buffer[size - 1] << 8);
+  if (crc != SliderTelemetry::crc16(&_buffer[2], size - 4)) {
+    _crcErrors++;
+    resync();
+    return false;
+  }
+  _length = 0;
+
+  // The first format has a single events byte, the delta counts come one byte earlier
+  bool v1 = _buffer[3] == SLIDER_TELEMETRY_TYPE_TOUCH_V1;
+  _type = _buffer[3];
+  frame.sequence = _buffer[4] | (_buffer[5] << 8);
+  frame.timestamp = (uint32_t)_buffer[6] | ((uint32_t)_buffer[7] << 8) | ((uint32_t)_buffer[8] << 16) | ((uint32_t)_buffer[9] << 24);
+  frame.padMask = _buffer[10];
+  frame.status = _buffer[11];
+  frame.events = v1 ? _buffer[12] : _buffer[12] | (_buffer[13] << 8);
+  memcpy(frame.delta, &_buffer[v1 ? 13 : 14], SLIDER_TELEMETRY_PADS);
+
+  if (_synced) {
+    _dropped += (uint16_t)(frame.sequence - _lastSequence - 1);
+  }
+  _synced = true;
+  _lastSequence = frame.sequence;
+  _frames++;
+  return true;
+}
+
+/**
+ * @brief Write the CSV column names.
+ */
+size_t SliderTelemetryDecoder::formatCsvHeader(char* buffer, size_t size) {
+  return snprintf(buffer, size, "sequence,timestamp_us,pad_mask,status,events,d1,d2,d3,d4,d5,d6,d7,d8");
+}
+
+/**
+ * @brief Write a frame as one CSV line (no line terminator).
+ */
+size_t SliderTelemetryDecoder::formatCsv(char* buffer, size_t size, const SliderTelemetryFrame& frame) {
+  const int8_t* d = frame.delta;
+  return snprintf(buffer, size, "%u,%lu,0x%02x,0x%02x,0x%04x,%d,%d,%d,%d,%d,%d,%d,%d", frame.sequence,
+                  (unsigned long)frame.timestamp, frame.padMask, frame.status, frame.events,
+                  d[0], d[1], d[2], d[3], d[4], d[5], d[6], d[7]);
+}
+
+/**
+ * @brief Drop the first byte of the partial frame and look for the next sync in the rest.
+ */
+void SliderTelemetryDecoder::resync() {
+  uint8_t start = 1;
+  while (start < _length && _buffer[start] != SLIDER_TELEMETRY_SYNC_1) {
+    start++;
+  }
+  _length -= start;
+  memmove(_buffer, &_buffer[start], _length);
+
+  // The remaining bytes may themselves be an invalid header, check them again
+  if (_length > 1 && !validHeader(_buffer, _length)) {
+    resync();
+  }
+}
+
+/**
+ * @brief Check the header bytes received so far: sync, then a payload length and a type of the same format.
+ */
+bool SliderTelemetryDecoder::validHeader(const uint8_t* header, uint8_t length) {
+  if (length >= 1 && header[0] != SLIDER_TELEMETRY_SYNC_1) {
+    return false;
+  }
+  if (length >= 2 && header[1] != SLIDER_TELEMETRY_SYNC_2) {
+    return false;
+  }
+  if (length >= 3 && header[2] != SLIDER_TELEMETRY_PAYLOAD_SIZE && header[2] != SLIDER_TELEMETRY_PAYLOAD_SIZE_V1) {
+    return false;
+  }
+  if (length >= 4) {
+    uint8_t type = header[2] == SLIDER_TELEMETRY_PAYLOAD_SIZE ? SLIDER_TELEMETRY_TYPE_TOUCH : SLIDER_TELEMETRY_TYPE_TOUCH_V1;
+    return header[3] == type;
+  }
+  return true;
+}
@@ -0,0 +1,124 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERTELEMETRY_H
+#define SLIDERTELEMETRY_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_TELEMETRY_SYNC_1 0xA5       // First sync byte of every frame
+#define SLIDER_TELEMETRY_SYNC_2 0x5A       // Second sync byte of every frame
+#define SLIDER_TELEMETRY_TYPE_TOUCH 0x02   // Frame type: touch frame, 16 event bits (0x01: first format, 8 bits)
+#define SLIDER_TELEMETRY_PADS 8            // Delta counts per frame
+
+/*********************** LIBRARY OPTIONS **********************/
+
+/*
+ * Frame layout, multi-byte fields are little endian:
+ *
+ *   0  2  sync (0xA5 0x5A)
+ *   2  1  payload length (bytes 3 to 21, 19 for a touch frame)
+ *   3  1  frame type, which also gives the format (SLIDER_TELEMETRY_TYPE_TOUCH)
+ *   4  2  sequence number, incremented for every frame due (sent or dropped); decimated frames take no number
+ *   6  4  timestamp, micros()
+ *  10  1  pad mask (SENSOR_INPUTS, bit 0 = first pad)
+ *  11  1  general status (GEN_STATUS)
+ *  12  2  events, bit n set if TouchSliderEventType n was published since the previous frame
+ *  14  8  delta counts (signed), first pad first
+ *  22  2  CRC-16/CCITT-FALSE of bytes 2 to 21
+ *
+ * 24 bytes per frame: at 115200 baud and the default 50 ms update interval that is about 4% of the UART.
+ *
+ * The first format (type 0x01, payload 18, 23 bytes) had a single events byte, so the event types from 8 on were
+ * lost. SliderTelemetryDecoder still reads it, the two formats can be mixed in one stream.
+ */
+#define SLIDER_TELEMETRY_FRAME_SIZE 24
+#define SLIDER_TELEMETRY_PAYLOAD_SIZE 19
+#define SLIDER_TELEMETRY_TYPE_TOUCH_V1 0x01
+#define SLIDER_TELEMETRY_PAYLOAD_SIZE_V1 18
+
+typedef struct {
+  uint16_t sequence;
+  uint32_t timestamp;  // micros()
+  uint8_t padMask;
+  uint8_t status;
+  uint16_t events;  // Bit per TouchSliderEventType
+  int8_t delta[SLIDER_TELEMETRY_PADS];
+} SliderTelemetryFrame;
+
+/**
+ * @brief Encoder of the binary telemetry stream.
+ *
+ * Never blocks: if the output has no room for a whole frame, the frame is dropped and counted (the gap in the
+ * sequence numbers tells the host). Set a decimation to send one frame out of N; the events of the skipped frames
+ * are merged into the next frame sent. Skipped frames do not use a sequence number, so on the host a gap always
+ * means frames lost, never the decimation (which shows in the timestamps).
+ */
+class SliderTelemetry {
+ public:
+  SliderTelemetry(Print& out, uint8_t decimation = 1) : _out(out) { setDecimation(decimation); }
+
+  void setDecimation(uint8_t decimation) { _decimation = decimation ? decimation : 1; }
+  bool isDue() const { return _skipped + 1 >= _decimation; }  // The next frame will be sent
+  void send(SliderTelemetryFrame& frame);
+  void skip(uint16_t events);
+
+  uint32_t getSent() const { return _sent; }
+  uint32_t getOverflows() const { return _overflows; }  // Frames dropped, the output was full
+  uint32_t getDecimated() const { return _decimated; }  // Frames skipped by the decimation
+
+  static size_t encode(const SliderTelemetryFrame& frame, uint8_t buffer[SLIDER_TELEMETRY_FRAME_SIZE]);
+  static uint16_t crc16(const uint8_t* data, size_t length);
+
+ private:
+  Print& _out;
+  uint8_t _decimation;
+  uint8_t _skipped = 0;
+  uint16_t _pendingEvents = 0;
+  uint16_t _sequence = 0;
+  uint32_t _sent = 0;
+  uint32_t _overflows = 0;
+  uint32_t _decimated = 0;
+};
+
+/**
+ * @brief Streaming decoder of the telemetry, for the host side (no Arduino dependency beyond the types).
+ *
+ * Bytes that are not part of a valid frame (text logs on the same UART, corrupted frames) are skipped.
+ */
+class SliderTelemetryDecoder {
+ public:
+  SliderTelemetryDecoder() { reset(); }
+
+  void reset();
+  bool push(uint8_t byte, SliderTelemetryFrame& frame);
+
+  uint32_t getFrames() const { return _frames; }          // Valid frames decoded
+  uint32_t getDropped() const { return _dropped; }        // Frames lost (overflow or link) according to the sequence numbers
+  uint32_t getCrcErrors() const { return _crcErrors; }    // Frames rejected by the CRC
+  uint8_t getType() const { return _type; }               // Type (format) of the last frame decoded
+
+  static size_t formatCsvHeader(char* buffer, size_t size);
+  static size_t formatCsv(char* buffer, size_t size, const SliderTelemetryFrame& frame);
+
+ private:
+  uint8_t _buffer[SLIDER_TELEMETRY_FRAME_SIZE];
+  uint8_t _length;
+  uint8_t _type;
+  bool _synced;
+  uint16_t _lastSequence;
+  uint32_t _frames;
+  uint32_t _dropped;
+  uint32_t _crcErrors;
+
+  void resync();
+  static bool validHeader(const uint8_t* header, uint8_t length);
+};
+
+#endif
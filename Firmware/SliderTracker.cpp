@@ -0,0 +1,70 @@
+#include "SliderTracker.h"
+
+/**
+ * @brief Forget the tracked contact.
+ */
+void SliderTracker::reset() {
+  _position = 0;
+  _velocity = 0;
+  _tracking = false;
+  _newContact = false;
+  _coasting = 0;
+  _outliers = 0;
+}
+
+/**
+ * @brief Run one step of the tracker.
+ *
+ * @param touched true if at least one pad is touched in this frame.
+ * @param measurement Measured position (Q8 pads), ignored if not touched.
+ * @return true while a contact is tracked (touched, or coasting through a missed frame).
+ */
+bool SliderTracker::update(bool touched, int16_t measurement) {
+  _newContact = false;
+
+  if (!touched) {
+    if (!_tracking) {
+      return false;
+    }
+    if (_coasting >= _maxCoast) {  // Too many frames without touch, the contact ended
+      reset();
+      return false;
+    }
+    _coasting++;
+    _position += _velocity;       // Predict only
+    _velocity -= _velocity >> 2;  // and slow down while no data arrives
+    return true;
+  }
+
+  if (!_tracking) {  // New contact, start at the measurement
+    _position = measurement;
+    _velocity = 0;
+    _tracking = true;
+    _newContact = true;
+    _coasting = 0;
+    _outliers = 0;
+    return true;
+  }
+
+  _coasting = 0;
+  int16_t predicted = _position + _velocity;
+  int16_t residual = measurement - predicted;
+
+  if (abs(residual) > _gate) {
+    _outlierTotal++;
+    if (++_outliers < SLIDER_TRACKER_MAX_OUTLIERS) {
+      _position = predicted;  // Reject the measurement, keep the prediction
+      return true;
+    }
+    _position = measurement;  // The jump persists, follow it as a new contact
+    _velocity = 0;
+    _outliers = 0;
+    _newContact = true;
+    return true;
+  }
+
+  _outliers = 0;
+  _position = predicted + (int16_t)(((int32_t)_alpha * residual) >> 8);
+  _velocity = _velocity + (int16_t)(((int32_t)_beta * residual) >> 8);
+  return true;
+}
@@ -0,0 +1,64 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERTRACKER_H
+#define SLIDERTRACKER_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_TRACKER_ONE_PAD 256         // Q8 fixed point: one pad is 256
+#define SLIDER_TRACKER_SWIPE_STEP 128      // Movement (Q8) that emits one swipe, half a pad as the raw detector
+#define SLIDER_TRACKER_ALPHA 160           // Position gain, Q8 (0.625)
+#define SLIDER_TRACKER_BETA 64             // Velocity gain, Q8 (0.25)
+#define SLIDER_TRACKER_GATE 640            // Residuals above 2.5 pads are outliers, Q8
+#define SLIDER_TRACKER_MAX_COAST 1         // Frames without touch that are bridged before the contact is lost
+#define SLIDER_TRACKER_MAX_OUTLIERS 2      // Consecutive outliers after which the tracker jumps to the measurement
+
+/*********************** LIBRARY OPTIONS **********************/
+
+/**
+ * @brief Alpha-beta tracker of the finger position along the slider.
+ *
+ * Integer math only (Q8, one pad = 256), so it can run in the Ticker context without the FPU.
+ * Single missed frames are bridged by prediction (coasting) and isolated jumps are rejected as outliers.
+ */
+class SliderTracker {
+ public:
+  SliderTracker() { reset(); }
+
+  void reset();
+  bool update(bool touched, int16_t measurement);
+
+  void setGains(uint8_t alpha, uint8_t beta) { _alpha = alpha; _beta = beta; }  // Q8 gains
+  void setGate(int16_t gate) { _gate = gate; }                                  // Q8 outlier gate
+  void setMaxCoast(uint8_t frames) { _maxCoast = frames; }                      // Frames bridged without touch
+
+  bool isTracking() const { return _tracking; }        // A contact is being tracked (touched or coasting)
+  bool isCoasting() const { return _coasting != 0; }   // The last frames had no touch
+  bool isNewContact() const { return _newContact; }    // The last update started a new contact
+  int16_t position() const { return _position; }       // Filtered position, Q8 pads
+  int16_t velocity() const { return _velocity; }       // Filtered velocity, Q8 pads per frame
+  uint32_t outliers() const { return _outlierTotal; }  // Measurements rejected since start
+
+ private:
+  int16_t _position;
+  int16_t _velocity;
+  bool _tracking;
+  bool _newContact;
+  uint8_t _coasting;
+  uint8_t _outliers;
+  uint32_t _outlierTotal = 0;
+
+  uint8_t _alpha = SLIDER_TRACKER_ALPHA;
+  uint8_t _beta = SLIDER_TRACKER_BETA;
+  int16_t _gate = SLIDER_TRACKER_GATE;
+  uint8_t _maxCoast = SLIDER_TRACKER_MAX_COAST;
+};
+
+#endif
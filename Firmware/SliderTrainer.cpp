@@ -0,0 +1,319 @@
+#include "SliderTrainer.h"
+
+#include <stdio.h>
+
+static const char* const FEATURE_NAMES[SLIDER_FEATURE_COUNT] = {
+    "SLIDER_FEATURE_POSITION", "SLIDER_FEATURE_START", "SLIDER_FEATURE_START_TO_END", "SLIDER_FEATURE_TRAVEL",
+    "SLIDER_FEATURE_VELOCITY", "SLIDER_FEATURE_WINDOW_TRAVEL", "SLIDER_FEATURE_SINCE_SWIPE", "SLIDER_FEATURE_SPAN",
+    "SLIDER_FEATURE_AGE", "SLIDER_FEATURE_PADS", "SLIDER_FEATURE_GAP", "SLIDER_FEATURE_SWIPES", "SLIDER_FEATURE_STRENGTH"};
+static const char* const CLASS_NAMES[SLIDER_CLASS_COUNT] = {
+    "SLIDER_CLASS_NONE", "SLIDER_CLASS_SWIPE_UP", "SLIDER_CLASS_SWIPE_DOWN", "SLIDER_CLASS_SWIPE_FINE_UP",
+    "SLIDER_CLASS_SWIPE_FINE_DOWN"};
+
+/**
+ * @brief Create the trainer, nothing is allocated before begin().
+ *
+ * @param maxSamples Frames kept for training.
+ */
+SliderTrainer::SliderTrainer(uint32_t maxSamples) {
+  _maxSamples = maxSamples;
+}
+
+SliderTrainer::~SliderTrainer() {
+  free(_features);
+  free(_classes);
+  free(_order);
+}
+
+/**
+ * @brief Allocate the sample buffers, in PSRAM if available.
+ *
+ * The capacity is cut down to half of the free memory (PSRAM, or the heap and its largest block), so the rest of the
+ * sketch keeps running: without PSRAM SLIDER_TRAINER_MAX_SAMPLES frames (576 KB) never fit.
+ *
+ * @return false if fewer than SLIDER_TRAINER_MIN_SAMPLES frames fit or the allocation failed.
+ */
+bool SliderTrainer::begin() {
+  if (_features != NULL) {
+    return true;
+  }
+  bool psram = psramFound();
+  uint32_t fit = psram ? ESP.getFreePsram() / 2 / SLIDER_TRAINER_SAMPLE_BYTES
+                       : min(ESP.getFreeHeap() / 2 / SLIDER_TRAINER_SAMPLE_BYTES, ESP.getMaxAllocHeap() / SLIDER_FEATURE_COUNT);
+  uint32_t samples = min(_maxSamples, fit);
+  if (samples < SLIDER_TRAINER_MIN_SAMPLES) {
+    log_e("Trainer: room for %lu samples only, %u needed", (unsigned long)samples, SLIDER_TRAINER_MIN_SAMPLES);
+    return false;
+  }
+
+  size_t featureBytes = (size_t)samples * SLIDER_FEATURE_COUNT;
+  size_t orderBytes = (size_t)samples * sizeof(uint32_t);
+  _features = (int8_t*)(psram ? ps_malloc(featureBytes) : malloc(featureBytes));
+  _classes = (uint8_t*)(psram ? ps_malloc(samples) : malloc(samples));
+  _order = (uint32_t*)(psram ? ps_malloc(orderBytes) : malloc(orderBytes));
+  if (_features == NULL || _classes == NULL || _order == NULL) {
+    log_e("Trainer: cannot allocate %lu samples", (unsigned long)samples);
+    free(_features);
+    free(_classes);
+    free(_order);
+    _features = NULL;
+    _classes = NULL;
+    _order = NULL;
+    return false;
+  }
+
+  if (samples < _maxSamples) {
+    log_w("Trainer: %lu of %lu samples fit in %s", (unsigned long)samples, (unsigned long)_maxSamples, psram ? "PSRAM" : "RAM");
+  }
+  _maxSamples = samples;
+  log_i("Trainer: %lu samples in %s", (unsigned long)samples, psram ? "PSRAM" : "RAM");
+  return true;
+}
+
+/**
+ * @brief Replay a labelled trace and keep every frame as a sample.
+ *
+ * The classifier state follows the labels (the events the labels require are committed), so the features of each
+ * frame are those the classifier sees when it decided correctly until then.
+ *
+ * @param trace Labelled trace.
+ * @return Samples added, fewer than the frames if the trainer is full.
+ */
+uint32_t SliderTrainer::addTrace(const TouchTrace& trace) {
+  if (_features == NULL) {
+    return 0;
+  }
+
+  SliderClassifier classifier;
+  classifier.setPads(_pads);
+  uint32_t added = 0;
+  uint16_t tick = 0;
+  uint16_t frame = 0;
+  uint16_t lastTick = trace.nextTick() + TOUCH_TRACE_TAIL;
+
+  for (; tick < lastTick; tick++) {
+    uint8_t mask = 0;
+    const int8_t* deltas = NULL;
+    if (frame < trace.frameCount() && trace.frame(frame).tick == tick) {  // Missing ticks are frames with no touch
+      mask = trace.frame(frame).mask;
+      deltas = trace.hasDeltas() ? trace.frame(frame).delta : NULL;
+      frame++;
+    }
+
+    classifier.extract(mask, deltas);
+    SliderGestureClass cls = target(trace, tick, classifier);
+    classifier.commit(cls);
+
+    if (_count >= _maxSamples) {
+      if (!_full) {
+        log_w("Trainer: full after %lu samples", (unsigned long)_count);
+        _full = true;
+      }
+      continue;
+    }
+    memcpy(_features + (size_t)_count * SLIDER_FEATURE_COUNT, classifier.features(), SLIDER_FEATURE_COUNT);
+    _classes[_count++] = cls;
+    _classCount[cls]++;
+    added++;
+  }
+  return added;
+}
+
+/**
+ * @brief Event the labels require in a frame, as SliderClassifier::gate() allows it.
+ *
+ * A label covers its ticks and TOUCH_TRACE_TOLERANCE ticks after its end, as in the replay scoring.
+ */
+SliderGestureClass SliderTrainer::target(const TouchTrace& trace, uint16_t tick, const SliderClassifier& classifier) const {
+  for (uint8_t l = 0; l < trace.labelCount(); l++) {
+    const TouchTraceLabel& label = trace.label(l);
+    if (tick < label.start || tick > label.end + TOUCH_TRACE_TOLERANCE) {
+      continue;
+    }
+    switch (label.gesture) {
+      case TRACE_GESTURE_SWIPE_UP:
+        return classifier.gate(SLIDER_CLASS_SWIPE_UP);
+      case TRACE_GESTURE_SWIPE_DOWN:
+        return classifier.gate(SLIDER_CLASS_SWIPE_DOWN);
+      case TRACE_GESTURE_SWIPE_FINE_UP:
+        return classifier.gate(SLIDER_CLASS_SWIPE_FINE_UP);
+      case TRACE_GESTURE_SWIPE_FINE_DOWN:
+        return classifier.gate(SLIDER_CLASS_SWIPE_FINE_DOWN);
+      default:
+        return SLIDER_CLASS_NONE;
+    }
+  }
+  return SLIDER_CLASS_NONE;
+}
+
+/**
+ * @brief Grow the decision tree on the samples.
+ *
+ * @param maxDepth Longest path, at most SLIDER_CLASSIFIER_MAX_DEPTH.
+ * @param minLeaf Fewest samples in a leaf.
+ * @return false if there are no samples.
+ */
+bool SliderTrainer::train(uint8_t maxDepth, uint16_t minLeaf) {
+  if (_count == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < _count; i++) {
+    _order[i] = i;
+  }
+  _nodes = 0;
+  _depth = 0;
+  grow(0, _count, 0, min(maxDepth, (uint8_t)SLIDER_CLASSIFIER_MAX_DEPTH), minLeaf > 0 ? minLeaf : 1);
+  log_i("Trainer: %lu samples, %u nodes, depth %u", (unsigned long)_count, _nodes, _depth);
+  return true;
+}
+
+/**
+ * @brief Grow the subtree of the samples _order[first, last), returns the index of its root.
+ *
+ * Children are always stored after their parent. Two leaves of the same class are merged into their parent.
+ */
+uint8_t SliderTrainer::grow(uint32_t first, uint32_t last, uint8_t depth, uint8_t maxDepth, uint16_t minLeaf) {
+  uint8_t index = _nodes++;
+  SliderTreeNode& node = _tree[index];
+  _depth = depth > _depth ? depth : _depth;
+
+  // Weighted class totals, the leaf takes the heaviest class
+  uint64_t total[SLIDER_CLASS_COUNT] = {};
+  for (uint32_t i = first; i < last; i++) {
+    total[_classes[_order[i]]] += weight(_classes[_order[i]]);
+  }
+  uint64_t weightSum = 0;
+  uint8_t best = 0;
+  uint8_t classes = 0;
+  for (uint8_t c = 0; c < SLIDER_CLASS_COUNT; c++) {
+    weightSum += total[c];
+    best = total[c] > total[best] ? c : best;
+    classes += total[c] != 0;
+  }
+  node.feature = -1;
+  node.threshold = 0;
+  node.left = best;
+  node.right = 0;
+
+  if (depth >= maxDepth || classes <= 1 || last - first < 2u * minLeaf || _nodes + 2 > SLIDER_CLASSIFIER_MAX_NODES) {
+    return index;
+  }
+
+  // Best split: lowest weighted Gini impurity of the two sides, searched on the histogram of each feature
+  double bestImpurity = 0;
+  for (uint8_t c = 0; c < SLIDER_CLASS_COUNT; c++) {
+    bestImpurity += (double)total[c] * (weightSum - total[c]);
+  }
+  bestImpurity /= weightSum;
+  int8_t bestFeature = -1;
+  int8_t bestThreshold = 0;
+
+  for (uint8_t f = 0; f < SLIDER_FEATURE_COUNT; f++) {
+    memset(_histogram, 0, sizeof(_histogram));
+    for (uint32_t i = first; i < last; i++) {
+      uint32_t sample = _order[i];
+      _histogram[(uint8_t)(_features[(size_t)sample * SLIDER_FEATURE_COUNT + f] + 128)][_classes[sample]] += weight(_classes[sample]);
+    }
+
+    uint64_t left[SLIDER_CLASS_COUNT] = {};
+    uint64_t leftWeight = 0;
+    uint32_t leftCount = 0;
+    for (uint16_t v = 0; v < 255; v++) {
+      bool empty = true;
+      for (uint8_t c = 0; c < SLIDER_CLASS_COUNT; c++) {
+        left[c] += _histogram[v][c];
+        leftWeight += _histogram[v][c];
+        leftCount += _histogram[v][c] / weight(c);
+        empty = empty && _histogram[v][c] == 0;
+      }
+      if (empty || leftCount < minLeaf || (last - first) - leftCount < minLeaf) {
+        continue;
+      }
+      uint64_t rightWeight = weightSum - leftWeight;
+      double impurityLeft = 0;
+      double impurityRight = 0;
+      for (uint8_t c = 0; c < SLIDER_CLASS_COUNT; c++) {
+        uint64_t right = total[c] - left[c];
+        impurityLeft += (double)left[c] * (leftWeight - left[c]);
+        impurityRight += (double)right * (rightWeight - right);
+      }
+      double impurity = impurityLeft / leftWeight + impurityRight / rightWeight;
+      if (impurity < bestImpurity - 1e-9) {
+        bestImpurity = impurity;
+        bestFeature = f;
+        bestThreshold = (int8_t)(v - 128);
+      }
+    }
+  }
+
+  if (bestFeature < 0) {
+    return index;
+  }
+
+  // Partition the samples: feature <= threshold first
+  uint32_t split = first;
+  for (uint32_t i = first; i < last; i++) {
+    uint32_t sample = _order[i];
+    if (_features[(size_t)sample * SLIDER_FEATURE_COUNT + bestFeature] <= bestThreshold) {
+      _order[i] = _order[split];
+      _order[split++] = sample;
+    }
+  }
+
+  uint8_t left = grow(first, split, depth + 1, maxDepth, minLeaf);
+  uint8_t right = grow(split, last, depth + 1, maxDepth, minLeaf);
+  if (_tree[left].feature < 0 && _tree[right].feature < 0 && _tree[left].left == _tree[right].left) {
+    _nodes = index + 1;  // Both children say the same, keep the leaf
+    return index;
+  }
+  _tree[index].feature = bestFeature;
+  _tree[index].threshold = bestThreshold;
+  _tree[index].left = left;
+  _tree[index].right = right;
+  return index;
+}
+
+/**
+ * @brief Print the tree as a SliderGestureModel.h header.
+ * @param command Command line that trained it, recorded in the header so that the model can be trained again.
+ */
+void SliderTrainer::printModel(Print& out, const char* command) const {
+  char line[160];
+  out.println("/*");
+  out.println(" * Gesture classifier model, generated by SliderTrainer::printModel(). Do not edit: train again.");
+  snprintf(line, sizeof(line), " * %lu samples (%lu swipe up, %lu swipe down, %lu fine up, %lu fine down), %u nodes", (unsigned long)_count,
+           (unsigned long)_classCount[SLIDER_CLASS_SWIPE_UP], (unsigned long)_classCount[SLIDER_CLASS_SWIPE_DOWN],
+           (unsigned long)_classCount[SLIDER_CLASS_SWIPE_FINE_UP], (unsigned long)_classCount[SLIDER_CLASS_SWIPE_FINE_DOWN], _nodes);
+  out.println(line);
+  if (command != NULL) {
+    out.print(" * Trained with: ");
+    out.println(command);
+  }
+  out.println(" * */");
+  out.println();
+  out.println("#ifndef SLIDERGESTUREMODEL_H");
+  out.println("#define SLIDERGESTUREMODEL_H");
+  out.println();
+  out.println("#include \"SliderClassifier.h\"");
+  out.println();
+  out.println("// Feature, threshold, left (or class), right");
+  out.println("constexpr SliderTreeNode SLIDER_GESTURE_TREE[] = {");
+  for (uint8_t i = 0; i < _nodes; i++) {
+    const SliderTreeNode& node = _tree[i];
+    if (node.feature < 0) {
+      snprintf(line, sizeof(line), "    {-1, 0, %s, 0},  // %u", CLASS_NAMES[node.left], i);
+    } else {
+      snprintf(line, sizeof(line), "    {%s, %d, %u, %u},  // %u", FEATURE_NAMES[node.feature], node.threshold, node.left,
+               node.right, i);
+    }
+    out.println(line);
+  }
+  out.println("};");
+  out.println();
+  out.println("constexpr uint8_t SLIDER_GESTURE_TREE_NODES = sizeof(SLIDER_GESTURE_TREE) / sizeof(SLIDER_GESTURE_TREE[0]);");
+  out.println();
+  out.println("static_assert(sliderTreeValid(SLIDER_GESTURE_TREE, SLIDER_GESTURE_TREE_NODES), \"Malformed gesture model\");");
+  out.println("static_assert(sliderTreeDepth(SLIDER_GESTURE_TREE) <= SLIDER_CLASSIFIER_MAX_DEPTH, \"Gesture model too deep\");");
+  out.println();
+  out.println("#endif");
+}
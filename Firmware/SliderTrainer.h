@@ -0,0 +1,71 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERTRAINER_H
+#define SLIDERTRAINER_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+#include "SliderClassifier.h"
+#include "TouchTrace.h"
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_TRAINER_MAX_SAMPLES 32768   // Frames kept for training (18 bytes each, in PSRAM if available)
+#define SLIDER_TRAINER_MIN_SAMPLES 1024    // Fewest frames worth training on, begin() fails below
+#define SLIDER_TRAINER_SAMPLE_BYTES (SLIDER_FEATURE_COUNT + 1 + 4)  // Features, class and order index of a frame
+#define SLIDER_TRAINER_MIN_LEAF 16         // Fewest frames in a leaf
+#define SLIDER_TRAINER_EVENT_WEIGHT 8      // Weight of the frames that must emit an event against the frames that must not
+
+/*********************** LIBRARY OPTIONS **********************/
+
+/**
+ * @brief Offline trainer of the gesture classifier, on the host or on the device.
+ *
+ * Labelled traces are replayed through the feature extraction of SliderClassifier. Every frame becomes a sample whose
+ * class is the event the labels require in that frame: a swipe each SLIDER_CLASSIFIER_STEP of travel inside a swipe
+ * label, a swipe fine on the release of an edge tap label, nothing otherwise. A CART decision tree (Gini impurity,
+ * int8 thresholds from per-feature histograms) is grown on the samples and printed as a SliderGestureModel.h header.
+ */
+class SliderTrainer {
+ public:
+  SliderTrainer(uint32_t maxSamples = SLIDER_TRAINER_MAX_SAMPLES);
+  ~SliderTrainer();
+
+  bool begin();
+  uint32_t getCapacity() const { return _features == NULL ? 0 : _maxSamples; }
+  void setPads(uint8_t pads) { _pads = pads; }
+  uint32_t addTrace(const TouchTrace& trace);
+  uint32_t getSamples() const { return _count; }
+  uint32_t getClassSamples(SliderGestureClass cls) const { return _classCount[cls]; }
+
+  bool train(uint8_t maxDepth = SLIDER_CLASSIFIER_MAX_DEPTH, uint16_t minLeaf = SLIDER_TRAINER_MIN_LEAF);
+  const SliderTreeNode* getTree() const { return _tree; }
+  uint8_t getNodes() const { return _nodes; }
+  void printModel(Print& out, const char* command = NULL) const;
+
+ private:
+  uint32_t _maxSamples;
+  uint8_t _pads = 8;
+  int8_t* _features = NULL;   // SLIDER_FEATURE_COUNT per sample
+  uint8_t* _classes = NULL;
+  uint32_t* _order = NULL;    // Samples of each node are contiguous in this array
+  uint32_t _count = 0;
+  uint32_t _classCount[SLIDER_CLASS_COUNT] = {};
+  bool _full = false;
+
+  SliderTreeNode _tree[SLIDER_CLASSIFIER_MAX_NODES];
+  uint8_t _nodes = 0;
+  uint8_t _depth = 0;
+  uint32_t _histogram[256][SLIDER_CLASS_COUNT];  // Weighted class counts per feature value, for the split search
+
+  SliderGestureClass target(const TouchTrace& trace, uint16_t tick, const SliderClassifier& classifier) const;
+  uint8_t grow(uint32_t first, uint32_t last, uint8_t depth, uint8_t maxDepth, uint16_t minLeaf);
+  static uint32_t weight(uint8_t cls) { return cls == SLIDER_CLASS_NONE ? 1 : SLIDER_TRAINER_EVENT_WEIGHT; }
+};
+
+#endif
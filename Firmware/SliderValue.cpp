@@ -0,0 +1,209 @@
+#include "SliderValue.h"
+
+/**
+ * @brief Create a value controller.
+ *
+ * @param minimum Lowest value.
+ * @param maximum Highest value.
+ * @param step Movement of one slow swipe in relative mode.
+ */
+SliderValue::SliderValue(int32_t minimum, int32_t maximum, int32_t step) {
+  setRange(minimum, maximum);
+  setStep(step);
+  _value = _minimum;
+}
+
+/**
+ * @brief Drive the value from the events of a slider.
+ *
+ * Uses two subscriptions of the slider in absolute mode (press, release) and four in relative mode (swipes).
+ *
+ * @param slider Slider to listen to.
+ * @return false if the handler table of the slider has no room for all of them (none is kept then).
+ */
+bool SliderValue::attach(TouchSlider& slider) {
+  detach();
+  _slider = &slider;
+  subscribe();
+  uint8_t needed = _mode == SLIDER_VALUE_ABSOLUTE ? 2 : 4;
+  for (uint8_t i = 0; i < needed; i++) {
+    if (_ids[i] < 0) {
+      log_e("No room for %u slider handlers", needed);
+      detach();  // A controller missing some of its events would be worse than none
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Stop listening to the slider.
+ */
+void SliderValue::detach() {
+  for (uint8_t i = 0; i < sizeof(_ids); i++) {
+    if (_slider != NULL && _ids[i] >= 0) {
+      _slider->unsubscribe(_ids[i]);
+    }
+    _ids[i] = -1;
+  }
+  _slider = NULL;
+}
+
+/**
+ * @brief Select how the touches move the value.
+ */
+void SliderValue::setMode(SliderValueMode mode) {
+  _mode = mode;
+  if (_slider != NULL) {
+    TouchSlider* slider = _slider;
+    attach(*slider);  // Subscribe to the events of the new mode
+  }
+}
+
+/**
+ * @brief Set the range, the value is clamped into it.
+ */
+void SliderValue::setRange(int32_t minimum, int32_t maximum) {
+  _minimum = minimum < maximum ? minimum : maximum;
+  _maximum = minimum < maximum ? maximum : minimum;
+  set(_value);
+}
+
+/**
+ * @brief Set the acceleration curve of the relative mode.
+ *
+ * The gain grows linearly from 1 (swipes slowMs or more apart, or a change of direction) to maxGain (swipes fastMs
+ * or less apart).
+ *
+ * @param slowMs Interval between swipes below which the acceleration starts.
+ * @param fastMs Interval between swipes at which the gain is maximum.
+ * @param maxGain Steps per swipe at full speed (1 = no acceleration).
+ */
+void SliderValue::setAcceleration(uint16_t slowMs, uint16_t fastMs, uint8_t maxGain) {
+  _slowMs = slowMs;
+  _fastMs = fastMs < slowMs ? fastMs : slowMs;
+  _maxGain = maxGain > 0 ? maxGain : 1;
+}
+
+/**
+ * @brief Set the value, clamped and snapped.
+ */
+void SliderValue::set(int32_t value) {
+  value = snap(constrain(value, _minimum, _maximum));
+  if (value == _value) {
+    return;
+  }
+  _value = value;
+  _changed = true;
+  if (_handler != NULL) {
+    _handler(value, _context);
+  }
+}
+
+void SliderValue::subscribe() {
+  if (_mode == SLIDER_VALUE_ABSOLUTE) {
+    _ids[0] = _slider->subscribe(SLIDER_EVENT_PRESS, handleEvent, this);
+    _ids[1] = _slider->subscribe(SLIDER_EVENT_RELEASE, handleEvent, this);
+  } else {
+    _lastSwipe = SLIDER_EVENT_COUNT;
+    _ids[0] = _slider->subscribe(SLIDER_EVENT_SWIPE_UP, handleEvent, this);
+    _ids[1] = _slider->subscribe(SLIDER_EVENT_SWIPE_DOWN, handleEvent, this);
+    _ids[2] = _slider->subscribe(SLIDER_EVENT_SWIPE_FINE_UP, handleEvent, this);
+    _ids[3] = _slider->subscribe(SLIDER_EVENT_SWIPE_FINE_DOWN, handleEvent, this);
+  }
+}
+
+/**
+ * @brief Absolute mode: move the value to the center of the touched pads.
+ *
+ * The first pad is the minimum and the last pad the maximum (the opposite if inverted). A release that leaves no pad
+ * touched keeps the value.
+ */
+void SliderValue::onPads(const TouchSliderEvent& event) {
+  uint8_t mask = event.padMask & ((1 << _pads) - 1);
+  if (mask == 0) {
+    return;
+  }
+
+  uint8_t first = __builtin_ctz(mask);
+  uint8_t last = 31 - __builtin_clz(mask);
+  int32_t halfPads = first + last;  // Center of the touched pads, in half pads
+  if (_inverted) {
+    halfPads = 2 * (_pads - 1) - halfPads;
+  }
+  set(_minimum + (int64_t)(_maximum - _minimum) * halfPads / (2 * (_pads - 1)));
+}
+
+/**
+ * @brief Relative mode: step the value, or jump to a limit on a swipe fine.
+ *
+ * Swiping down (towards the last pad) increases the value, as a positive TouchSlider::getSwipeStatus(), and holding
+ * the last pad (swipe fine up) jumps to the maximum. Inverted, both go the other way.
+ */
+void SliderValue::onSwipe(const TouchSliderEvent& event) {
+  int32_t delta = 0;
+  if (event.type == SLIDER_EVENT_SWIPE_DOWN || event.type == SLIDER_EVENT_SWIPE_UP) {
+    delta = _step * gain(event);
+    if (delta < _detent) {
+      delta = _detent;  // Always reach the next detent
+    }
+  }
+  if (_inverted) {
+    delta = -delta;
+  }
+
+  switch (event.type) {
+    case SLIDER_EVENT_SWIPE_DOWN:
+      set(_value + delta);
+      break;
+    case SLIDER_EVENT_SWIPE_UP:
+      set(_value - delta);
+      break;
+    case SLIDER_EVENT_SWIPE_FINE_UP:
+      set(_inverted ? _minimum : _maximum);
+      break;
+    case SLIDER_EVENT_SWIPE_FINE_DOWN:
+      set(_inverted ? _maximum : _minimum);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Steps for a swipe, from the time since the previous swipe in the same direction.
+ */
+uint8_t SliderValue::gain(const TouchSliderEvent& event) {
+  uint32_t interval = event.timestamp - _lastSwipeTime;
+  bool sameDirection = event.type == _lastSwipe;
+  _lastSwipe = event.type;
+  _lastSwipeTime = event.timestamp;
+
+  if (!sameDirection || interval >= _slowMs || _maxGain == 1) {
+    return 1;
+  }
+  if (interval <= _fastMs) {
+    return _maxGain;
+  }
+  return 1 + (uint32_t)(_maxGain - 1) * (_slowMs - interval) / (_slowMs - _fastMs);
+}
+
+/**
+ * @brief Round to the nearest detent, staying in the range.
+ */
+int32_t SliderValue::snap(int32_t value) const {
+  if (_detent == 0) {
+    return value;
+  }
+  int32_t offset = (value - _minimum + _detent / 2) / _detent * _detent;
+  return _minimum + offset > _maximum ? _maximum : _minimum + offset;
+}
+
+void SliderValue::handleEvent(const TouchSliderEvent& event, void* context) {
+  SliderValue* self = (SliderValue*)context;
+  if (event.type == SLIDER_EVENT_PRESS || event.type == SLIDER_EVENT_RELEASE) {
+    self->onPads(event);
+  } else {
+    self->onSwipe(event);
+  }
+}
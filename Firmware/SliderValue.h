@@ -0,0 +1,93 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef SLIDERVALUE_H
+#define SLIDERVALUE_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+#include <atomic>
+
+#include "TouchSlider.h"
+
+/*********************** LIBRARY OPTIONS **********************/
+#define SLIDER_VALUE_SLOW_MS 200   // Swipes further apart than this move the value by one step
+#define SLIDER_VALUE_FAST_MS 50    // Swipes this close or closer move the value by the maximum gain
+#define SLIDER_VALUE_MAX_GAIN 4    // Steps per swipe at full speed
+
+/*********************** LIBRARY OPTIONS **********************/
+
+// How the touches move the value
+enum SliderValueMode : uint8_t {
+  SLIDER_VALUE_ABSOLUTE,  // The value follows the touched position: tap to set, drag to adjust
+  SLIDER_VALUE_RELATIVE,  // Swipes step the value (faster swipes by more), holding an end jumps to its limit
+};
+
+typedef void (*SliderValueHandler)(int32_t value, void* context);
+
+/**
+ * @brief Value in a range, driven by the events of a TouchSlider.
+ *
+ * The value is updated from the event handlers, so the application only reads it (or gets a change callback)
+ * instead of polling the swipe counters. It is always clamped to the range and snapped to the detents.
+ */
+class SliderValue {
+ public:
+  SliderValue(int32_t minimum = 0, int32_t maximum = 100, int32_t step = 5);
+
+  bool attach(TouchSlider& slider);
+  void detach();
+
+  void setMode(SliderValueMode mode);
+  SliderValueMode getMode() const { return _mode; }
+  void setRange(int32_t minimum, int32_t maximum);
+  void setStep(int32_t step) { _step = step > 0 ? step : 1; }   // Relative mode: movement of one slow swipe
+  void setDetent(int32_t detent) { _detent = detent > 0 ? detent : 0; set(_value); }  // Snap to minimum + n * detent (0 = off)
+  void setAcceleration(uint16_t slowMs, uint16_t fastMs, uint8_t maxGain);
+  void setPads(uint8_t pads) { _pads = pads > 1 ? pads : 2; }  // Pads along the slider, for the absolute mode
+  void setInverted(bool inverted) { _inverted = inverted; }      // The first pad is the maximum end instead of the last
+  bool isInverted() const { return _inverted; }
+  void setChangeHandler(SliderValueHandler handler, void* context = NULL) { _context = context; _handler = handler; }
+
+  void set(int32_t value);
+  int32_t getValue() const { return _value; }
+  bool hasChanged() { return _changed.exchange(false); }  // true once after any change (safe against the Ticker)
+  uint8_t getPercent() const { return _maximum > _minimum ? (int64_t)(_value - _minimum) * 100 / (_maximum - _minimum) : 0; }
+
+ private:
+  TouchSlider* _slider = NULL;
+  int8_t _ids[4] = {-1, -1, -1, -1};  // Subscriptions
+
+  SliderValueMode _mode = SLIDER_VALUE_ABSOLUTE;
+  int32_t _minimum;
+  int32_t _maximum;
+  int32_t _step = 1;
+  int32_t _detent = 0;
+  uint8_t _pads = TOUCH_PAD_CAP1208;
+  bool _inverted = false;
+
+  uint16_t _slowMs = SLIDER_VALUE_SLOW_MS;
+  uint16_t _fastMs = SLIDER_VALUE_FAST_MS;
+  uint8_t _maxGain = SLIDER_VALUE_MAX_GAIN;
+  uint8_t _lastSwipe = SLIDER_EVENT_COUNT;  // Type of the previous swipe, for the acceleration
+  uint32_t _lastSwipeTime = 0;
+
+  volatile int32_t _value = 0;
+  std::atomic<bool> _changed{false};  // Set by the handlers, cleared by hasChanged() in the application task
+  SliderValueHandler _handler = NULL;
+  void* _context = NULL;
+
+  void subscribe();
+  void onPads(const TouchSliderEvent& event);
+  void onSwipe(const TouchSliderEvent& event);
+  uint8_t gain(const TouchSliderEvent& event);
+  int32_t snap(int32_t value) const;
+
+  static void handleEvent(const TouchSliderEvent& event, void* context);
+};
+
+#endif
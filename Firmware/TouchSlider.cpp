@@ -1,6 +1,10 @@
 #include "TouchSlider.h"
 
-int16_t TouchSlider::_sliderValue[TOUCH_PAD_MAX];
+// RAM of one slider with the components selected in TouchSlider.h (the budget is for the 32-bit ESP32 layout, without
+// the TOUCHSLIDER_STATS histograms)
+#if UINTPTR_MAX == 0xFFFFFFFF && !defined(TOUCHSLIDER_STATS)
+static_assert(sizeof(TouchSlider) <= TOUCHSLIDER_RAM_BUDGET, "TouchSlider exceeds TOUCHSLIDER_RAM_BUDGET");
+#endif
 
 /**
  * @brief Constructor for the TouchSlider class.
@@ -32,9 +36,12 @@ void TouchSlider::start() {
  */
 void TouchSlider::begin() {
   log_i("Initializing touch slider...");
+  if (!CAP1208_Sensor->saveConfig()) {
+    log_w("CAP1208 configuration not saved, chip resets will not be repaired");
+  }
   _sliderRunning = true;  // Mark that the slider is running
 
-  sliderTicker.attach_ms(UPDATE_INTERVAL, update, this);    // Attach a timer interrupt to periodicall
+  sliderTicker.attach_ms(_updateInterval, update, this);    // Attach a timer interrupt to periodicall
   // Attach a timer interrupt to periodically update the slider
   log_i("Touch slider initialized!");
 }
@@ -58,7 +65,7 @@ void TouchSlider::stop() {
  */
 void TouchSlider::resume() {
   if (!_sliderRunning) {
-    sliderTicker.attach_ms(UPDATE_INTERVAL, update, this);  // Restart the timer if it is not running
+    sliderTicker.attach_ms(_updateInterval, update, this);  // Restart the timer if it is not running
     _sliderRunning = true;  // Mark that the timer is running
   }
 }
@@ -93,11 +100,14 @@ void TouchSlider::setDefaultConfiguration()
  *   - 0 indicates no swipe.
  */
 int8_t TouchSlider::getSwipeStatus() {
-  int8_t swipeStatus = _swipeDownCount - _swipeUpCount;   // Calculate the swipe status as the difference between swipe-down and swipe-up counts
+  TouchSliderSnapshot now;
+  _snapshot.read(now);
+  // Swipes since the last call, the counters of the update are never reset so a swipe cannot be lost in between.
+  // _consumed is not shared safely: call the get...Status() functions from one task, other tasks use getSnapshot()
+  int8_t swipeStatus = (uint16_t)(now.swipeDown - _consumed.swipeDown) - (uint16_t)(now.swipeUp - _consumed.swipeUp);
 
-  // Reset the swipe counts after retrieving the swipe status
-  _swipeUpCount = 0;
-  _swipeDownCount = 0;
+  _consumed.swipeUp = now.swipeUp;
+  _consumed.swipeDown = now.swipeDown;
   return swipeStatus;
 }
 
@@ -113,37 +123,249 @@ int8_t TouchSlider::getSwipeStatus() {
  *   - 0 indicates no swipe.
  */
 int8_t TouchSlider::getSwipeStatusFine() {
-  int8_t swipeFineStatus = _swipeFineDownCount - _swipeFineUpCount;   // Calculate the swipe status as the difference between swipe-down and swipe-up counts
-
-  // Reset the swipe counts after retrieving the swipe status
-  _swipeFineUpCount = 0;
-  _swipeFineDownCount = 0;
+  TouchSliderSnapshot now;
+  _snapshot.read(now);
+  int8_t swipeFineStatus = (uint16_t)(now.swipeFineDown - _consumed.swipeFineDown) -
+                           (uint16_t)(now.swipeFineUp - _consumed.swipeFineUp);
 
+  _consumed.swipeFineUp = now.swipeFineUp;
+  _consumed.swipeFineDown = now.swipeFineDown;
   return swipeFineStatus;
 }
 
+/**
+ * @brief Get the pinch status of the TouchSlider (multi-touch).
+ *
+ * @return Spread steps minus pinch steps since the last call: positive when the two fingers moved apart, negative
+ *         when they moved together.
+ */
+int8_t TouchSlider::getPinchStatus() {
+  TouchSliderSnapshot now;
+  _snapshot.read(now);
+  int8_t pinchStatus = (uint16_t)(now.spread - _consumed.spread) - (uint16_t)(now.pinch - _consumed.pinch);
+
+  _consumed.pinch = now.pinch;
+  _consumed.spread = now.spread;
+  return pinchStatus;
+}
+
+/**
+ * @brief Get the two-finger scroll status of the TouchSlider (multi-touch).
+ *
+ * @return Scroll steps towards the last pad minus steps towards the first pad since the last call (same sign as
+ *         getSwipeStatus()).
+ */
+int8_t TouchSlider::getScrollStatus() {
+  TouchSliderSnapshot now;
+  _snapshot.read(now);
+  int8_t scrollStatus = (uint16_t)(now.scrollDown - _consumed.scrollDown) - (uint16_t)(now.scrollUp - _consumed.scrollUp);
+
+  _consumed.scrollUp = now.scrollUp;
+  _consumed.scrollDown = now.scrollDown;
+  return scrollStatus;
+}
+
 
 /**
  * @brief  Update the touch pads states
  *        This method is called periodically by a ticker
  */
 void TouchSlider::update(TouchSlider* self) {
-  self->CAP1208_Sensor->getTouchData(self->_SliderTouched);
+  uint32_t timestamp = micros();
+  SLIDER_STATS_STAMP(i2cStart);
+  if (!self->readFrame(millis())) {
+    return;  // Frame held: no analysis, no snapshot (readers see a skipped frame)
+  }
+  if (!self->_padEvents) {
+    self->readLiveEdge();  // The pad events give the live inputs
+  }
+  self->_deltasValid = self->_enableMultiTouch && self->_multiTouchDeltas;
+  if (self->_deltasValid) {
+    self->CAP1208_Sensor->getDeltaCounts(self->_deltas);  // Separates two fingers on neighbouring pads
+  }
+  SLIDER_STATS_STAMP(i2cFinish);
   // self->printSliderTouched();
 
+  processTouchData(self, !self->_padEvents);
+
+#ifdef TOUCHSLIDER_WITH_DIAGNOSTICS
+  if (self->_recorder != NULL) {
+    self->recordFrame(millis());
+  }
+  if (self->_telemetry != NULL) {
+    self->sendTelemetry(timestamp);
+  }
+  if (self->_drift != NULL) {
+    self->sampleDrift(millis());
+  }
+#else
+  (void)timestamp;
+#endif
+  if (self->_autoProfiles) {
+    self->switchProfile(millis());
+  }
+  self->publishSnapshot();
+  self->_frameEvents = 0;
+
+#ifdef TOUCHSLIDER_STATS
+  uint32_t recordStart = ESP.getCycleCount();
+  self->_stageStats[SLIDER_STAGE_I2C].record(i2cFinish - i2cStart);
+  self->_stageStats[SLIDER_STAGE_TOTAL].record(recordStart - i2cStart);
+  uint32_t end = ESP.getCycleCount();
+  self->_statsCycles += end - recordStart;
+  self->_updateCycles += end - i2cStart;
+#endif
+}
+
+/**
+ * @brief Read the pad states of an update, holding the previous frame while the reads fail.
+ *
+ * A failed read used to look like a release and aborted the gesture in progress. Now the last good frame is held
+ * for TOUCHSLIDER_HOLD_FRAMES updates: a short fault delays the gesture by its length instead. When the reads keep
+ * failing, the touch is released so a dead sensor does not hold a pad forever. The chip is checked for a reset
+ * every TOUCHSLIDER_CONFIG_CHECK_MS and after every fault (a brown-out both breaks the bus and resets the chip).
+ *
+ * @param now millis() of the update.
+ * @return true if the frame was read and must be analyzed.
+ */
+bool TouchSlider::readFrame(uint32_t now) {
+  if (!(_padEvents ? readPadFrame() : CAP1208_Sensor->getTouchData(_SliderTouched))) {
+    _health.failedReads++;
+    if (_failedReads == 0) {
+      _faultStartMs = now;
+    }
+    if (_failedReads < 0xFF) {
+      _failedReads++;
+    }
+    if (_failedReads != TOUCHSLIDER_HOLD_FRAMES) {
+      return false;
+    }
+    if (_health.faultReleases < 0xFFFF) {
+      _health.faultReleases++;
+    }
+    memset(_SliderTouched, 0, sizeof(_SliderTouched));  // Give up holding, analyze one released frame
+    _liveMask = 0;
+    return true;
+  }
+
+  bool check = TOUCHSLIDER_CONFIG_CHECK_MS != 0 && now - _configCheckMs >= TOUCHSLIDER_CONFIG_CHECK_MS;
+  if (_failedReads != 0) {
+    uint32_t recovery = now - _faultStartMs;
+    _health.lastRecoveryMs = recovery < 0xFFFF ? recovery : 0xFFFF;
+    _health.maxRecoveryMs = max(_health.maxRecoveryMs, _health.lastRecoveryMs);
+    _failedReads = 0;
+    check = true;
+  }
+  if (check) {
+    _configCheckMs = now;
+    CAP1208_Sensor->checkConfig();
+  }
+  return true;
+}
+
+/**
+ * @brief Read the pad states and the pad events decoded by the CAP1208 (see CAP1208::readPadEvents()).
+ *
+ * The press, repeat and release events are published in the order of the chip, before the gesture analysis. While
+ * the ALERT pin (if wired) is not asserted nothing changed: the frame is the pads held at the previous read and the
+ * bus is not used.
+ *
+ * @return false if the read failed.
+ */
+bool TouchSlider::readPadFrame() {
+  uint8_t mask = _liveMask;
+  if (_alertPin < 0 || _failedReads != 0 || digitalRead(_alertPin) == LOW) {  // Read after a fault, INT may be gone
+    CAP1208_PadFrame frame;
+    if (!CAP1208_Sensor->readPadEvents(frame)) {
+      return false;
+    }
+    mask = frame.latched;
+    _liveMask = frame.live;
+    _padMask = frame.latched;  // Pads of the events
+    static const TouchSliderEventType types[] = {SLIDER_EVENT_PRESS, SLIDER_EVENT_REPEAT, SLIDER_EVENT_RELEASE};
+    for (uint8_t i = 0; i < frame.count; i++) {
+      const CAP1208_PadEvent& event = frame.events[i];
+      if (event.pad < _numSliderPins && _events.isSubscribed(types[event.type])) {
+        publish(types[event.type], event.pad);
+      }
+    }
+  }
+  for (uint8_t i = 0; i < _numSliderPins; ++i) {
+    _SliderTouched[i] = (mask >> i) & 0x01;
+  }
+  return true;
+}
+
+/**
+ * @brief Feed one frame of pad states to the gesture analysis.
+ *
+ * This function runs the same analysis as the periodic update but takes the pad states from the caller instead of the
+ * CAP1208, so recorded or synthetic traces can be replayed. Do not call it while the slider timer is running.
+ *
+ * @param padMask Touched pads, bit 0 is the first pad (same layout as the CAP1208 SENSOR_INPUTS register).
+ * @param deltas Delta counts of the pads (first pad first), used by the multi-touch segmentation, or NULL.
+ */
+void TouchSlider::processFrame(uint8_t padMask, const int8_t* deltas) {
+  for (uint8_t i = 0; i < _numSliderPins; ++i) {
+    _SliderTouched[i] = (padMask >> i) & 0x01;
+  }
+  _deltasValid = deltas != NULL;
+  if (_deltasValid) {
+    memcpy(_deltas, deltas, sizeof(_deltas));
+  }
+  _liveMask = padMask;  // A trace has no live reading, its taps end on the next frame
+  processTouchData(this, true);
+  publishSnapshot();
+  _frameEvents = 0;
+}
+
+/**
+ * @brief Decode the pad states and run the gesture analysis on them.
+ *
+ * @param self Pointer to the TouchSlider instance.
+ * @param padChanges Publish the press and release events of the pads that changed (false when the CAP1208 gave them).
+ */
+void TouchSlider::processTouchData(TouchSlider* self, bool padChanges) {
+  SLIDER_STATS_STAMP(decodeStart);
   bool padTouchedFound = false;
   int8_t firstTouchedIndex = -1;
   int8_t lastTouchedIndex = -1;
   uint8_t touchedPadCount = 0;
+  uint8_t padMask = 0;
 
   // Check touch status and count touched pads
-  checkSliderStatus(self, padTouchedFound, firstTouchedIndex, lastTouchedIndex, touchedPadCount);
+  checkSliderStatus(self, padTouchedFound, firstTouchedIndex, lastTouchedIndex, touchedPadCount, padMask);
+  SLIDER_STATS_STAMP(decoded);
 
-  if (!padTouchedFound) { // Handle the cases when no pad is touched
+  if (padChanges) {
+    publishPadChanges(self, padMask);  // Press and release events
+  } else {
+    self->_padMask = padMask;
+  }
+
+  // The enable flags stay false when their component is left out of the build (see LIBRARY OPTIONS)
+  if (self->_enableMultiTouch && handleContacts(self, padMask, firstTouchedIndex, lastTouchedIndex, touchedPadCount)) {
+    // Two or more contacts, handled as two-finger gestures
+  } else if (self->_enableClassifier) {  // Gestures decided by the trained model
+    handleClassified(self, padMask);
+  } else if (self->_enableTracker) {  // Gestures on the filtered position
+    handleTracked(self, padTouchedFound, firstTouchedIndex, lastTouchedIndex, touchedPadCount);
+  } else if (!padTouchedFound) { // Handle the cases when no pad is touched
     handleNoTouch(self);
   } else {  // Handle the case when at least one pad is touched
     handleTouch(self, firstTouchedIndex, lastTouchedIndex, touchedPadCount);
   }
+
+#ifdef TOUCHSLIDER_STATS
+  uint32_t finished = ESP.getCycleCount();
+  self->_stageStats[SLIDER_STAGE_DECODE].record(decoded - decodeStart);
+  self->_stageStats[SLIDER_STAGE_GESTURE].record(finished - decoded - self->_publishCycles);
+  if (self->_publishCycles != 0) {
+    self->_stageStats[SLIDER_STAGE_PUBLISH].record(self->_publishCycles);
+    self->_publishCycles = 0;
+  }
+  self->_statsCycles += ESP.getCycleCount() - finished;
+#endif
 }
 
 /**
@@ -154,13 +376,15 @@ void TouchSlider::update(TouchSlider* self) {
  * @param firstTouchedIndex Index of the first touched pad.
  * @param lastTouchedIndex Index of the last touched pad.
  * @param touchedPadCount Count of touched pads.
+ * @param padMask Touched pads as a bit mask (bit 0 = first pad).
  */
 void TouchSlider::checkSliderStatus(TouchSlider* self, bool& padTouchedFound, int8_t& firstTouchedIndex,
-                                   int8_t& lastTouchedIndex, uint8_t& touchedPadCount) {
+                                   int8_t& lastTouchedIndex, uint8_t& touchedPadCount, uint8_t& padMask) {
 
   for (uint8_t i = 0; i < self->_numSliderPins; ++i) {
     if (self->_SliderTouched[i]) {
     touchedPadCount++; // Increment the touched pad count if this pad is touched
+    padMask |= 1 << i;
     }
   }
   
@@ -176,6 +400,29 @@ void TouchSlider::checkSliderStatus(TouchSlider* self, bool& padTouchedFound, in
   }
 }
 
+/**
+ * @brief Publish the press and release events of the pads that changed since the last frame.
+ *
+ * @param self Pointer to the TouchSlider instance.
+ * @param padMask Touched pads in this frame.
+ */
+void TouchSlider::publishPadChanges(TouchSlider* self, uint8_t padMask) {
+  uint8_t pressed = padMask & ~self->_padMask;
+  uint8_t released = self->_padMask & ~padMask;
+  self->_padMask = padMask;
+
+  if (self->_events.isSubscribed(SLIDER_EVENT_PRESS)) {
+    for (; pressed != 0; pressed &= pressed - 1) {
+      self->publish(SLIDER_EVENT_PRESS, __builtin_ctz(pressed));
+    }
+  }
+  if (self->_events.isSubscribed(SLIDER_EVENT_RELEASE)) {
+    for (; released != 0; released &= released - 1) {
+      self->publish(SLIDER_EVENT_RELEASE, __builtin_ctz(released));
+    }
+  }
+}
+
 /**
  * @brief Handle cases when no pad is touched.
  *
@@ -188,15 +435,13 @@ void TouchSlider::handleNoTouch(TouchSlider* self) {
   self->_actualValue = 0;
   self->firstTouch = true;
 
-  if(self->_enableSwipeFine) {    // Check if that functionality Swipe Fine is active 
+  if(self->_enableSwipeFine && !self->_fineCommitted) {    // Check if that functionality Swipe Fine is active and not sent yet
     // Increment swipe counts if the first pad touched was top or bottom
     if(self->firstPadTop) {
-      self->_swipeFineUpCount++;
-      if(self->_enablePrintSwipeStatus) LOGIB("SWIPE FINE UP");
+      self->publishSwipeFine(true);
     }
     if(self->firstPadBot) {
-      self->_swipeFineDownCount++;
-      if(self->_enablePrintSwipeStatus) LOGIR("SWIPE FINE DOWN");
+      self->publishSwipeFine(false);
     }
   }
   
@@ -213,17 +458,7 @@ void TouchSlider::handleNoTouch(TouchSlider* self) {
  */
 void TouchSlider::handleTouch(TouchSlider* self, int8_t firstTouchedIndex, int8_t lastTouchedIndex, uint8_t touchedPadCount) {
   if(self->firstTouch == true) {  // Check if this is the first entry into this condition block
-  if(self->_enablePrintSliderTouched) self->printSliderTouched();       // Check if _enablePrintSliderTouched is true for a Print SliderTouched[] 
-    if(touchedPadCount == 1) {    // Check if only one pad is touched
-      if (self->_SliderTouched[0] == true) {  
-        self->firstPadBot = true;
-        if(self->_enablePrintSwipeStatus) LOGIR("FIRST TOUCH BOT");
-      }
-      if(self->_SliderTouched[self->_numSliderPins - 1] == true) {
-        self->firstPadTop = true;
-        if(self->_enablePrintSwipeStatus) LOGIB("FIRST TOUCH TOP");
-      }
-    }
+    checkFirstTouch(self, touchedPadCount);
   }
 
   // Calculate slider values based on touched pads
@@ -237,7 +472,247 @@ void TouchSlider::handleTouch(TouchSlider* self, int8_t firstTouchedIndex, int8_
     }
   }
   self->analyzeGesture(self->_numSliderPins);   // Analyze the gesture based on the slider values
+  checkEdgeHold(self, touchedPadCount);         // Swipe fine without waiting for the release
+  self->firstTouch = false;
+}
+
+/**
+ * @brief Flag a first touch on the top or bottom pad (swipe fine candidates).
+ *
+ * @param self Pointer to the TouchSlider instance.
+ * @param touchedPadCount Count of touched pads.
+ */
+void TouchSlider::checkFirstTouch(TouchSlider* self, uint8_t touchedPadCount) {
+#ifdef TOUCHSLIDER_STATS
+  self->_pressMs = millis();
+#endif
+  if(self->_enablePrintSliderTouched) self->printSliderTouched();       // Check if _enablePrintSliderTouched is true for a Print SliderTouched[] 
+  if(touchedPadCount == 1) {    // Check if only one pad is touched
+    if (self->_SliderTouched[0] == true) {  
+      self->firstPadBot = true;
+      if(self->_enablePrintSwipeStatus) LOGIR("FIRST TOUCH BOT");
+    }
+    if(self->_SliderTouched[self->_numSliderPins - 1] == true) {
+      self->firstPadTop = true;
+      if(self->_enablePrintSwipeStatus) LOGIB("FIRST TOUCH TOP");
+    }
+  }
+}
+
+/**
+ * @brief Send the swipe fine of an edge tap before the release, then auto-repeat it while the edge pad is held.
+ *
+ * The contact must have started on an edge pad and stayed alone on it (a swipe towards the other pads resets the
+ * first touch flags and cancels it). It is unambiguous after _fineDwellFrames more frames, or as soon as the live
+ * reading shows that a latched tap already ended. A held edge pad repeats the swipe fine after _fineRepeatDelayMs,
+ * every _fineRepeatMs.
+ *
+ * @param self Pointer to the TouchSlider instance.
+ * @param touchedPadCount Count of touched pads.
+ */
+void TouchSlider::checkEdgeHold(TouchSlider* self, uint8_t touchedPadCount) {
+  if (!self->_enableSwipeFine || self->_fineDwellFrames == 0 || touchedPadCount != 1) {
+    self->_edgeFrames = 0;
+    return;
+  }
+  uint8_t lastPad = self->_numSliderPins - 1;
+  bool top = self->firstPadTop && self->_SliderTouched[lastPad];
+  bool bot = self->firstPadBot && self->_SliderTouched[0];
+  if (!top && !bot) {
+    self->_edgeFrames = 0;
+    return;
+  }
+
+  if (!self->_fineCommitted) {
+    bool ended = !((self->_liveMask >> (top ? lastPad : 0)) & 0x01);  // Only the latch still reports the tap
+    if (self->_edgeFrames < 255) {
+      self->_edgeFrames++;
+    }
+    if (self->_edgeFrames > self->_fineDwellFrames || ended) {
+      self->publishSwipeFine(top);
+      self->_fineCommitted = true;
+      self->_fineRepeatInMs = self->_fineRepeatDelayMs;
+    }
+    return;
+  }
+
+  if (self->_fineRepeatMs == 0) {
+    return;
+  }
+  if (self->_fineRepeatInMs > self->_updateInterval) {
+    self->_fineRepeatInMs -= self->_updateInterval;
+    return;
+  }
+  self->publish(top ? SLIDER_EVENT_SWIPE_FINE_UP : SLIDER_EVENT_SWIPE_FINE_DOWN, top ? lastPad : 0);
+  uint16_t lateMs = self->_updateInterval - self->_fineRepeatInMs;  // Kept off the next period, the rate stays exact
+  self->_fineRepeatInMs = self->_fineRepeatMs > lateMs ? self->_fineRepeatMs - lateMs : 0;
+}
+
+/**
+ * @brief Read the pads still touched when the frame is a lone edge pad, the start of a possible edge tap.
+ *
+ * The status read by getTouchData() is latched, a tap shorter than the update interval shows in one frame. The second
+ * read tells whether it already ended, so its swipe fine is sent now instead of on the next update.
+ */
+void TouchSlider::readLiveEdge() {
+  _liveMask = 0xFF;
+  if (!_enableSwipeFine || _fineDwellFrames == 0 || _fineCommitted) {
+    return;
+  }
+  uint8_t lastPad = _numSliderPins - 1;
+  for (uint8_t i = 1; i < lastPad; i++) {
+    if (_SliderTouched[i]) {
+      return;
+    }
+  }
+  if (_SliderTouched[0] != _SliderTouched[lastPad]) {  // Exactly one edge pad
+    _liveMask = CAP1208_Sensor->getLiveInputs();
+  }
+}
+
+/**
+ * @brief Publish the swipe fine of a contact (not its repeats) and record its latency.
+ *
+ * @param top true for the last pad (swipe fine up), false for the first pad (swipe fine down).
+ */
+void TouchSlider::publishSwipeFine(bool top) {
+  publish(top ? SLIDER_EVENT_SWIPE_FINE_UP : SLIDER_EVENT_SWIPE_FINE_DOWN, top ? _numSliderPins - 1 : 0);
+#ifdef TOUCHSLIDER_STATS
+  uint32_t start = ESP.getCycleCount();
+  _fineLatency.record(millis() - _pressMs);
+  _statsCycles += ESP.getCycleCount() - start;
+#endif
+}
+
+/**
+ * @brief Handle a frame when the classifier is enabled.
+ *
+ * The classifier decides from a window of frames which event, if any, this frame emits (see SliderClassifier.h).
+ *
+ * @param self Pointer to the TouchSlider instance.
+ * @param padMask Touched pads in this frame.
+ */
+void TouchSlider::handleClassified(TouchSlider* self, uint8_t padMask) {
+#ifdef TOUCHSLIDER_WITH_CLASSIFIER
+  switch (self->_classifier.update(padMask, self->_deltasValid ? self->_deltas : NULL)) {
+    case SLIDER_CLASS_SWIPE_UP:
+      self->publish(SLIDER_EVENT_SWIPE_UP, self->firstPad());
+      break;
+    case SLIDER_CLASS_SWIPE_DOWN:
+      self->publish(SLIDER_EVENT_SWIPE_DOWN, self->firstPad());
+      break;
+    case SLIDER_CLASS_SWIPE_FINE_UP:
+      if (self->_enableSwipeFine) self->publish(SLIDER_EVENT_SWIPE_FINE_UP, self->_numSliderPins - 1);
+      break;
+    case SLIDER_CLASS_SWIPE_FINE_DOWN:
+      if (self->_enableSwipeFine) self->publish(SLIDER_EVENT_SWIPE_FINE_DOWN, 0);
+      break;
+    default:
+      break;
+  }
+#endif
+}
+
+/**
+ * @brief Split the frame into contacts and handle the two-finger gestures.
+ *
+ * With one contact, the first and last touched pads are narrowed to that contact and the single finger analysis runs
+ * as usual. With two or more, the single finger analysis is suspended (no swipe from fingers far apart) and the pair
+ * motion is published as pinch/spread and scroll events.
+ *
+ * @param self Pointer to the TouchSlider instance.
+ * @param padMask Touched pads in this frame.
+ * @param firstTouchedIndex Index of the first touched pad, narrowed to the contact.
+ * @param lastTouchedIndex Index of the last touched pad, narrowed to the contact.
+ * @param touchedPadCount Count of touched pads, narrowed to the contact.
+ * @return true if the frame has two or more contacts and was handled here.
+ */
+bool TouchSlider::handleContacts(TouchSlider* self, uint8_t padMask, int8_t& firstTouchedIndex, int8_t& lastTouchedIndex,
+                                 uint8_t& touchedPadCount) {
+#ifdef TOUCHSLIDER_WITH_MULTITOUCH
+  SliderContacts& contacts = self->_contacts;
+  uint8_t count = contacts.update(padMask, self->_deltasValid ? self->_deltas : NULL, self->_numSliderPins);
+
+  if (count == 1) {
+    const SliderContact& c = contacts.contact(0);
+    firstTouchedIndex = c.first;
+    lastTouchedIndex = c.last;
+    touchedPadCount = __builtin_popcount(padMask & (((1 << (c.last + 1)) - 1) & ~((1 << c.first) - 1)));
+  }
+  if (count < 2) {
+    return false;
+  }
+
+  // Suspend the single finger state, it starts again from a first touch when one finger remains
+  self->firstTouch = true;
+  self->resetFirstTouches();
+#ifdef TOUCHSLIDER_WITH_TRACKER
+  self->_tracker.reset();
+#endif
+
+  uint8_t pad = (contacts.getPairMidpoint() + SLIDER_CONTACTS_ONE_PAD / 2) / SLIDER_CONTACTS_ONE_PAD;
+  for (int8_t steps = contacts.getPinchSteps(); steps != 0; steps += steps > 0 ? -1 : 1) {
+    self->publish(steps > 0 ? SLIDER_EVENT_SPREAD : SLIDER_EVENT_PINCH, pad);
+  }
+  for (int8_t steps = contacts.getScrollSteps(); steps != 0; steps += steps > 0 ? -1 : 1) {
+    self->publish(steps > 0 ? SLIDER_EVENT_SCROLL_DOWN : SLIDER_EVENT_SCROLL_UP, pad);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Handle a frame when the tracker is enabled.
+ *
+ * The finger position (center of the touched pads) goes through the SliderTracker, which bridges missed frames and
+ * rejects outliers. A swipe is emitted each time the filtered position moves SLIDER_TRACKER_SWIPE_STEP away from the
+ * position of the previous swipe: towards the last pad is a swipe down, towards the first pad a swipe up (as in analyzeGesture()).
+ *
+ * @param self Pointer to the TouchSlider instance.
+ * @param padTouchedFound Indicates if any pad is touched.
+ * @param firstTouchedIndex Index of the first touched pad.
+ * @param lastTouchedIndex Index of the last touched pad.
+ * @param touchedPadCount Count of touched pads.
+ */
+void TouchSlider::handleTracked(TouchSlider* self, bool padTouchedFound, int8_t firstTouchedIndex, int8_t lastTouchedIndex,
+                                uint8_t touchedPadCount) {
+#ifdef TOUCHSLIDER_WITH_TRACKER
+  int16_t measurement = (firstTouchedIndex + lastTouchedIndex) * (SLIDER_TRACKER_ONE_PAD / 2);
+  if (!self->_tracker.update(padTouchedFound, measurement)) {
+    handleNoTouch(self);  // The contact ended
+    return;
+  }
+  if (!padTouchedFound) {
+    return;  // Coasting through a missed frame, keep the gesture state
+  }
+
+  if (self->_tracker.isNewContact()) {
+    self->resetFirstTouches();
+    self->firstTouch = true;
+    self->_trackerAnchor = self->_tracker.position();
+  }
+  if (self->firstTouch) {
+    checkFirstTouch(self, touchedPadCount);
+  }
+
+  int16_t moved = self->_tracker.position() - self->_trackerAnchor;
+  while (moved >= SLIDER_TRACKER_SWIPE_STEP) {
+    self->publish(SLIDER_EVENT_SWIPE_DOWN, self->firstPad());
+    self->resetFirstTouches();
+    self->_trackerAnchor += SLIDER_TRACKER_SWIPE_STEP;
+    moved -= SLIDER_TRACKER_SWIPE_STEP;
+  }
+  while (moved <= -SLIDER_TRACKER_SWIPE_STEP) {
+    self->publish(SLIDER_EVENT_SWIPE_UP, self->firstPad());
+    self->resetFirstTouches();
+    self->_trackerAnchor -= SLIDER_TRACKER_SWIPE_STEP;
+    moved += SLIDER_TRACKER_SWIPE_STEP;
+  }
+  checkEdgeHold(self, touchedPadCount);
   self->firstTouch = false;
+#endif
 }
 
 /**
@@ -259,14 +734,12 @@ void TouchSlider::analyzeGesture(uint8_t numSliders) {
     _swipeCount = _actualValue - _lastValue;    // Calculate the swipe count and determine the gesture
     if (_swipeCount > 0) {
       _sliderState = SWIPE_UP;
-      _swipeUpCount++;
+      publish(SLIDER_EVENT_SWIPE_UP, firstPad());
       resetFirstTouches();
-      LOGIR("SWIPE_UP");
     } else if (_swipeCount < 0) {
       _sliderState = SWIPE_DOWN;
-      _swipeDownCount++;
+      publish(SLIDER_EVENT_SWIPE_DOWN, firstPad());
       resetFirstTouches();
-      LOGIB("SWIPE_DOWN");
     } else {
       _sliderState = NO_CHANGE;
     }
@@ -275,12 +748,180 @@ void TouchSlider::analyzeGesture(uint8_t numSliders) {
   }
 }
 
+/**
+ * @brief Publish a detected event.
+ *
+ * This function updates the counters read by getSwipeStatus() and getSwipeStatusFine(), logs the event and
+ * delivers it to the subscribed handlers.
+ *
+ * @param event The event to publish.
+ * @param pad The pad where the event happened.
+ */
+void TouchSlider::publish(TouchSliderEventType event, uint8_t pad) {
+  SLIDER_STATS_STAMP(start);
+  _frameEvents |= 1 << event;
+  switch (event) {
+    case SLIDER_EVENT_SWIPE_UP:
+      _state.swipeUp++;
+      if (_enablePrintSwipeStatus) LOGIR("SWIPE_UP");
+      break;
+    case SLIDER_EVENT_SWIPE_DOWN:
+      _state.swipeDown++;
+      if (_enablePrintSwipeStatus) LOGIB("SWIPE_DOWN");
+      break;
+    case SLIDER_EVENT_SWIPE_FINE_UP:
+      _state.swipeFineUp++;
+      if (_enablePrintSwipeStatus) LOGIB("SWIPE FINE UP");
+      break;
+    case SLIDER_EVENT_SWIPE_FINE_DOWN:
+      _state.swipeFineDown++;
+      if (_enablePrintSwipeStatus) LOGIR("SWIPE FINE DOWN");
+      break;
+    case SLIDER_EVENT_PINCH:
+      _state.pinch++;
+      if (_enablePrintSwipeStatus) LOGIB("PINCH");
+      break;
+    case SLIDER_EVENT_SPREAD:
+      _state.spread++;
+      if (_enablePrintSwipeStatus) LOGIR("SPREAD");
+      break;
+    case SLIDER_EVENT_SCROLL_UP:
+      _state.scrollUp++;
+      if (_enablePrintSwipeStatus) LOGIB("SCROLL UP");
+      break;
+    case SLIDER_EVENT_SCROLL_DOWN:
+      _state.scrollDown++;
+      if (_enablePrintSwipeStatus) LOGIR("SCROLL DOWN");
+      break;
+    default:
+      break;
+  }
+
+  if (_events.isSubscribed(event)) {
+    TouchSliderEvent e = {event, pad, _padMask, (uint32_t)millis()};
+    _events.post(e);
+  }
+#ifdef TOUCHSLIDER_STATS
+  uint32_t end = ESP.getCycleCount();
+  _publishCycles += end - start;
+  _statsCycles += ESP.getCycleCount() - end;
+#endif
+}
+
+#ifdef TOUCHSLIDER_WITH_DIAGNOSTICS
+/**
+ * @brief Send the current frame through the attached telemetry encoder.
+ *
+ * The general status and the delta counts are only read from the CAP1208 for the frames that are sent.
+ *
+ * @param timestamp micros() at the start of the update.
+ */
+void TouchSlider::sendTelemetry(uint32_t timestamp) {
+  if (!_telemetry->isDue()) {
+    _telemetry->skip(_frameEvents);  // Decimated, keep the events for the next frame sent
+    return;
+  }
+
+  SliderTelemetryFrame frame;
+  frame.timestamp = timestamp;
+  frame.padMask = _padMask;
+  frame.status = CAP1208_Sensor->getGeneralStatus();
+  frame.events = _frameEvents;
+  if (_deltasValid) {
+    memcpy(frame.delta, _deltas, sizeof(frame.delta));  // Already read for the contacts
+  } else {
+    CAP1208_Sensor->getDeltaCounts(frame.delta);
+  }
+  _telemetry->send(frame);
+}
+
+/**
+ * @brief Read a drift sample from the CAP1208 if the recorder interval has elapsed.
+ *
+ * @param now millis() of the current update.
+ */
+void TouchSlider::sampleDrift(uint32_t now) {
+  if (!_drift->isDue(now)) {
+    return;
+  }
+
+  SliderDriftSample sample;
+  CAP1208_Sensor->getBaseCounts(sample.base);
+  CAP1208_Sensor->getDeltaCounts(sample.delta);
+  sample.flags[SLIDER_DRIFT_NOISE] = CAP1208_Sensor->getNoiseFlags();
+  sample.flags[SLIDER_DRIFT_CALIBRATION] = CAP1208_Sensor->getCalibrationStatus();
+  sample.flags[SLIDER_DRIFT_BASE_OUT] = CAP1208_Sensor->getBaseCountOutOfLimit();
+  sample.flags[SLIDER_DRIFT_STATUS] = CAP1208_Sensor->getGeneralStatus();
+  _drift->post(sample, now);
+}
+
+/**
+ * @brief Store the current frame in the flight recorder.
+ *
+ * The general status and the delta counts are only read if the recorder captures them and is not frozen. Deltas read
+ * here are reused by the telemetry of the same update.
+ *
+ * @param now millis() of the current update.
+ */
+void TouchSlider::recordFrame(uint32_t now) {
+  if (_recorder->isFrozen()) {
+    return;
+  }
+
+  SliderRecord record;
+  record.time = now;
+  record.mask = _padMask;
+  record.events = _frameEvents;
+  record.status = _recorder->capturesStatus() ? CAP1208_Sensor->getGeneralStatus() & ~SLIDER_RECORDER_DELTAS_VALID : 0;
+  if (!_deltasValid && _recorder->capturesDeltas()) {
+    CAP1208_Sensor->getDeltaCounts(_deltas);
+    _deltasValid = true;
+  }
+  if (_deltasValid) {
+    memcpy(record.delta, _deltas, sizeof(record.delta));
+    record.status |= SLIDER_RECORDER_DELTAS_VALID;
+  } else {
+    memset(record.delta, 0, sizeof(record.delta));
+  }
+  _recorder->record(record);
+}
+#endif
+
+/**
+ * @brief Publish the state of the update that just finished to the readers (see SliderSnapshot.h).
+ */
+void TouchSlider::publishSnapshot() {
+  _state.frame++;
+  _state.timestamp = millis();
+  _state.padMask = _padMask;
+  _state.position = trackedPosition();
+  _snapshot.write(_state);
+}
+
 /**
  * @brief Reset first touch flags.
  */
 void TouchSlider::resetFirstTouches() {
   firstPadBot = false;
   firstPadTop = false;
+  _edgeFrames = 0;
+  _fineCommitted = false;
+  _fineRepeatInMs = 0;
+}
+
+/**
+ * @brief Set when the swipe fine of an edge tap is sent.
+ *
+ * @param dwellFrames Frames the edge pad must stay touched alone after the press, 0 to wait for the release (the
+ *                    default: the swipe fine is then never sent for a contact that turns into a swipe, and there is
+ *                    no auto-repeat).
+ * @param repeatDelayMs Time the edge pad is held after the swipe fine before the auto-repeat starts.
+ * @param repeatMs Auto-repeat period, 0 to disable the auto-repeat.
+ */
+void TouchSlider::setSwipeFineTiming(uint8_t dwellFrames, uint16_t repeatDelayMs, uint16_t repeatMs) {
+  _fineDwellFrames = dwellFrames;
+  _fineRepeatDelayMs = repeatDelayMs;
+  _fineRepeatMs = repeatMs;
 }
 
 
@@ -290,12 +931,15 @@ void TouchSlider::resetFirstTouches() {
  * This function prints the status of the slider touch pads, indicating whether each touch pad is currently touched or not.
  */
 void TouchSlider::printSliderTouched() {
-  String touchedStatus;
+  char touchedStatus[TOUCH_PAD_CAP1208 * 2 + 1];  // " 0" or " 1" per pad
   for (uint8_t i = 0; i < _numSliderPins; i++) {
-    touchedStatus += " " + String(_SliderTouched[i]);
+    touchedStatus[i * 2] = ' ';
+    touchedStatus[i * 2 + 1] = _SliderTouched[i] ? '1' : '0';
   }
+  touchedStatus[_numSliderPins * 2] = '\0';
 
-  log_i("Slider Touched Status: %s", touchedStatus.c_str());
+  log_i("Slider Touched Status:%s", touchedStatus);
+  (void)touchedStatus;  // Unused when the log level leaves log_i out
 }
 
 /**
@@ -307,11 +951,16 @@ void TouchSlider::printSliderTouched() {
  * @param numSliders The number of slider values to print.
  */
 void TouchSlider::printSliderValues(uint8_t numSliders) {
-  String values;
-  for (uint8_t i = 0; i < numSliders; ++i) {
-    values += " " + String(_sliderValue[i]);
+  char values[TOUCH_PAD_CAP1208 * 3 + 1];  // " -1", " 0" or " 1" per pad
+  uint8_t length = 0;
+  for (uint8_t i = 0; i < numSliders && i < TOUCH_PAD_CAP1208; ++i) {
+    values[length++] = ' ';
+    if (_sliderValue[i] < 0) values[length++] = '-';
+    values[length++] = _sliderValue[i] != 0 ? '1' : '0';
   }
-  log_i("Slider values:%s", values.c_str());
+  values[length] = '\0';
+  log_i("Slider values:%s", values);
+  (void)values;  // Unused when the log level leaves log_i out
 }
 
 /**
@@ -324,7 +973,394 @@ void TouchSlider::printSliderValues(uint8_t numSliders) {
  */
 void TouchSlider::getSliderTouched(bool sliderTouched[], uint8_t numSliderPins)
 {
-  for (uint8_t i = 0; i < numSliderPins; ++i) {
-    sliderTouched[i] = _SliderTouched[i];
+  uint8_t padMask = getPadMask();  // One consistent frame, not pads of two updates
+  for (uint8_t i = 0; i < numSliderPins && i < TOUCH_PAD_CAP1208; ++i) {
+    sliderTouched[i] = (padMask >> i) & 0x01;
   }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Get the touched pads of the last update.
+ *
+ * @return Touched pads, bit 0 = first pad.
+ */
+uint8_t TouchSlider::getPadMask() {
+  TouchSliderSnapshot now;
+  _snapshot.read(now);
+  return now.padMask;
+}
+
+/**
+ * @brief Get the filtered finger position.
+ *
+ * @return Position in Q8 pads (0 = first pad, 256 = second pad...), -1 if no contact is tracked or the tracker is disabled.
+ */
+int16_t TouchSlider::getPosition() {
+  TouchSliderSnapshot now;
+  _snapshot.read(now);
+  return now.position;
+}
+
+/**
+ * @brief Filtered finger position of the current update, -1 if not tracked (update context).
+ */
+int16_t TouchSlider::trackedPosition() {
+#ifdef TOUCHSLIDER_WITH_TRACKER
+  if (_enableTracker && _tracker.isTracking()) {
+    return constrain(_tracker.position(), 0, (_numSliderPins - 1) * SLIDER_TRACKER_ONE_PAD);
+  }
+#endif
+  return -1;
+}
+
+/**
+ * @brief Apply an acquisition profile.
+ *
+ * The timer is stopped while the CAP1208 is reconfigured, so no update reads a frame sampled with half of the
+ * settings, then restarted at the poll interval of the profile. Call it from the application, not from a handler.
+ * With setAutoProfiles() the update applies the profiles itself (switchProfile()) and is the only writer of the
+ * profile registers; call disableAutoProfiles() before applying one from the application.
+ *
+ * @param profile Profile to apply, e.g. CAP1208_PROFILES[CAP1208_PROFILE_LOW_NOISE]. It must outlive the slider.
+ * @return false if the CAP1208 could not be configured (the previous profile is kept in use).
+ */
+bool TouchSlider::setProfile(const CAP1208_Profile& profile) {
+  bool running = _sliderRunning;
+  stop();
+  bool applied = CAP1208_Sensor->setProfile(profile);
+  if (applied) {
+    _profile = &profile;
+    _updateInterval = profile.pollMs;
+    log_i("Acquisition profile %s, update every %u ms", profile.name, _updateInterval);
+  } else {
+    log_e("Acquisition profile %s not applied", profile.name);
+  }
+  if (running) {
+    resume();
+  }
+  return applied;
+}
+
+/**
+ * @brief Switch the acquisition profile with the touch.
+ *
+ * The active profile is applied as soon as a pad is touched and the idle one after releaseMs without touch, e.g.
+ * low-latency while touched and low-power otherwise. The switch happens inside the update, between two frames; the
+ * timer keeps the faster poll interval of the two since it cannot be changed from its own callback, so the idle
+ * profile lowers the sampling and the power of the chip but not the poll rate.
+ *
+ * @param idle Profile without touch.
+ * @param active Profile while touched.
+ * @param releaseMs Time without touch before going back to the idle profile.
+ */
+void TouchSlider::setAutoProfiles(const CAP1208_Profile& idle, const CAP1208_Profile& active, uint16_t releaseMs) {
+  _autoProfiles = false;
+  setProfile(idle);
+  setUpdateInterval(min(idle.pollMs, active.pollMs));
+  _idleProfile = &idle;
+  _activeProfile = &active;
+  _profileReleaseMs = releaseMs;
+  _lastTouchMs = millis() - releaseMs;  // Idle until the first touch
+  _autoProfiles = true;
+}
+
+/**
+ * @brief Apply the profile of the touch state, called by the update.
+ *
+ * The burst write and the read-modify-write of CAP1208::setProfile() run here, inside the update: in automatic mode
+ * the update is the only writer of the profile registers, so no other update sees half of a profile.
+ */
+void TouchSlider::switchProfile(uint32_t now) {
+  if (_padMask != 0) {
+    _lastTouchMs = now;
+  }
+  bool idle = _padMask == 0 && now - _lastTouchMs >= _profileReleaseMs;
+  const CAP1208_Profile* wanted = idle ? _idleProfile : _activeProfile;
+  if (wanted != _profile && CAP1208_Sensor->setProfile(*wanted)) {
+    _profile = wanted;
+  }
+}
+
+/**
+ * @brief Change the timer period, restarting it if it runs.
+ */
+void TouchSlider::setUpdateInterval(uint16_t interval) {
+  if (interval == _updateInterval) {
+    return;
+  }
+  bool running = _sliderRunning;
+  stop();
+  _updateInterval = interval;
+  if (running) {
+    resume();
+  }
+}
+
+/**
+ * @brief Take the press, repeat and release events from the CAP1208 instead of the frame differences.
+ *
+ * The chip is programmed to raise INT on every press and release of the slider pads and to repeat a held pad (see
+ * CAP1208::configurePadEvents()). Each update decodes the latched status into ordered events, so a tap shorter than
+ * the update interval gives its press and its release, and a held pad gives SLIDER_EVENT_REPEAT. With the ALERT pin
+ * wired, an update without ALERT does not use the bus at all.
+ *
+ * @param alertPin Input connected to ALERT (open drain, active low), -1 to read the status on every update.
+ * @param holdMs Time a pad is held before it repeats.
+ * @param repeatMs Repeat period.
+ */
+void TouchSlider::enablePadEvents(int8_t alertPin, uint16_t holdMs, uint16_t repeatMs) {
+  bool running = _sliderRunning;
+  stop();
+  uint8_t pads = (1 << _numSliderPins) - 1;
+  CAP1208_Sensor->configurePadEvents(pads, pads, holdMs, repeatMs, true);
+  CAP1208_PadFrame frame = {};
+  CAP1208_Sensor->readPadEvents(frame);  // Start from the pads touched now
+  _liveMask = frame.live;
+  _alertPin = alertPin;
+  if (_alertPin >= 0) {
+    pinMode(_alertPin, INPUT_PULLUP);
+  }
+  _padEvents = true;
+  if (running) {
+    resume();
+  }
+}
+
+/**
+ * @brief Detect the gestures with the trained classifier instead of the heuristics.
+ *
+ * The model of SliderGestureModel.h is used unless setClassifierModel() gave another one. Swipes fine are still only
+ * reported if enableSwipeFine() was called.
+ */
+void TouchSlider::enableClassifier() {
+#ifdef TOUCHSLIDER_WITH_CLASSIFIER
+  bool running = _sliderRunning;
+  stop();
+  _classifier.setPads(_numSliderPins);
+  _classifier.reset();
+  _enableClassifier = true;
+  if (running) {
+    resume();
+  }
+#else
+  log_e("Classifier not built, define TOUCHSLIDER_WITH_CLASSIFIER");
+#endif
+}
+
+/**
+ * @brief Use another classifier model (e.g. one just trained by SliderTrainer).
+ *
+ * @param tree Nodes of the tree, the root first. The table must outlive the slider.
+ * @param nodes Number of nodes.
+ */
+void TouchSlider::setClassifierModel(const SliderTreeNode* tree, uint8_t nodes) {
+#ifdef TOUCHSLIDER_WITH_CLASSIFIER
+  bool running = _sliderRunning;
+  stop();
+  _classifier.setModel(tree, nodes);
+  if (running) {
+    resume();
+  }
+#endif
+}
+
+/**
+ * @brief Enable the multi-touch segmentation.
+ *
+ * The touched pads are split into up to SLIDER_CONTACTS_MAX contacts with stable ids. Two contacts produce pinch,
+ * spread and two-finger scroll events instead of swipes. Configure the CAP1208 for more than one touch
+ * (ConfigureMultiTouch()).
+ *
+ * @param useDeltas Also read the delta counts on every update (one more I2C transaction) to separate two fingers on
+ *                  neighbouring pads.
+ */
+void TouchSlider::enableMultiTouch(bool useDeltas) {
+#ifdef TOUCHSLIDER_WITH_MULTITOUCH
+  bool running = _sliderRunning;
+  stop();
+  _contacts.reset();
+  _multiTouchDeltas = useDeltas;
+  _enableMultiTouch = true;
+  if (running) {
+    resume();
+  }
+#else
+  log_e("Multi-touch not built, define TOUCHSLIDER_WITH_MULTITOUCH");
+#endif
+}
+
+/**
+ * @brief Get the contacts of the last frame.
+ *
+ * @param contacts Array to fill, ordered from the first pad.
+ * @return Number of contacts, 0 if multi-touch is disabled.
+ */
+uint8_t TouchSlider::getContacts(SliderContact contacts[SLIDER_CONTACTS_MAX]) {
+#ifdef TOUCHSLIDER_WITH_MULTITOUCH
+  if (!_enableMultiTouch) {
+    return 0;
+  }
+  uint8_t count = _contacts.count();
+  for (uint8_t i = 0; i < count; i++) {
+    contacts[i] = _contacts.contact(i);
+  }
+  return count;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Detect the swipes on the filtered finger position (see SliderTracker.h).
+ *
+ * The tracker is reset with the timer stopped, the update must not run on a half-reset filter.
+ */
+void TouchSlider::enableTracker() {
+#ifdef TOUCHSLIDER_WITH_TRACKER
+  bool running = _sliderRunning;
+  stop();
+  _tracker.reset();
+  _enableTracker = true;
+  if (running) {
+    resume();
+  }
+#else
+  log_e("Tracker not built, define TOUCHSLIDER_WITH_TRACKER");
+#endif
+}
+
+/**
+ * @brief Stream every update through a telemetry encoder (see SliderTelemetry.h).
+ *
+ * @param telemetry Encoder, NULL to stop streaming.
+ */
+void TouchSlider::attachTelemetry(SliderTelemetry* telemetry) {
+#ifdef TOUCHSLIDER_WITH_DIAGNOSTICS
+  _telemetry = telemetry;
+#else
+  if (telemetry != NULL) log_e("Diagnostics not built, define TOUCHSLIDER_WITH_DIAGNOSTICS");
+#endif
+}
+
+/**
+ * @brief Sample the base counts at the drift recorder interval (see SliderDrift.h).
+ *
+ * @param drift Recorder, NULL to stop sampling.
+ */
+void TouchSlider::attachDriftRecorder(SliderDrift* drift) {
+#ifdef TOUCHSLIDER_WITH_DIAGNOSTICS
+  _drift = drift;
+#else
+  if (drift != NULL) log_e("Diagnostics not built, define TOUCHSLIDER_WITH_DIAGNOSTICS");
+#endif
+}
+
+/**
+ * @brief Record every update in a flight recorder (see SliderRecorder.h).
+ *
+ * @param recorder Recorder, NULL to stop recording.
+ */
+void TouchSlider::attachRecorder(SliderRecorder* recorder) {
+#ifdef TOUCHSLIDER_WITH_DIAGNOSTICS
+  _recorder = recorder;
+#else
+  if (recorder != NULL) log_e("Diagnostics not built, define TOUCHSLIDER_WITH_DIAGNOSTICS");
+#endif
+}
+
+/**
+ * @brief Get the latency statistics of the touch slider.
+ *
+ * @param stats Structure to fill with the cycles spent per update stage and per CAP1208 transaction, and the share
+ *              of the update cycles spent recording them (zeroed if TOUCHSLIDER_STATS is not defined).
+ */
+void TouchSlider::getStats(TouchSliderStats& stats) {
+#ifdef TOUCHSLIDER_STATS
+  for (uint8_t i = 0; i < SLIDER_STAGE_COUNT; i++) {
+    _stageStats[i].summary(stats.stage[i]);
+  }
+  _fineLatency.summary(stats.swipeFineLatency);
+  uint64_t statsCycles = _statsCycles + (CAP1208_Sensor != NULL ? CAP1208_Sensor->getStatsCycles() : 0);
+  stats.overhead = _updateCycles != 0 ? (float)statsCycles / _updateCycles : 0.0f;
+#else
+  memset(&stats, 0, sizeof(stats));
+#endif
+  if (CAP1208_Sensor != NULL) {
+    CAP1208_Sensor->getStats(stats.i2cTransaction);
+  } else {
+    memset(&stats.i2cTransaction, 0, sizeof(stats.i2cTransaction));
+  }
+}
+
+#ifdef TOUCHSLIDER_STATS
+static const char* const STAGE_NAMES[SLIDER_STAGE_COUNT] = {"i2c", "decode", "gesture", "publish", "total"};
+
+/**
+ * @brief Log the summary of a cycle histogram in microseconds.
+ */
+static void printCycles(const char* name, const SliderStageStats& stats, float cyclesPerUs) {
+  log_i("%-7s n=%lu p50=%.1fus p99=%.1fus max=%.1fus", name, (unsigned long)stats.count,
+        stats.p50 / cyclesPerUs, stats.p99 / cyclesPerUs, stats.max / cyclesPerUs);
+}
+#endif
+
+/**
+ * @brief Print a compact dump of the latency statistics.
+ *
+ * One line per stage with the sample count and the p50/p99/max in microseconds, then the overhead of the
+ * instrumentation: the cycles spent recording the histograms (the CAP1208 transactions included) over the cycles of
+ * the updates. The cycle counter reads themselves are single instructions and are not counted.
+ */
+void TouchSlider::printStats() {
+#ifdef TOUCHSLIDER_STATS
+  TouchSliderStats stats;
+  getStats(stats);
+
+  float cyclesPerUs = ESP.getCpuFreqMHz();
+  for (uint8_t i = 0; i < SLIDER_STAGE_COUNT; i++) {
+    printCycles(STAGE_NAMES[i], stats.stage[i], cyclesPerUs);
+  }
+  printCycles("i2c/trx", stats.i2cTransaction, cyclesPerUs);
+  log_i("%-7s n=%lu p50=%lums p99=%lums max=%lums", "fine", (unsigned long)stats.swipeFineLatency.count,
+        (unsigned long)stats.swipeFineLatency.p50, (unsigned long)stats.swipeFineLatency.p99,
+        (unsigned long)stats.swipeFineLatency.max);
+  log_i("%-7s %.2f%% of the update cycles", "stats", 100.0f * stats.overhead);
+#else
+  log_i("Stats disabled, define TOUCHSLIDER_STATS to enable them");
+#endif
+}
+
+/**
+ * @brief Clear the latency statistics.
+ */
+void TouchSlider::resetStats() {
+#ifdef TOUCHSLIDER_STATS
+  for (uint8_t i = 0; i < SLIDER_STAGE_COUNT; i++) {
+    _stageStats[i].reset();
+  }
+  _fineLatency.reset();
+  _updateCycles = 0;
+  _statsCycles = 0;
+#endif
+  if (CAP1208_Sensor != NULL) {
+    CAP1208_Sensor->resetStats();
+  }
+}
+
+/**
+ * @brief Get the recovery counters (bus faults and chip resets).
+ *
+ * @param health Structure to fill.
+ */
+void TouchSlider::getHealth(TouchSliderHealth& health) {
+  health = _health;
+  health.chipResets = CAP1208_Sensor->getChipResets() - _health.chipResets;  // Kept as the count at the last reset
+}
+
+/**
+ * @brief Clear the recovery counters.
+ */
+void TouchSlider::resetHealth() {
+  memset(&_health, 0, sizeof(_health));
+  _health.chipResets = CAP1208_Sensor->getChipResets();
+}
@@ -14,15 +14,60 @@
 
 #include "CAP1208.h"
 #include "Logger.h"
+#include "SliderEvents.h"
+#include "SliderClassifier.h"
+#include "SliderContacts.h"
+#include "SliderRecorder.h"
+#include "SliderSnapshot.h"
+#include "SliderStats.h"
+#include "SliderTelemetry.h"
+#include "SliderDrift.h"
+#include "SliderTracker.h"
 
 /*********************** LIBRARY OPTIONS **********************/
 #define START_WITH_SWIPE_FINE     // Enable swipe fine by default, comment this line to disable
 #define START_PRINT_SWIPE_STATUS  // Print the swipe status by default, comment this line to disable
 // #define START_PRINT_SLIDER_TOUCHED            // Print the slider touched by default, comment this line to disable
 #define TOUCH_PAD_CAP1208 8
+#define SWIPE_FINE_DWELL_FRAMES 0       // Frames the edge pad stays alone after the press before the swipe fine is sent (0 = at the release, no auto-repeat)
+#define SWIPE_FINE_REPEAT_DELAY_MS 500  // Edge pad held this long after the swipe fine starts the auto-repeat
+#define SWIPE_FINE_REPEAT_MS 200        // Auto-repeat period of the swipe fine (0 = no auto-repeat)
+#define TOUCHSLIDER_HOLD_FRAMES 5       // Failed reads in a row during which the last frame is held, then the touch is released
+#define TOUCHSLIDER_CONFIG_CHECK_MS 1000  // Period of the chip reset check (see CAP1208::checkConfig()), 0 = never
+#define TOUCHSLIDER_WITH_TRACKER      // Position filter (enableTracker()), comment this line to leave it out of the build
+#define TOUCHSLIDER_WITH_MULTITOUCH   // Contact segmentation (enableMultiTouch()), comment this line to leave it out of the build
+#define TOUCHSLIDER_WITH_CLASSIFIER   // Trained gesture classifier (enableClassifier()), comment this line to leave it out of the build
+#define TOUCHSLIDER_WITH_DIAGNOSTICS  // Telemetry, drift log and flight recorder hooks, comment this line to leave them out of the build
+#define TOUCHSLIDER_RAM_BUDGET 704    // Largest sizeof(TouchSlider) on the ESP32, checked at compile time (see TouchSlider.cpp)
 
 /*********************** LIBRARY OPTIONS **********************/
 
+// Stages of TouchSlider::update() measured when TOUCHSLIDER_STATS is defined
+enum TouchSliderStage : uint8_t {
+  SLIDER_STAGE_I2C,      // I2C start to I2C finish
+  SLIDER_STAGE_DECODE,   // Pad status decoding
+  SLIDER_STAGE_GESTURE,  // Gesture analysis (without publishing)
+  SLIDER_STAGE_PUBLISH,  // Event publishing (only frames with events)
+  SLIDER_STAGE_TOTAL,    // Whole update
+  SLIDER_STAGE_COUNT
+};
+
+typedef struct {
+  SliderStageStats stage[SLIDER_STAGE_COUNT];  // Cycles per update stage
+  SliderStageStats i2cTransaction;             // Cycles per CAP1208 register transaction
+  SliderStageStats swipeFineLatency;           // Milliseconds from the update that saw the press to the swipe fine
+  float overhead;                              // Cycles spent recording these statistics per update cycle
+} TouchSliderStats;
+
+// Recovery from bus faults and chip resets
+typedef struct {
+  uint32_t failedReads;     // Updates whose touch read failed (the previous frame was held)
+  uint16_t faultReleases;   // Touches released because the reads failed for TOUCHSLIDER_HOLD_FRAMES updates
+  uint16_t chipResets;      // Configuration losses repaired (CAP1208::getChipResets())
+  uint16_t lastRecoveryMs;  // First failed read to the next good one, last fault
+  uint16_t maxRecoveryMs;   // Longest recovery
+} TouchSliderHealth;
+
 class TouchSlider {
  public:
   TouchSlider(CAP1208* sensor);
@@ -32,11 +77,29 @@ class TouchSlider {
 
   int8_t getSwipeStatus();
   int8_t getSwipeStatusFine();
+  int8_t getPinchStatus();   // Spread steps minus pinch steps since the last call (multi-touch)
+  int8_t getScrollStatus();  // Two-finger scroll steps down minus up since the last call (multi-touch)
   void getSliderTouched(bool sliderTouched[], uint8_t numSliderPins);  // Get the SliderTouched
+  void processFrame(uint8_t padMask, const int8_t* deltas = NULL);     // Analyze one frame given by the caller (trace replay)
+  uint8_t getPadMask();                                                // Touched pads in the last update, bit 0 = first pad
+  void getSnapshot(TouchSliderSnapshot& snapshot) { _snapshot.read(snapshot); };  // Consistent state of the last update, from any task and any number of them
 
   //  Enable/Disable functions
   void enableSwipeFine() { _enableSwipeFine = true; };    // Enable swipe fine
   void disableSwipeFine() { _enableSwipeFine = false; };  // Disable swipe fine
+  void setSwipeFineTiming(uint8_t dwellFrames, uint16_t repeatDelayMs = SWIPE_FINE_REPEAT_DELAY_MS,
+                          uint16_t repeatMs = SWIPE_FINE_REPEAT_MS);  // Early commit and auto-repeat of the swipe fine
+  void enableTracker();                                               // Detect swipes on the filtered finger position (see SliderTracker.h)
+  void disableTracker() { _enableTracker = false; };                  // Detect swipes on the raw pad states
+  int16_t getPosition();                                              // Filtered finger position (Q8 pads), -1 if not touched or tracker disabled
+  void enableClassifier();                                            // Detect swipes with the trained classifier (see SliderClassifier.h)
+  void disableClassifier() { _enableClassifier = false; };            // Detect swipes with the heuristics
+  void setClassifierModel(const SliderTreeNode* tree, uint8_t nodes);
+  void enablePadEvents(int8_t alertPin = -1, uint16_t holdMs = 280, uint16_t repeatMs = 175);  // Press, repeat and release from the CAP1208
+  void disablePadEvents() { _padEvents = false; };                    // Press and release from the frame differences
+  void enableMultiTouch(bool useDeltas = false);                      // Split the touch into contacts (see SliderContacts.h), optionally with the delta counts
+  void disableMultiTouch() { _enableMultiTouch = false; };            // Treat every touched pad as one contact
+  uint8_t getContacts(SliderContact contacts[SLIDER_CONTACTS_MAX]);   // Contacts of the last frame, returns their number
 
   // Enable/Disable print functions
   void enablePrintSliderTouched() { _enablePrintSliderTouched = true; };    // Enable print array of pads on slider which were touched
@@ -44,11 +107,49 @@ class TouchSlider {
   void enablePrintSwipeStatus() { _enablePrintSwipeStatus = true; };        // Enable print swipe status (include swipe fine status)
   void disablePrintSwipeStatus() { _enablePrintSwipeStatus = false; };      // Disable print swipe status (include swipe fine status)
 
+  // Acquisition profiles (see CAP1208_Profile)
+  bool setProfile(const CAP1208_Profile& profile);  // Apply to the CAP1208 between two updates and poll at its interval
+  void setAutoProfiles(const CAP1208_Profile& idle, const CAP1208_Profile& active, uint16_t releaseMs = 500);
+  void disableAutoProfiles() { _autoProfiles = false; };               // Keep the current profile
+  const CAP1208_Profile* getProfile() { return _profile; };            // Profile applied now, NULL before the first one
+
+  // Event subscriptions (see SliderEvents.h)
+  int8_t subscribe(TouchSliderEventType type, TouchSliderHandler handler, void* context = NULL, uint8_t padMask = SLIDER_EVENTS_ALL_PADS) {
+    return _events.subscribe(type, handler, context, padMask);
+  };
+  void unsubscribe(int8_t id) { _events.unsubscribe(id); };
+  void setDispatchMode(TouchSliderDispatch mode) { _events.setMode(mode); };  // Run handlers inline (Ticker) or deferred
+  void setDispatchBudget(uint32_t us) { _events.setBudget(us); };            // Report handlers slower than this
+  uint8_t dispatchEvents() { return _events.dispatchPending(); };             // Run deferred handlers, call it from loop()
+  bool getHandlerStats(int8_t id, TouchSliderHandlerStats& stats) { return _events.getHandlerStats(id, stats); };
+  void printDispatchStats() { _events.printStats(); };
+
+  // Binary telemetry (see SliderTelemetry.h)
+  void attachTelemetry(SliderTelemetry* telemetry);  // Stream every update through this encoder
+  void detachTelemetry() { attachTelemetry(NULL); };
+
+  // Baseline drift log (see SliderDrift.h)
+  void attachDriftRecorder(SliderDrift* drift);  // Sample the base counts at the recorder interval
+  void detachDriftRecorder() { attachDriftRecorder(NULL); };
+
+  // Flight recorder of the raw frames (see SliderRecorder.h)
+  void attachRecorder(SliderRecorder* recorder);  // Record every update
+  void detachRecorder() { attachRecorder(NULL); };
+
+  // Instrumentation (needs TOUCHSLIDER_STATS, see SliderStats.h)
+  void getStats(TouchSliderStats& stats);
+  void printStats();
+  void resetStats();
+
+  // Recovery (see TouchSliderHealth)
+  void getHealth(TouchSliderHealth& health);
+  void resetHealth();
+
  private:
   CAP1208* CAP1208_Sensor;
   bool _sliderRunning = false;
 
-  const uint16_t UPDATE_INTERVAL = 50;
+  uint16_t _updateInterval = 50;  // Ticker period, ms (pollMs of the profile)
   enum { NO_CHANGE,
          SWIPE_UP,
          SWIPE_DOWN };
@@ -59,38 +160,117 @@ class TouchSlider {
   uint8_t _sliderState = NO_CHANGE;
   uint8_t _numSliderPins = TOUCH_PAD_CAP1208;
 
-  bool _SliderTouched[TOUCH_PAD_MAX];
-  static int16_t _sliderValue[TOUCH_PAD_MAX];
+  bool _SliderTouched[TOUCH_PAD_CAP1208];
+  int8_t _sliderValue[TOUCH_PAD_CAP1208];  // -1, 0 or 1 per pad, summed by analyzeGesture()
 
   int8_t _swipeCount = 0;
-  int8_t _swipeUpCount = 0;
-  int8_t _swipeDownCount = 0;
 
-  int8_t _swipeFineUpCount = 0;
-  int8_t _swipeFineDownCount = 0;
+  TouchSliderSnapshot _state = {};          // Written by the update only, published at its end
+  SliderSeqlock<TouchSliderSnapshot> _snapshot;
+  TouchSliderSnapshot _consumed = {};       // Counters already returned by the get...Status() functions (one task)
 
   bool firstTouch = true;
   bool firstPadTop = false;
   bool firstPadBot = false;
 
+  uint8_t _fineDwellFrames = SWIPE_FINE_DWELL_FRAMES;
+  uint16_t _fineRepeatDelayMs = SWIPE_FINE_REPEAT_DELAY_MS;
+  uint16_t _fineRepeatMs = SWIPE_FINE_REPEAT_MS;
+  uint8_t _edgeFrames = 0;                 // Frames the first touched edge pad has been touched alone
+  bool _fineCommitted = false;             // The swipe fine of the contact was sent before the release
+  uint16_t _fineRepeatInMs = 0;            // Time left before the next auto-repeat of the swipe fine
+  uint8_t _liveMask = 0;                   // Pads still touched after the latch was cleared (lone edge pad frames only)
+
   bool _enablePrintSwipeStatus = false;    // Indicates whether to print the swipe status
   bool _enablePrintSliderTouched = false;  // Indicates whether to print the Slider Touched
   bool _enableSwipeFine = false;           // Indicates whether to enable Swipe Fine
   bool _enableTouchButtons = false;        // Indicates whether to enable Touch Buttons
+  bool _enableTracker = false;             // Indicates whether swipes are detected on the tracked position
+  bool _enableMultiTouch = false;          // Indicates whether the touch is split into contacts
+  bool _enableClassifier = false;          // Indicates whether the classifier replaces the heuristics
+  bool _multiTouchDeltas = false;          // Indicates whether the contacts use the delta counts
+  bool _padEvents = false;                 // Indicates whether the press, repeat and release events come from the CAP1208
+  int8_t _alertPin = -1;                   // ALERT input (active low), -1 if not wired
+
+  SliderEvents _events;                    // Subscribed handlers
+  uint8_t _padMask = 0;                    // Touched pads in the last frame
+  uint16_t _frameEvents = 0;               // Bit per event type published in the current frame
+#ifdef TOUCHSLIDER_WITH_DIAGNOSTICS
+  SliderTelemetry* _telemetry = NULL;      // Telemetry encoder, NULL if not streaming
+  SliderDrift* _drift = NULL;              // Drift recorder, NULL if not recording
+  SliderRecorder* _recorder = NULL;        // Flight recorder, NULL if not recording
+#endif
+
+#ifdef TOUCHSLIDER_WITH_TRACKER
+  SliderTracker _tracker;                  // Finger position filter
+  int16_t _trackerAnchor = 0;              // Tracked position (Q8) of the last emitted swipe
+#endif
+#ifdef TOUCHSLIDER_WITH_MULTITOUCH
+  SliderContacts _contacts;                // Contact segmentation and tracking
+#endif
+#ifdef TOUCHSLIDER_WITH_CLASSIFIER
+  SliderClassifier _classifier;            // Trained gesture classifier
+#endif
+  int8_t _deltas[TOUCH_PAD_CAP1208];       // Delta counts of the current frame
+  bool _deltasValid = false;               // _deltas was read in the current frame
+
+  const CAP1208_Profile* _profile = NULL;  // Profile applied to the CAP1208
+  const CAP1208_Profile* _idleProfile = NULL;
+  const CAP1208_Profile* _activeProfile = NULL;
+  bool _autoProfiles = false;              // Indicates whether the profile follows the touch
+  uint16_t _profileReleaseMs = 0;          // Time without touch before going back to the idle profile
+  uint32_t _lastTouchMs = 0;               // Last update with a touched pad
+
+  TouchSliderHealth _health = {};
+  uint8_t _failedReads = 0;                // Failed reads in a row
+  uint32_t _faultStartMs = 0;              // millis() of the first of them
+  uint32_t _configCheckMs = 0;             // Last chip reset check
+
+#ifdef TOUCHSLIDER_STATS
+  SliderHistogram _stageStats[SLIDER_STAGE_COUNT];  // Cycles spent per update stage
+  SliderHistogram _fineLatency;                     // Press to swipe fine, milliseconds
+  uint32_t _pressMs = 0;                            // millis() of the update that saw the press
+  uint32_t _publishCycles = 0;                      // Cycles spent publishing during the current update
+  uint64_t _updateCycles = 0;                       // Cycles of the updates since resetStats()
+  uint64_t _statsCycles = 0;                        // Cycles of those spent recording the statistics
+#endif
 
   void begin();
   void setDefaultConfiguration();
   static void update(TouchSlider* self);
-  static void printAllPadTouched();
+  static void processTouchData(TouchSlider* self, bool padChanges);
   void printSliderTouched();
   void analyzeGesture(uint8_t numSliders);
   void printSliderValues(uint8_t numSliders);
 
   static void checkSliderStatus(TouchSlider* self, bool& padTouchedFound, int8_t& firstTouchedIndex,
-                                int8_t& lastTouchedIndex, uint8_t& touchedPadCount);
+                                int8_t& lastTouchedIndex, uint8_t& touchedPadCount, uint8_t& padMask);
+  static void publishPadChanges(TouchSlider* self, uint8_t padMask);
   static void handleNoTouch(TouchSlider* self);
   static void handleTouch(TouchSlider* self, int8_t firstTouchedIndex, int8_t lastTouchedIndex, uint8_t touchedPadCount);
+  static void handleTracked(TouchSlider* self, bool padTouchedFound, int8_t firstTouchedIndex, int8_t lastTouchedIndex,
+                            uint8_t touchedPadCount);
+  static void checkFirstTouch(TouchSlider* self, uint8_t touchedPadCount);
+  static void checkEdgeHold(TouchSlider* self, uint8_t touchedPadCount);
+  void readLiveEdge();
+  void publishSwipeFine(bool top);
+  static void handleClassified(TouchSlider* self, uint8_t padMask);
+  static bool handleContacts(TouchSlider* self, uint8_t padMask, int8_t& firstTouchedIndex, int8_t& lastTouchedIndex,
+                             uint8_t& touchedPadCount);
 
+  void publish(TouchSliderEventType event, uint8_t pad);
+#ifdef TOUCHSLIDER_WITH_DIAGNOSTICS
+  void sendTelemetry(uint32_t timestamp);
+  void sampleDrift(uint32_t now);
+  void recordFrame(uint32_t now);
+#endif
+  bool readFrame(uint32_t now);
+  bool readPadFrame();
+  void switchProfile(uint32_t now);
+  void setUpdateInterval(uint16_t interval);
+  void publishSnapshot();
+  int16_t trackedPosition();
+  uint8_t firstPad() { return _padMask ? __builtin_ctz(_padMask) : 0; };
   void resetFirstTouches();
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,447 @@
+#include "TouchTrace.h"
+
+#include <stdio.h>
+
+static const char* const GESTURE_NAMES[TRACE_GESTURE_COUNT] = {"SU", "SD", "FU", "FD", "TAP"};
+static const char* const CLASS_NAMES[TRACE_CLASS_COUNT] = {"swipe", "fine", "tap"};
+
+/**
+ * @brief Remove all the frames and labels of the trace.
+ */
+void TouchTrace::clear() {
+  _frameCount = 0;
+  _labelCount = 0;
+  _hasDeltas = false;
+}
+
+/**
+ * @brief Append a frame to the trace.
+ *
+ * @param tick Frame number, must be greater than the tick of the previous frame.
+ * @param mask Touched pads, bit 0 is the first pad.
+ * @param delta Delta counts of the pads (TOUCH_TRACE_PADS values), NULL if not available.
+ * @return false if the trace is full or the tick is out of order.
+ */
+bool TouchTrace::addFrame(uint16_t tick, uint8_t mask, const int8_t* delta) {
+  if (_frameCount >= TOUCH_TRACE_MAX_FRAMES || (_frameCount != 0 && tick < nextTick())) {
+    return false;
+  }
+
+  TouchTraceFrame& frame = _frames[_frameCount++];
+  frame.tick = tick;
+  frame.mask = mask;
+  if (delta != NULL) {
+    memcpy(frame.delta, delta, TOUCH_TRACE_PADS);
+    _hasDeltas = true;
+  } else {
+    memset(frame.delta, 0, TOUCH_TRACE_PADS);
+  }
+  return true;
+}
+
+/**
+ * @brief Append a gesture label to the trace.
+ *
+ * @param gesture Expected gesture.
+ * @param start First tick of the gesture.
+ * @param end Last tick of the gesture.
+ * @return false if the trace has no room for more labels.
+ */
+bool TouchTrace::addLabel(TouchTraceGesture gesture, uint16_t start, uint16_t end) {
+  if (_labelCount >= TOUCH_TRACE_MAX_LABELS || gesture >= TRACE_GESTURE_COUNT) {
+    return false;
+  }
+
+  TouchTraceLabel& label = _labels[_labelCount++];
+  label.gesture = gesture;
+  label.start = start;
+  label.end = end;
+  return true;
+}
+
+/**
+ * @brief Parse one line of the text format (see TouchTrace.h).
+ *
+ * @param line Null terminated line, comments and blank lines are accepted and ignored.
+ * @return false if the line is malformed or the trace is full.
+ */
+bool TouchTrace::parseLine(const char* line) {
+  while (*line == ' ' || *line == '\t') {
+    line++;
+  }
+  if (*line == '\0' || *line == '\r' || *line == '\n' || *line == '#') {
+    return true;
+  }
+
+  if (line[0] == 'F') {
+    unsigned int tick, mask;
+    int d[TOUCH_TRACE_PADS];
+    int fields = sscanf(line + 1, "%u %x %d %d %d %d %d %d %d %d", &tick, &mask,
+                        &d[0], &d[1], &d[2], &d[3], &d[4], &d[5], &d[6], &d[7]);
+    if (fields == 2) {
+      return addFrame(tick, mask);
+    }
+    if (fields == 2 + TOUCH_TRACE_PADS) {
+      int8_t delta[TOUCH_TRACE_PADS];
+      for (uint8_t i = 0; i < TOUCH_TRACE_PADS; i++) {
+        delta[i] = constrain(d[i], -128, 127);
+      }
+      return addFrame(tick, mask, delta);
+    }
+    return false;
+  }
+
+  if (line[0] == 'G') {
+    char name[8];
+    unsigned int start, end;
+    if (sscanf(line + 1, "%7s %u %u", name, &start, &end) != 3) {
+      return false;
+    }
+    for (uint8_t g = 0; g < TRACE_GESTURE_COUNT; g++) {
+      if (strcmp(name, GESTURE_NAMES[g]) == 0) {
+        return addLabel((TouchTraceGesture)g, start, end);
+      }
+    }
+    return false;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Write a frame in the text format.
+ *
+ * @param buffer Destination buffer.
+ * @param size Size of the buffer.
+ * @param frame Frame to write.
+ * @param withDeltas Append the delta counts.
+ * @return Number of characters written (as snprintf).
+ */
+size_t TouchTrace::formatFrame(char* buffer, size_t size, const TouchTraceFrame& frame, bool withDeltas) {
+  if (!withDeltas) {
+    return snprintf(buffer, size, "F %u %02x", frame.tick, frame.mask);
+  }
+  const int8_t* d = frame.delta;
+  return snprintf(buffer, size, "F %u %02x %d %d %d %d %d %d %d %d", frame.tick, frame.mask,
+                  d[0], d[1], d[2], d[3], d[4], d[5], d[6], d[7]);
+}
+
+/**
+ * @brief Write a label in the text format.
+ *
+ * @param buffer Destination buffer.
+ * @param size Size of the buffer.
+ * @param label Label to write.
+ * @return Number of characters written (as snprintf).
+ */
+size_t TouchTrace::formatLabel(char* buffer, size_t size, const TouchTraceLabel& label) {
+  return snprintf(buffer, size, "G %s %u %u", gestureName(label.gesture), label.start, label.end);
+}
+
+/**
+ * @brief Get the short name of a gesture used in the text format.
+ */
+const char* TouchTrace::gestureName(uint8_t gesture) {
+  return gesture < TRACE_GESTURE_COUNT ? GESTURE_NAMES[gesture] : "?";
+}
+
+/**
+ * @brief Reset all the counters of the score.
+ */
+void TouchTraceScore::clear() {
+  memset(classes, 0, sizeof(classes));
+}
+
+/**
+ * @brief Add the counters of another score (e.g. computed by another thread) to this one.
+ */
+void TouchTraceScore::merge(const TouchTraceScore& other) {
+  for (uint8_t c = 0; c < TRACE_CLASS_COUNT; c++) {
+    classes[c].truePositives += other.classes[c].truePositives;
+    classes[c].falsePositives += other.classes[c].falsePositives;
+    classes[c].falseNegatives += other.classes[c].falseNegatives;
+    classes[c].latencySum += other.classes[c].latencySum;
+    if (other.classes[c].latencyMax > classes[c].latencyMax) {
+      classes[c].latencyMax = other.classes[c].latencyMax;
+    }
+  }
+}
+
+/**
+ * @brief Fraction of the events of a class that matched a label, 1 if there were no events.
+ */
+float TouchTraceScore::precision(TouchTraceClass cls) const {
+  uint32_t detected = classes[cls].truePositives + classes[cls].falsePositives;
+  return detected == 0 ? 1.0f : (float)classes[cls].truePositives / detected;
+}
+
+/**
+ * @brief Fraction of the labels of a class that were detected, 1 if there were no labels.
+ */
+float TouchTraceScore::recall(TouchTraceClass cls) const {
+  uint32_t expected = classes[cls].truePositives + classes[cls].falseNegatives;
+  return expected == 0 ? 1.0f : (float)classes[cls].truePositives / expected;
+}
+
+/**
+ * @brief Average ticks from the start of a gesture to its detection.
+ */
+float TouchTraceScore::averageLatency(TouchTraceClass cls) const {
+  return classes[cls].truePositives == 0 ? 0.0f : (float)classes[cls].latencySum / classes[cls].truePositives;
+}
+
+/**
+ * @brief Print one line per gesture class with precision, recall and latency.
+ */
+void TouchTraceScore::print() const {
+  for (uint8_t c = 0; c < TRACE_CLASS_COUNT; c++) {
+    log_i("%-5s tp=%lu fp=%lu fn=%lu precision=%.3f recall=%.3f latency avg=%.2f max=%u ticks", CLASS_NAMES[c],
+          (unsigned long)classes[c].truePositives, (unsigned long)classes[c].falsePositives,
+          (unsigned long)classes[c].falseNegatives, precision((TouchTraceClass)c), recall((TouchTraceClass)c),
+          averageLatency((TouchTraceClass)c), classes[c].latencyMax);
+  }
+}
+
+/**
+ * @brief Replay a trace and add the result to a score.
+ *
+ * A label is detected by the first event of the same type between its start tick and TOUCH_TRACE_TOLERANCE ticks
+ * after its end, later events of that type in the window belong to the same gesture. Events inside a tap label or
+ * outside any label are false positives.
+ *
+ * @param trace Trace to replay.
+ * @param score Score to update.
+ */
+void TouchTraceRunner::run(const TouchTrace& trace, TouchTraceScore& score) {
+  // Flush any state left by a previous trace
+  _slider->processFrame(0);
+  _slider->processFrame(0);
+  _slider->getSwipeStatus();
+  _slider->getSwipeStatusFine();
+  _eventCount = 0;
+
+  uint16_t tick = 0;
+  for (uint16_t i = 0; i < trace.frameCount(); i++) {
+    const TouchTraceFrame& frame = trace.frame(i);
+    for (; tick < frame.tick; tick++) {  // Missing ticks are frames with no pad touched
+      feed(tick, 0);
+    }
+    feed(tick++, frame.mask);
+  }
+  for (uint8_t i = 0; i < TOUCH_TRACE_TAIL; i++) {
+    feed(tick++, 0);
+  }
+
+  for (uint8_t l = 0; l < trace.labelCount(); l++) {
+    const TouchTraceLabel& label = trace.label(l);
+    TouchTraceClassScore& cls = score.classes[classOf(label.gesture)];
+    uint16_t windowEnd = label.end + TOUCH_TRACE_TOLERANCE;
+    bool detected = false;
+    bool spurious = false;
+
+    for (uint8_t e = 0; e < _eventCount; e++) {
+      DetectedEvent& event = _events[e];
+      if (event.matched || event.tick < label.start || event.tick > windowEnd) {
+        continue;
+      }
+      if (label.gesture == TRACE_GESTURE_TAP) {
+        event.matched = true;
+        score.classes[classOf(event.event)].falsePositives++;
+        spurious = true;
+      } else if (event.event == label.gesture) {
+        event.matched = true;
+        if (!detected) {
+          uint16_t latency = event.tick - label.start;
+          cls.truePositives++;
+          cls.latencySum += latency;
+          if (latency > cls.latencyMax) {
+            cls.latencyMax = latency;
+          }
+          detected = true;
+        }
+      }
+    }
+
+    if (label.gesture == TRACE_GESTURE_TAP) {
+      if (spurious) {
+        cls.falseNegatives++;
+      } else {
+        cls.truePositives++;
+      }
+    } else if (!detected) {
+      cls.falseNegatives++;
+    }
+  }
+
+  for (uint8_t e = 0; e < _eventCount; e++) {
+    if (!_events[e].matched) {
+      score.classes[classOf(_events[e].event)].falsePositives++;
+    }
+  }
+}
+
+/**
+ * @brief Feed one frame to the slider and capture the events it produced.
+ */
+void TouchTraceRunner::feed(uint16_t tick, uint8_t mask) {
+  _slider->processFrame(mask);
+  // getSwipeStatus() is down minus up, see TouchSlider::getSwipeStatus()
+  capture(tick, SLIDER_EVENT_SWIPE_UP, SLIDER_EVENT_SWIPE_DOWN, _slider->getSwipeStatus());
+  capture(tick, SLIDER_EVENT_SWIPE_FINE_UP, SLIDER_EVENT_SWIPE_FINE_DOWN, _slider->getSwipeStatusFine());
+}
+
+/**
+ * @brief Store the events read back from one status getter.
+ */
+void TouchTraceRunner::capture(uint16_t tick, TouchSliderEventType up, TouchSliderEventType down, int8_t status) {
+  TouchSliderEventType type = status > 0 ? down : up;
+  for (int8_t n = abs(status); n > 0 && _eventCount < TOUCH_TRACE_MAX_EVENTS; n--) {
+    DetectedEvent& event = _events[_eventCount++];
+    event.tick = tick;
+    event.event = type;
+    event.matched = false;
+  }
+}
+
+/**
+ * @brief Class a gesture or event is scored in.
+ */
+TouchTraceClass TouchTraceRunner::classOf(uint8_t gesture) {
+  switch (gesture) {
+    case TRACE_GESTURE_SWIPE_UP:
+    case TRACE_GESTURE_SWIPE_DOWN:
+      return TRACE_CLASS_SWIPE;
+    case TRACE_GESTURE_SWIPE_FINE_UP:
+    case TRACE_GESTURE_SWIPE_FINE_DOWN:
+      return TRACE_CLASS_SWIPE_FINE;
+    default:
+      return TRACE_CLASS_TAP;
+  }
+}
+
+/**
+ * @brief Append a swipe to a trace.
+ *
+ * The finger moves at a constant speed; while it is between two pads both are reported as touched.
+ * Moving towards the last pad is a swipe down (see TouchSlider::analyzeGesture()).
+ *
+ * @param trace Trace to append to.
+ * @param fromPad First pad touched.
+ * @param toPad Last pad touched.
+ * @param speedQ4 Speed in sixteenths of a pad per tick (16 = one pad per tick, 8 = two ticks per pad).
+ */
+void TouchTraceGenerator::swipe(TouchTrace& trace, uint8_t fromPad, uint8_t toPad, uint8_t speedQ4) {
+  if (speedQ4 == 0) {
+    speedQ4 = 1;
+  }
+  uint16_t start = trace.nextTick();
+  uint16_t tick = start;
+  int8_t direction = toPad > fromPad ? 1 : -1;
+  uint16_t distanceQ4 = abs(toPad - fromPad) << 4;
+
+  for (uint16_t travelled = 0;; travelled += speedQ4) {
+    if (travelled > distanceQ4) {
+      travelled = distanceQ4;
+    }
+    uint8_t pad = fromPad + direction * (travelled >> 4);
+    uint8_t mask = 1 << pad;
+    if ((travelled & 0x0F) >= 4 && (travelled & 0x0F) <= 12) {  // Between two pads
+      mask |= 1 << (pad + direction);
+    }
+    emit(trace, tick++, mask, pad);
+    if (travelled == distanceQ4) {
+      break;
+    }
+  }
+
+  trace.addLabel(direction > 0 ? TRACE_GESTURE_SWIPE_DOWN : TRACE_GESTURE_SWIPE_UP, start, tick - 1);
+  idle(trace, 3);
+}
+
+/**
+ * @brief Append a tap on the first or last pad (swipe fine).
+ *
+ * @param trace Trace to append to.
+ * @param top true for the last pad (swipe fine up), false for the first pad (swipe fine down).
+ * @param ticks Duration of the contact.
+ */
+void TouchTraceGenerator::edgeTap(TouchTrace& trace, bool top, uint8_t ticks) {
+  uint16_t start = trace.nextTick();
+  uint8_t pad = top ? _pads - 1 : 0;
+  for (uint8_t i = 0; i < ticks; i++) {
+    emit(trace, start + i, 1 << pad, pad);
+  }
+  trace.addLabel(top ? TRACE_GESTURE_SWIPE_FINE_UP : TRACE_GESTURE_SWIPE_FINE_DOWN, start, start + ticks - 1);
+  idle(trace, 3);
+}
+
+/**
+ * @brief Append a tap on a pad that should not produce any event.
+ *
+ * @param trace Trace to append to.
+ * @param pad Pad touched, should not be the first or the last.
+ * @param ticks Duration of the contact.
+ */
+void TouchTraceGenerator::tap(TouchTrace& trace, uint8_t pad, uint8_t ticks) {
+  uint16_t start = trace.nextTick();
+  for (uint8_t i = 0; i < ticks; i++) {
+    emit(trace, start + i, 1 << pad, pad);
+  }
+  trace.addLabel(TRACE_GESTURE_TAP, start, start + ticks - 1);
+  idle(trace, 3);
+}
+
+/**
+ * @brief Append frames with no pad touched.
+ */
+void TouchTraceGenerator::idle(TouchTrace& trace, uint8_t ticks) {
+  uint16_t start = trace.nextTick();
+  for (uint8_t i = 0; i < ticks; i++) {
+    if (_deltas) {
+      int8_t delta[TOUCH_TRACE_PADS];
+      for (uint8_t p = 0; p < TOUCH_TRACE_PADS; p++) {
+        delta[p] = (int8_t)(next() % 7) - 3;
+      }
+      trace.addFrame(start + i, 0, delta);
+    } else {
+      trace.addFrame(start + i, 0);
+    }
+  }
+}
+
+/**
+ * @brief xorshift32 pseudo random generator.
+ */
+uint32_t TouchTraceGenerator::next() {
+  _state ^= _state << 13;
+  _state ^= _state >> 17;
+  _state ^= _state << 5;
+  return _state;
+}
+
+/**
+ * @brief Append one contact frame, applying the noise model.
+ */
+void TouchTraceGenerator::emit(TouchTrace& trace, uint16_t tick, uint8_t mask, uint8_t pad) {
+  if (_noise != 0 && (next() & 0xFF) < _noise) {
+    if (next() & 0x01) {
+      mask = 0;  // Dropped frame
+    } else {
+      int8_t neighbour = (next() & 0x01) ? pad + 1 : pad - 1;  // Neighbour pad flickers on
+      if (neighbour >= 0 && neighbour < _pads) {
+        mask |= 1 << neighbour;
+      }
+    }
+  }
+
+  if (!_deltas) {
+    trace.addFrame(tick, mask);
+    return;
+  }
+  int8_t delta[TOUCH_TRACE_PADS];
+  for (uint8_t p = 0; p < TOUCH_TRACE_PADS; p++) {
+    int8_t noise = (int8_t)(next() % 7) - 3;
+    delta[p] = ((mask >> p) & 0x01) ? 40 + noise : noise;
+  }
+  trace.addFrame(tick, mask, delta);
+}
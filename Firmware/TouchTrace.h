@@ -0,0 +1,181 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef TOUCHTRACE_H
+#define TOUCHTRACE_H
+
+/*********************** EXTERNAL LIBRARIES **********************/
+
+#include <Arduino.h>
+
+#include "TouchSlider.h"
+
+/*********************** LIBRARY OPTIONS **********************/
+#define TOUCH_TRACE_PADS 8                 // Pads stored per frame (CAP1208 inputs)
+#define TOUCH_TRACE_MAX_FRAMES 256         // Frames stored per trace
+#define TOUCH_TRACE_MAX_LABELS 16          // Labelled gestures per trace
+#define TOUCH_TRACE_MAX_EVENTS 64          // Events captured per replay
+#define TOUCH_TRACE_TOLERANCE 2            // Ticks after the end of a label where a detection is still accepted
+#define TOUCH_TRACE_TAIL 4                 // Empty frames fed after the last frame so releases are processed
+
+/*********************** LIBRARY OPTIONS **********************/
+
+/*
+ * Text format of a trace, one record per line ('#' starts a comment):
+ *
+ *   F <tick> <mask> [d1 .. d8]   Frame: tick number, pad mask in hex (bit 0 = first pad), optional delta counts
+ *   G <gesture> <start> <end>    Label: gesture expected between the start and end ticks (SU, SD, FU, FD or TAP)
+ *
+ * Frames are listed in increasing tick order, missing ticks are frames with no pad touched.
+ * A corpus is a set of such files, one trace per file.
+ */
+
+// Gesture labels, the first values match TouchSliderEventType
+enum TouchTraceGesture : uint8_t {
+  TRACE_GESTURE_SWIPE_UP = SLIDER_EVENT_SWIPE_UP,
+  TRACE_GESTURE_SWIPE_DOWN = SLIDER_EVENT_SWIPE_DOWN,
+  TRACE_GESTURE_SWIPE_FINE_UP = SLIDER_EVENT_SWIPE_FINE_UP,
+  TRACE_GESTURE_SWIPE_FINE_DOWN = SLIDER_EVENT_SWIPE_FINE_DOWN,
+  TRACE_GESTURE_TAP,  // Touch in the middle of the slider, no event expected
+  TRACE_GESTURE_COUNT
+};
+
+// Gesture classes reported by TouchTraceScore
+enum TouchTraceClass : uint8_t {
+  TRACE_CLASS_SWIPE,       // Swipe up and down
+  TRACE_CLASS_SWIPE_FINE,  // Swipe fine up and down
+  TRACE_CLASS_TAP,         // Taps, a true positive is a tap that produced no event
+  TRACE_CLASS_COUNT
+};
+
+typedef struct {
+  uint16_t tick;                    // Frame number
+  uint8_t mask;                     // Touched pads
+  int8_t delta[TOUCH_TRACE_PADS];   // Delta counts (zero if the trace has none)
+} TouchTraceFrame;
+
+typedef struct {
+  uint8_t gesture;  // TouchTraceGesture
+  uint16_t start;   // First tick of the gesture
+  uint16_t end;     // Last tick of the gesture
+} TouchTraceLabel;
+
+/**
+ * @brief A labelled trace of pad masks (and optionally delta counts).
+ *
+ * Fixed capacity, no allocation: it can live on the device (flight recorder export) or on the host (corpus replay).
+ */
+class TouchTrace {
+ public:
+  TouchTrace() { clear(); }
+
+  void clear();
+  bool addFrame(uint16_t tick, uint8_t mask, const int8_t* delta = NULL);
+  bool addLabel(TouchTraceGesture gesture, uint16_t start, uint16_t end);
+  bool parseLine(const char* line);
+
+  uint16_t frameCount() const { return _frameCount; }
+  const TouchTraceFrame& frame(uint16_t index) const { return _frames[index]; }
+  uint8_t labelCount() const { return _labelCount; }
+  const TouchTraceLabel& label(uint8_t index) const { return _labels[index]; }
+  bool hasDeltas() const { return _hasDeltas; }
+  uint16_t nextTick() const { return _frameCount == 0 ? 0 : _frames[_frameCount - 1].tick + 1; }
+
+  static size_t formatFrame(char* buffer, size_t size, const TouchTraceFrame& frame, bool withDeltas);
+  static size_t formatLabel(char* buffer, size_t size, const TouchTraceLabel& label);
+  static const char* gestureName(uint8_t gesture);
+
+ private:
+  TouchTraceFrame _frames[TOUCH_TRACE_MAX_FRAMES];
+  TouchTraceLabel _labels[TOUCH_TRACE_MAX_LABELS];
+  uint16_t _frameCount;
+  uint8_t _labelCount;
+  bool _hasDeltas;
+};
+
+typedef struct {
+  uint32_t truePositives;
+  uint32_t falsePositives;
+  uint32_t falseNegatives;
+  uint32_t latencySum;  // Ticks from the start of the gesture to its first event, summed over the true positives
+  uint16_t latencyMax;
+} TouchTraceClassScore;
+
+/**
+ * @brief Precision, recall and detection latency per gesture class, accumulated over replays.
+ */
+class TouchTraceScore {
+ public:
+  TouchTraceScore() { clear(); }
+
+  void clear();
+  void merge(const TouchTraceScore& other);
+  float precision(TouchTraceClass cls) const;
+  float recall(TouchTraceClass cls) const;
+  float averageLatency(TouchTraceClass cls) const;
+  void print() const;
+
+  TouchTraceClassScore classes[TRACE_CLASS_COUNT];
+};
+
+/**
+ * @brief Replays traces through a TouchSlider and scores the events against the labels.
+ *
+ * The slider must not be running (stop() it or never start() it). The events are read back with getSwipeStatus()
+ * and getSwipeStatusFine() after every frame, so the scoring sees exactly what an application would.
+ */
+class TouchTraceRunner {
+ public:
+  TouchTraceRunner(TouchSlider* slider) { _slider = slider; }
+
+  void run(const TouchTrace& trace, TouchTraceScore& score);
+
+ private:
+  typedef struct {
+    uint16_t tick;
+    uint8_t event;  // TouchSliderEventType
+    bool matched;
+  } DetectedEvent;
+
+  TouchSlider* _slider;
+  DetectedEvent _events[TOUCH_TRACE_MAX_EVENTS];
+  uint8_t _eventCount;
+
+  void feed(uint16_t tick, uint8_t mask);
+  void capture(uint16_t tick, TouchSliderEventType up, TouchSliderEventType down, int8_t status);
+  static TouchTraceClass classOf(uint8_t gesture);
+};
+
+/**
+ * @brief Deterministic generator of labelled traces.
+ *
+ * Synthesizes swipes at any speed, edge taps and middle taps, with optional noise (dropped frames and neighbour
+ * pads flickering). The same seed always produces the same traces.
+ */
+class TouchTraceGenerator {
+ public:
+  TouchTraceGenerator(uint32_t seed = 1) { _state = seed ? seed : 1; }
+
+  void setNoise(uint8_t noise) { _noise = noise; }         // Chance per contact frame (0-255 out of 256) of a glitch
+  void setDeltas(bool deltas) { _deltas = deltas; }        // Also synthesize delta counts
+  void setPads(uint8_t pads) { _pads = pads; }             // Pads on the slider
+
+  void swipe(TouchTrace& trace, uint8_t fromPad, uint8_t toPad, uint8_t speedQ4);
+  void edgeTap(TouchTrace& trace, bool top, uint8_t ticks);
+  void tap(TouchTrace& trace, uint8_t pad, uint8_t ticks);
+  void idle(TouchTrace& trace, uint8_t ticks);
+
+ private:
+  uint32_t _state;
+  uint8_t _noise = 0;
+  uint8_t _pads = TOUCH_TRACE_PADS;
+  bool _deltas = false;
+
+  uint32_t next();
+  void emit(TouchTrace& trace, uint16_t tick, uint8_t mask, uint8_t pad);
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include <Arduino.h>      // Arduino library
+#include <Wire.h>         // I2C library
+#include "CAP1208.h"      // Capacitive sensor library
+#include "TouchSlider.h"  // Touch slider library
+
+// Measures the cycle time and the noise of the preset acquisition profiles on this board (do not touch the slider
+// during the first seconds), then runs low-latency while touched and low-power otherwise.
+#define RELEASE_MS 1000  // Time without touch before going back to low-power
+
+// Objects
+CAP1208 CAP1208_Sensor;               // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);  // TouchSlider object
+
+void measureProfiles() {
+  Serial.println("profile      cycle(ms)  rms max(counts)  peak max  noise flags");
+  for (uint8_t id = 0; id < CAP1208_PROFILE_COUNT; id++) {
+    CAP1208_ProfileReport report;
+    if (!CAP1208_Sensor.measureProfile(CAP1208_PROFILES[id], report)) {
+      log_e("Measurement of %s failed", CAP1208_PROFILES[id].name);
+      continue;
+    }
+    uint16_t rms = 0;
+    uint8_t peak = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+      rms = max(rms, report.noiseRms[i]);
+      peak = max(peak, report.noisePeak[i]);
+    }
+    Serial.printf("%-12s %6lu.%01lu  %8u.%02u  %8u  0x%02X\n", CAP1208_PROFILES[id].name, report.cycleUs / 1000,
+                  report.cycleUs / 100 % 10, rms / 16, rms % 16 * 100 / 16, peak, report.noiseFlags);
+  }
+}
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(115200);  // Start serial for output
+
+  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+
+  measureProfiles();  // Before the slider starts, it shares the bus
+
+  Slider.enableSwipeFine();      // Enable the swipe fine
+  Slider.setSwipeFineTiming(1);  // Send it one frame after the press, auto-repeat while the edge pad is held
+  Slider.start();                // Start the touch slider
+  Slider.setAutoProfiles(CAP1208_PROFILES[CAP1208_PROFILE_LOW_POWER], CAP1208_PROFILES[CAP1208_PROFILE_LOW_LATENCY],
+                         RELEASE_MS);
+}
+
+void loop() {
+  Slider.getSwipeStatus();  // Print the swipes
+  Slider.getSwipeStatusFine();
+
+  static const CAP1208_Profile* shown = NULL;
+  if (Slider.getProfile() != shown) {
+    shown = Slider.getProfile();
+    log_i("Profile %s", shown->name);
+  }
+  delay(50);
+}
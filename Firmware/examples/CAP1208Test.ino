@@ -30,7 +30,7 @@ void setup() {
   pixels.clear();  // Set all pixel colors to 'off'
 
   log_i("Starting up with CAP1208 sensor...");
-  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.begin(Wire, CAP1208ADDR, true);   // Initialize the CAP1208 sensor at the fastest reliable I2C clock
   CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
   CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup (change this variable to change sensitivity according to your needs)
 
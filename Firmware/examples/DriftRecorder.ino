@@ -0,0 +1,54 @@
+#include <Arduino.h>      // Arduino library
+#include <Wire.h>         // I2C library
+#include "CAP1208.h"      // Capacitive sensor library
+#include "TouchSlider.h"  // Touch slider library
+
+// Records the base counts, delta counts, noise flags and calibration status once a minute (see SliderDrift.h).
+// With a data partition labelled "drift" in the partition table the log survives power cycles, otherwise it is kept
+// in PSRAM (or RAM). Send 'd' on the serial port to dump the whole log as CSV.
+#define DRIFT_PARTITION "drift"   // Label of the data partition
+#define DRIFT_RAM_SIZE (64 * 1024)  // Size of the log when no partition is found
+
+// Objects
+CAP1208 CAP1208_Sensor;               // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);  // TouchSlider object
+SliderDriftFlashStorage FlashLog(DRIFT_PARTITION);
+SliderDriftRamStorage RamLog(DRIFT_RAM_SIZE);
+SliderDrift* Drift = NULL;
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(115200);  // Start serial for output
+
+  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+
+  static SliderDrift flashDrift(FlashLog);
+  static SliderDrift ramDrift(RamLog);
+  if (flashDrift.begin()) {
+    Drift = &flashDrift;
+  } else if (ramDrift.begin()) {
+    Drift = &ramDrift;
+  }
+
+  Slider.start();  // Start the touch slider
+  if (Drift != NULL) {
+    Slider.attachDriftRecorder(Drift);
+  }
+}
+
+void loop() {
+  Slider.getSwipeStatus();  // The application keeps working as usual
+  Slider.getSwipeStatusFine();
+
+  if (Drift != NULL) {
+    Drift->flush();  // Encode and store the samples taken by the slider update
+    if (Serial.available() && Serial.read() == 'd') {
+      Drift->printCsv(Serial);
+      log_i("session %lu, %lu samples, %lu bytes, %lu dropped", (unsigned long)Drift->getSession(),
+            (unsigned long)Drift->getSamples(), (unsigned long)Drift->getBytes(), (unsigned long)Drift->getDropped());
+    }
+  }
+  delay(100);
+}
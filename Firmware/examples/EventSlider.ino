@@ -0,0 +1,66 @@
+#include <Adafruit_NeoPixel.h>  // NeoPixel library
+#include <Arduino.h>            // Arduino library
+#include <Wire.h>               // I2C library
+#include "CAP1208.h"      // Capacitive sensor library
+#include "Logger.h"       // Logger library
+#include "TouchSlider.h"  // Touch slider library
+
+// Pins designed for NeoPixels, edit according to your setup
+#define PIN 4              // Pin connected to NeoPixels
+#define NUMPIXELS 8        // NeoPixel ring size
+#define MAX_BRIGHTNESS 50  // The maximum brightness of the LED
+
+// Objects
+Adafruit_NeoPixel pixels(NUMPIXELS, PIN, NEO_GRB + NEO_KHZ800);  // NeoPixel object
+CAP1208 CAP1208_Sensor;                                          // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);                             // TouchSlider object
+
+// Runs in the Ticker context as soon as a pad is pressed (inline dispatch): keep it short
+void onPress(const TouchSliderEvent& event, void* context) {
+  Adafruit_NeoPixel* strip = (Adafruit_NeoPixel*)context;
+  strip->setPixelColor(event.pad, strip->Color(0, 0, MAX_BRIGHTNESS));  // Only updates the buffer, show() runs in loop()
+}
+
+void onRelease(const TouchSliderEvent& event, void* context) {
+  Adafruit_NeoPixel* strip = (Adafruit_NeoPixel*)context;
+  strip->setPixelColor(event.pad, 0);
+}
+
+// Only called for swipes that start on the upper half of the slider (pads 5 to 8)
+void onSwipe(const TouchSliderEvent& event, void* context) {
+  log_i("Swipe %s on pad %d at %lu ms", event.type == SLIDER_EVENT_SWIPE_UP ? "up" : "down", event.pad, (unsigned long)event.timestamp);
+}
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(115200);  // Start serial for output
+
+  pixels.begin();  // INITIALIZE NeoPixel strip object (REQUIRED)
+  pixels.clear();  // Set all pixel colors to 'off'
+
+  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+
+  Slider.subscribe(SLIDER_EVENT_PRESS, onPress, &pixels);      // Every pad
+  Slider.subscribe(SLIDER_EVENT_RELEASE, onRelease, &pixels);  // Every pad
+  Slider.subscribe(SLIDER_EVENT_SWIPE_UP, onSwipe, NULL, 0xF0);  // Upper segment only
+  Slider.subscribe(SLIDER_EVENT_SWIPE_DOWN, onSwipe, NULL, 0xF0);
+  Slider.setDispatchBudget(200);  // Warn if a handler takes more than 200 us
+  // Slider.setDispatchMode(SLIDER_DISPATCH_DEFERRED);  // Uncomment to run the handlers from loop() (Slider.dispatchEvents())
+
+  Slider.start();  // Start the touch slider
+}
+
+void loop() {
+  static uint32_t lastReport = 0;
+
+  Slider.dispatchEvents();  // Runs the handlers in deferred mode, does nothing in inline mode
+  pixels.show();  // Send the colors set by the handlers
+  delay(20);
+
+  if (millis() - lastReport > 10000) {  // Every 10 s, print the worst-case time of the handlers
+    lastReport = millis();
+    Slider.printDispatchStats();
+  }
+}
@@ -0,0 +1,47 @@
+#include <Arduino.h>      // Arduino library
+#include <Wire.h>         // I2C library
+#include "CAP1208.h"      // Capacitive sensor library
+#include "TouchSlider.h"  // Touch slider library
+
+// Swipe while the CAP1208 transactions fail at a configured rate, and watch the slider recover. Build with
+// -D CAP1208_FAULT_INJECTION, without it the faults are not injected and only the real errors are counted.
+#define REPORT_MS 10000  // Period of the report
+
+// Objects
+CAP1208 CAP1208_Sensor;               // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);  // TouchSlider object
+
+// 1% NACKs, 1% short reads, one reset per 100000 transactions, 2 ms latency spikes, no stuck bit
+const CAP1208_Faults faults = {10000, 10000, 10, 10000, 2000, 0x00, 0x00};
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(115200);  // Start serial for output
+
+  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+
+  Slider.enableSwipeFine();  // Enable the swipe fine
+  Slider.start();            // Start the touch slider (saves the configuration restored after a reset)
+  CAP1208_Sensor.setFaults(faults, millis() | 1);
+}
+
+void loop() {
+  Slider.getSwipeStatus();  // Print the swipes
+  Slider.getSwipeStatusFine();
+
+  static uint32_t lastReport = 0;
+  if (millis() - lastReport >= REPORT_MS) {
+    lastReport = millis();
+    TouchSliderHealth health;
+    CAP1208_FaultCounts counts;
+    Slider.getHealth(health);
+    CAP1208_Sensor.getFaultCounts(counts);
+    log_i("Injected: %lu nack, %lu short, %lu reset, %lu spike", (unsigned long)counts.nacks,
+          (unsigned long)counts.shortReads, (unsigned long)counts.resets, (unsigned long)counts.latencySpikes);
+    log_i("Recovered: %lu held, %u released, %u repaired, recovery %u ms (max %u ms)", (unsigned long)health.failedReads,
+          health.faultReleases, health.chipResets, health.lastRecoveryMs, health.maxRecoveryMs);
+  }
+  delay(50);
+}
@@ -0,0 +1,57 @@
+#include <Arduino.h>      // Arduino library
+#include <Wire.h>         // I2C library
+#include "CAP1208.h"      // Capacitive sensor library
+#include "TouchSlider.h"  // Touch slider library
+#include "TouchTrace.h"   // Trace format (TOUCH_TRACE_MAX_FRAMES)
+
+// Records every raw frame in PSRAM (see SliderRecorder.h). The recorder freezes a moment after a swipe fine, or when
+// 't' is sent on the serial port (e.g. right after a missed swipe). Send 'e' to export the window as a trace that the
+// host tooling replays through TouchSlider, and 'r' to record again. A longer window is exported in several parts,
+// one trace each (see SliderRecorder::exportTrace()).
+#define EXPORT_FRAMES TOUCH_TRACE_MAX_FRAMES  // Newest frames exported, one trace (12.8 seconds at 20 Hz)
+
+// Objects
+CAP1208 CAP1208_Sensor;               // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);  // TouchSlider object
+SliderRecorder Recorder;              // Flight recorder
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(115200);  // Start serial for output
+
+  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+  Slider.enableSwipeFine();                        // Enable the swipe fine
+
+  Recorder.setCapture(true, true);  // General status and delta counts on every frame
+  Recorder.setTriggerEvents((1 << SLIDER_EVENT_SWIPE_FINE_UP) | (1 << SLIDER_EVENT_SWIPE_FINE_DOWN));
+  if (Recorder.begin()) {
+    Slider.attachRecorder(&Recorder);
+  }
+  Slider.start();  // Start the touch slider
+}
+
+void loop() {
+  Slider.getSwipeStatus();  // The application keeps working as usual
+  Slider.getSwipeStatusFine();
+
+  switch (Serial.available() ? Serial.read() : 0) {
+    case 't':
+      Recorder.trigger();
+      break;
+    case 'e':
+      Recorder.exportTrace(Serial, EXPORT_FRAMES);
+      break;
+    case 'r':
+      Recorder.resume();
+      break;
+  }
+
+  static bool wasFrozen = false;
+  if (Recorder.isFrozen() != wasFrozen) {
+    wasFrozen = Recorder.isFrozen();
+    log_i("Flight recorder %s", wasFrozen ? "frozen, send 'e' to export" : "recording");
+  }
+  delay(50);
+}
@@ -0,0 +1,103 @@
+#include <Arduino.h>      // Arduino library
+#include <Wire.h>         // I2C library
+#include "CAP1208.h"      // Capacitive sensor library
+#include "SliderTrainer.h"  // Classifier trainer library
+#include "TouchSlider.h"  // Touch slider library
+#include "TouchTrace.h"   // Trace replay library
+
+// Trains the gesture classifier (see SliderClassifier.h) on generated traces, prints the model as a
+// SliderGestureModel.h header, compares it with the heuristics on other traces, then uses it on the slider. The same
+// runs on the host with extras/host/gesture_train.
+// Recorded traces (SliderRecorder::exportTrace()) can be added with TouchTrace::parseLine() before train().
+#define TRAIN_TRACES 500  // Traces of 4 gestures used for training (about 60 frames each)
+#define TEST_TRACES 300   // Traces of 4 gestures used for the comparison
+
+// Objects
+CAP1208 CAP1208_Sensor;               // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);  // TouchSlider object
+SliderTrainer Trainer;                // Classifier trainer
+TouchTrace Trace;                     // Trace being generated
+
+// Append 4 random gestures (swipes from slow to fast flicks, edge taps, middle taps) to the trace
+void randomGestures(TouchTraceGenerator& generator, uint32_t& seed) {
+  Trace.clear();
+  for (uint8_t i = 0; i < 4; i++) {  // A trace holds TOUCH_TRACE_MAX_FRAMES frames
+    seed = seed * 1664525 + 1013904223;
+    uint8_t from = (seed >> 8) % 8;
+    uint8_t to = (from + 1 + (seed >> 12) % 7) % 8;
+    switch ((seed >> 24) % 4) {
+      case 0:
+      case 1:
+        generator.swipe(Trace, from, to, (seed >> 16) & 0x01 ? 2 + (seed >> 4) % 14 : 16 + (seed >> 4) % 56);
+        break;
+      case 2:
+        generator.edgeTap(Trace, (seed >> 16) & 0x01, 1 + (seed >> 4) % 6);
+        break;
+      default:
+        generator.tap(Trace, 1 + (seed >> 4) % 6, 1 + (seed >> 20) % 8);
+        break;
+    }
+  }
+}
+
+// Replay the test traces through the slider and print the score
+void compare(TouchSlider& slider, const char* name) {
+  TouchTraceGenerator generator(99);
+  TouchTraceRunner runner(&slider);
+  TouchTraceScore score;
+  uint32_t seed = 12345;
+  for (uint16_t i = 0; i < TEST_TRACES; i++) {
+    generator.setNoise((i % 4) * 20);
+    randomGestures(generator, seed);
+    runner.run(Trace, score);
+  }
+  log_i("%s:", name);
+  score.print();
+}
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(115200);  // Start serial for output
+
+  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+  Slider.enablePrintSwipeStatus();                 // Print the detected gestures
+  Slider.enableSwipeFine();
+
+  // The samples take 18 bytes per frame: without PSRAM the trainer keeps what fits in half of the heap
+  if (!Trainer.begin()) {
+    log_e("Not enough memory to train, the slider keeps the heuristics");
+    Slider.start();
+    return;
+  }
+  TouchTraceGenerator generator(1);
+  uint32_t seed = 7;
+  for (uint16_t i = 0; i < TRAIN_TRACES; i++) {
+    generator.setNoise((i % 4) * 20);  // Dropped frames and flickering neighbours
+    randomGestures(generator, seed);
+    Trainer.addTrace(Trace);
+  }
+  Trainer.train();
+  Trainer.printModel(Serial, "examples/GestureTrainer.ino");  // Save it as SliderGestureModel.h to make it the default model
+
+  static TouchSlider heuristics(NULL);  // Replay only, never started
+  heuristics.enableSwipeFine();
+  compare(heuristics, "Heuristics");
+
+  static TouchSlider classified(NULL);
+  classified.enableSwipeFine();
+  classified.enableClassifier();
+  classified.setClassifierModel(Trainer.getTree(), Trainer.getNodes());
+  compare(classified, "Classifier");
+
+  Slider.enableClassifier();
+  Slider.setClassifierModel(Trainer.getTree(), Trainer.getNodes());  // The trainer keeps the tables
+  Slider.start();
+}
+
+void loop() {
+  Slider.getSwipeStatus();
+  Slider.getSwipeStatusFine();
+  delay(100);
+}
@@ -0,0 +1,51 @@
+#include <Arduino.h>      // Arduino library
+#include <Wire.h>         // I2C library
+#include "CAP1208.h"      // Capacitive sensor library
+#include "Logger.h"       // Logger library
+#include "TouchSlider.h"  // Touch slider library
+
+// Objects
+CAP1208 CAP1208_Sensor;               // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);  // TouchSlider object
+
+int16_t Zoom = 100;   // Changed by pinch and spread, in percent
+int16_t Scroll = 0;   // Changed by the two-finger scroll, in lines
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(115200);  // Start serial for output
+
+  log_i("Starting up with CAP1208 sensor...");
+  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Report up to 4 touched pads at once (REQUIRED for two fingers)
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+
+  Slider.enableMultiTouch(true);  // Split the touch into contacts, with the delta counts for fingers on neighbouring pads
+  Slider.start();                 // Start the touch slider
+}
+
+void loop() {
+  int8_t pinch = Slider.getPinchStatus();    // > 0 fingers moved apart, < 0 together
+  int8_t scroll = Slider.getScrollStatus();  // > 0 both fingers moved towards the last pad
+  int8_t swipe = Slider.getSwipeStatus();    // One finger still swipes as usual
+
+  if (pinch != 0) {
+    Zoom = constrain(Zoom + pinch * 10, 10, 400);
+    log_i("Zoom: %d%%", Zoom);
+  }
+  if (scroll != 0 || swipe != 0) {
+    Scroll += scroll * 5 + swipe;  // The two-finger scroll moves faster
+    log_i("Scroll: %d", Scroll);
+  }
+
+  SliderContact contacts[SLIDER_CONTACTS_MAX];
+  static uint8_t lastCount = 0;
+  uint8_t count = Slider.getContacts(contacts);
+  if (count != lastCount) {  // Print the contacts when a finger is added or lifted
+    lastCount = count;
+    for (uint8_t i = 0; i < count; i++) {
+      log_i("Contact %u: pads %u-%u, position %d", contacts[i].id, contacts[i].first, contacts[i].last, contacts[i].position);
+    }
+  }
+  delay(50);
+}
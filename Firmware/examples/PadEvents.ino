@@ -0,0 +1,46 @@
+#include <Arduino.h>      // Arduino library
+#include <Wire.h>         // I2C library
+#include "CAP1208.h"      // Capacitive sensor library
+#include "TouchSlider.h"  // Touch slider library
+
+// The first and the last pads work as -/+ buttons: one step per press, and a step per hardware repeat while held.
+// The CAP1208 signals the press, the repeat and the release itself, so a tap shorter than the update interval is
+// not missed and its release is known on the same update.
+#define ALERT_PIN -1  // Input connected to the ALERT output of the CAP1208, -1 if not wired
+#define HOLD_MS 420   // Hold time before the repeat starts
+#define REPEAT_MS 105  // Repeat period
+
+// Objects
+CAP1208 CAP1208_Sensor;               // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);  // TouchSlider object
+
+volatile int16_t level = 50;
+
+void onStep(const TouchSliderEvent& event, void* context) {
+  int16_t step = event.pad == 0 ? -1 : 1;
+  level = constrain(level + step, 0, 100);
+}
+
+void onRelease(const TouchSliderEvent& event, void* context) {
+  log_i("Pad %d released, level %d", event.pad, level);
+}
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(115200);  // Start serial for output
+
+  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+
+  Slider.subscribe(SLIDER_EVENT_PRESS, onStep, NULL, 0x81);  // First and last pads
+  Slider.subscribe(SLIDER_EVENT_REPEAT, onStep, NULL, 0x81);
+  Slider.subscribe(SLIDER_EVENT_RELEASE, onRelease, NULL, 0x81);
+
+  Slider.start();                                        // Start the touch slider
+  Slider.enablePadEvents(ALERT_PIN, HOLD_MS, REPEAT_MS);  // Press, repeat and release from the CAP1208
+}
+
+void loop() {
+  delay(100);
+}
@@ -4,6 +4,7 @@
 #include "CAP1208.h"      // Capacitive sensor library
 #include "Logger.h"       // Logger library
 #include "TouchSlider.h"  // Touch slider library
+#include "SliderEffects.h"  // LED effects library
 
 // Pins designed for NeoPixels, edit according to your setup
 #define PIN 4              // Pin connected to NeoPixels
@@ -12,14 +13,13 @@
 #define MAX_BRIGHTNESS 50  // The maximum brightness of the LED
 #define STEP_BRIGHTNESS 5  // The step brightness of the LED
 #define STEP_PERCENTAGE 5  // The step percentage of the LED
-
-// Array to store the state of the pads
-bool PadsTouched[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+#define FRAME_MS 10        // Time between two frames (100 fps)
 
 // Objects
 Adafruit_NeoPixel pixels(NUMPIXELS, PIN, NEO_GRB + NEO_KHZ800);  // NeoPixel object
 CAP1208 CAP1208_Sensor;                                          // CAP1208 object
 TouchSlider Slider(&CAP1208_Sensor);                             // TouchSlider object
+SliderEffects Effects(NUMPIXELS);                                // LED effects object
 
 void setup() {
   Wire.begin();          // Join I2C bus
@@ -35,20 +35,14 @@ void setup() {
   CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
   CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup (change this variable to change sensitivity according to your needs)
 
+  Effects.setEffects(SLIDER_FX_RAINBOW | SLIDER_FX_TRAIL | SLIDER_FX_RIPPLE);  // Rainbow touch with a fading trail and a ripple on each press
+  Effects.setBrightness(MAX_BRIGHTNESS);                                       // Set the brightness
+
   Slider.start();  // Start the touch slider
 }
 
 void loop() {
-  Slider.getSliderTouched(PadsTouched, sizeof(PadsTouched));  // Get the state of the pads
-
-  for (uint8_t i = 0; i < NUMPIXELS; i++) {                              // For each pixel
-    if (PadsTouched[i]) {                                                // If the pad is touched
-      uint32_t color = pixels.ColorHSV(map(i, 0, NUMPIXELS, 0, 65535));  // Calculate the color based on the position of the pad
-      pixels.setPixelColor(i, color);                                    // Set the pixel color
-      pixels.setBrightness(MAX_BRIGHTNESS);                              // Set the brightness
-    } else {                                                             // If the pad is not touched
-      pixels.setPixelColor(i, 0);                                        // Turn off LED if not touched
-    }
-  }
-  pixels.show();  // Show the pixels
-}
\ No newline at end of file
+  Effects.setTouch(Slider.getPadMask());  // Only the pixels of the pads that changed are recomputed
+  Effects.show(pixels);                   // Render the frame, the strip is only updated if a pixel changed
+  delay(FRAME_MS);
+}
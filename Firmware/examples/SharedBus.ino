@@ -0,0 +1,66 @@
+#include <Arduino.h>       // Arduino library
+#include <Wire.h>          // I2C library
+#include "CAP1208.h"       // Capacitive sensor library
+#include "SharedI2CBus.h"  // Shared I2C bus arbiter
+#include "TouchSlider.h"   // Touch slider library
+
+// The slider shares Wire with two other devices. The touch poll is a periodic client with a reserved slot; the
+// other drivers go through the same arbiter and split their large transfers around the slot.
+#define IMU_ADDRESS 0x6A    // Accelerometer/gyroscope (e.g. LSM6DS3)
+#define IMU_FIFO 0x3E       // FIFO data register
+#define GAUGE_ADDRESS 0x36  // Fuel gauge (e.g. MAX17048)
+#define GAUGE_SOC 0x04      // State of charge register
+#define POLL_US 50000       // Poll interval of the slider (default profile)
+#define SLOT_US 3000        // Bus time of one slider update
+
+// Objects
+CAP1208 CAP1208_Sensor;               // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);  // TouchSlider object
+SharedI2CBus Bus(Wire);               // Arbiter of the Wire bus
+
+int8_t touchClient, imuClient, gaugeClient;
+uint8_t imuFifo[192];
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(115200);  // Start serial for output
+
+  CAP1208_Sensor.begin(Wire, CAP1208ADDR, true);  // Initialize the CAP1208 sensor and select the bus clock
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+
+  Bus.begin();  // After the clock is final
+  touchClient = Bus.addPeriodicClient("touch", 3, POLL_US, SLOT_US, 5000);
+  imuClient = Bus.addClient("imu", 2, 20000);
+  gaugeClient = Bus.addClient("gauge", 1);
+  CAP1208_Sensor.setBus(&Bus, touchClient);
+
+  Slider.enableSwipeFine();  // Enable the swipe fine
+  Slider.start();            // Start the touch slider
+}
+
+void loop() {
+  Slider.getSwipeStatus();  // Print the swipes
+  Slider.getSwipeStatusFine();
+
+  if (!Bus.readChunked(imuClient, IMU_ADDRESS, IMU_FIFO, imuFifo, sizeof(imuFifo))) {
+    log_w("IMU read failed");
+  }
+
+  static uint32_t lastGauge = 0;
+  if (millis() - lastGauge >= 1000) {
+    lastGauge = millis();
+    uint8_t soc[2];
+    if (Bus.readChunked(gaugeClient, GAUGE_ADDRESS, GAUGE_SOC, soc, sizeof(soc))) {
+      log_i("Battery %u%%", soc[0]);
+    }
+  }
+
+  static uint32_t lastStats = 0;
+  if (millis() - lastStats >= 10000) {
+    lastStats = millis();
+    Bus.printStats();  // Occupancy, waits and deadline misses per client
+    Bus.resetStats();
+  }
+  delay(20);
+}
@@ -0,0 +1,33 @@
+#include <Arduino.h>      // Arduino library
+#include <Wire.h>         // I2C library
+#include "CAP1208.h"      // Capacitive sensor library
+#include "TouchSlider.h"  // Touch slider library
+
+// Streams one binary frame per update (see SliderTelemetry.h for the layout) instead of text logs.
+// Decode it on the host with SliderTelemetryDecoder, which skips any text printed on the same port, e.g. with
+// extras/host/telemetry_decode /dev/ttyUSB0 > capture.csv
+#define TELEMETRY_DECIMATION 1  // Send one frame out of N (events of the skipped frames are kept)
+
+// Objects
+CAP1208 CAP1208_Sensor;                                   // CAP1208 object
+TouchSlider Slider(&CAP1208_Sensor);                      // TouchSlider object
+SliderTelemetry Telemetry(Serial, TELEMETRY_DECIMATION);  // Telemetry encoder on the USB serial port
+
+void setup() {
+  Wire.begin();          // Join I2C bus
+  Serial.begin(921600);  // The frames fit at 115200 baud, a faster port leaves room for decimation 1 with logs
+
+  CAP1208_Sensor.begin();                          // Initialize the CAP1208 sensor
+  CAP1208_Sensor.ConfigureMultiTouch(4);           // Configure MultiTouch to 4 pads
+  CAP1208_Sensor.setSensitivity(SENSITIVITY_32X);  // Set sensitivity to 32x on startup
+
+  Slider.start();                           // Start the touch slider
+  Slider.disablePrintSwipeStatus();         // Keep the port for the binary frames
+  Slider.attachTelemetry(&Telemetry);       // Stream every update
+}
+
+void loop() {
+  Slider.getSwipeStatus();      // The application keeps working as usual
+  Slider.getSwipeStatusFine();
+  delay(100);
+}
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+#
+# Marcos Abraham Carballo Vazquez
+# Original Creation Date: Dicember 5, 2024
+# https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+#
+# Per-symbol RAM and flash footprint of the TouchSlider library in a firmware ELF, with budgets.
+#
+#   python3 Firmware/extras/footprint.py .pio/build/<env>/firmware.elf --ram 1024 --flash 24576
+#
+# The symbols of the library (demangled names matching --match) are listed by size. The exit status is 1 when a
+# budget is exceeded, so the script can run as a post-build step (PlatformIO: extra_scripts, Arduino CLI: after
+# `arduino-cli compile --output-dir`). RAM is .bss/.data, flash is code and read-only data (IRAM code included).
+# The RAM of the TouchSlider/CAP1208 objects declared by the sketch belongs to the sketch symbols; it is checked at
+# compile time against TOUCHSLIDER_RAM_BUDGET instead.
+
+import argparse
+import re
+import subprocess
+import sys
+
+RAM_TYPES = set("bBdDsS")
+FLASH_TYPES = set("tTrRwWvV")
+# Names starting with a library class (or its vtable, typeinfo or guard variable), not any name containing "Slider"
+LIBRARY_SYMBOLS = r"^(?:(?:vtable|typeinfo|typeinfo name|guard variable) for )?(?:TouchSlider|CAP1208|Slider[A-Z]|TouchTrace)"
+
+
+def read_symbols(nm, elf):
+    output = subprocess.run([nm, "-C", "-S", "--size-sort", elf], check=True, capture_output=True, text=True).stdout
+    for line in output.splitlines():
+        fields = line.split(None, 3)  # Address, size, type, name
+        if len(fields) == 4:
+            yield int(fields[1], 16), fields[2], fields[3]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RAM and flash footprint of the TouchSlider library")
+    parser.add_argument("elf", help="Firmware ELF")
+    parser.add_argument("--nm", default="xtensa-esp32-elf-nm", help="nm of the toolchain (default %(default)s)")
+    parser.add_argument("--match", default=LIBRARY_SYMBOLS, help="Regular expression of the library symbols")
+    parser.add_argument("--ram", type=int, default=0, help="RAM budget in bytes (0 = no budget)")
+    parser.add_argument("--flash", type=int, default=0, help="Flash budget in bytes (0 = no budget)")
+    parser.add_argument("--top", type=int, default=20, help="Largest symbols listed per section")
+    args = parser.parse_args()
+
+    match = re.compile(args.match)
+    ram, flash = [], []
+    for size, kind, name in read_symbols(args.nm, args.elf):
+        if not match.search(name):
+            continue
+        if kind in RAM_TYPES:
+            ram.append((size, name))
+        elif kind in FLASH_TYPES:
+            flash.append((size, name))
+
+    failed = False
+    for title, symbols, budget in (("RAM", ram, args.ram), ("Flash", flash, args.flash)):
+        total = sum(size for size, _ in symbols)
+        symbols.sort(reverse=True)
+        print("%s: %d bytes in %d symbols%s" % (title, total, len(symbols), " (budget %d)" % budget if budget else ""))
+        for size, name in symbols[:args.top]:
+            print("  %6d  %s" % (size, name))
+        if budget and total > budget:
+            print("%s budget exceeded by %d bytes" % (title, total - budget), file=sys.stderr)
+            failed = True
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
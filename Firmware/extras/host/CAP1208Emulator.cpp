@@ -0,0 +1,195 @@
+#include "CAP1208Emulator.h"
+
+/**
+ * @brief Back to the reset values of the datasheet (pg. 20), as after a power cycle.
+ */
+void CAP1208Emulator::powerOn() {
+  static const struct {
+    uint8_t address;
+    uint8_t value;
+  } defaults[] = {
+      {0x1F, 0x2F}, {0x20, 0x20}, {0x21, 0xFF}, {0x22, 0xA4}, {0x23, 0x07}, {0x24, 0x39}, {0x27, 0xFF},
+      {0x28, 0xFF}, {0x2A, 0x80}, {0x2D, 0xFF}, {0x2F, 0x8A}, {0x30, 0x40}, {0x31, 0x40}, {0x32, 0x40},
+      {0x33, 0x40}, {0x34, 0x40}, {0x35, 0x40}, {0x36, 0x40}, {0x37, 0x40}, {0x38, 0x01}, {0x41, 0x39},
+      {0x42, 0x02}, {0x43, 0x40}, {0x44, 0x40}, {0xFD, 0x6B}, {0xFE, 0x5D}, {0xFF, 0x00},
+  };
+  memset(_regs, 0, sizeof(_regs));
+  for (const auto& d : defaults) {
+    _regs[d.address] = d.value;
+  }
+  _pointer = 0;
+  _detected = 0;
+  _latched = 0;
+  _fingers = 0;
+  memset(_nextRepeatUs, 0, sizeof(_nextRepeatUs));
+  _repeats = 0;
+}
+
+/**
+ * @brief Sample the pads once.
+ *
+ * With multiple touch blocking on, a new input is only detected while fewer than B_MULT_T + 1 are; the inputs
+ * already detected keep their place.
+ *
+ * @param fingers Pads under a finger, bit 0 = CS1.
+ */
+void CAP1208Emulator::sense(uint8_t fingers) {
+  uint8_t enabled = fingers & _regs[0x21];
+  uint8_t limit = (_regs[0x2A] & 0x80) ? ((_regs[0x2A] >> 2) & 0x03) + 1 : 8;
+  uint8_t previous = _detected;
+  _detected &= enabled;
+  for (uint8_t i = 0; i < 8; i++) {
+    if ((enabled >> i & 1) && !(_detected >> i & 1) && __builtin_popcount(_detected) < limit) {
+      _detected |= 1 << i;
+    }
+  }
+  _latched |= _detected;
+  _fingers = fingers;
+  updateDeltas();
+  _regs[0x02] = (_regs[0x02] & ~0x01) | (_detected != 0);
+
+  // Alerts: presses, releases unless INT_REL_n is set, and the repeats of the held inputs
+  uint64_t now = hostMicros();
+  uint8_t pressed = _detected & ~previous;
+  uint8_t raise = pressed | ((_regs[0x44] & 0x01) ? 0 : previous & ~_detected);
+  for (uint8_t i = 0; i < 8; i++) {
+    uint64_t holdUs = ((_regs[0x23] & 0x0F) + 1) * 35000ULL;
+    uint64_t repeatUs = ((_regs[0x22] & 0x0F) + 1) * 35000ULL;
+    if (pressed >> i & 1) {
+      _nextRepeatUs[i] = now + holdUs;
+    } else if ((_detected >> i & 1) && (_regs[0x28] >> i & 1) && now >= _nextRepeatUs[i]) {
+      raise |= 1 << i;
+      _repeats++;
+      _nextRepeatUs[i] += repeatUs;
+    }
+  }
+  if (raise & _regs[0x27]) {
+    _regs[0x00] |= 0x01;
+  }
+
+  if (now >= _busDownUntilUs && inject(_faults.burstPpm)) {
+    _busDownUntilUs = now + _faults.burstMs * 1000ULL;
+    _faultCounts.bursts++;
+  }
+}
+
+/**
+ * @brief Time between two measurements: the cycle time, or longer when the 8 inputs x averaging x sample time do not
+ *        fit in it.
+ */
+uint32_t CAP1208Emulator::cycleUs() const {
+  uint8_t config = _regs[0x24];
+  uint32_t targetUs = 35000UL * ((config & 0x03) + 1);
+  uint32_t samplingUs = 8UL * (1UL << (config >> 4 & 0x07)) * (320UL << (config >> 2 & 0x03));
+  return samplingUs > targetUs ? samplingUs : targetUs;
+}
+
+/**
+ * @brief Delta counts of the measurement cycle in progress: the fingers, and the noise of the free pads.
+ */
+void CAP1208Emulator::updateDeltas() {
+  uint64_t cycle = hostMicros() / cycleUs();
+  for (uint8_t i = 0; i < 8; i++) {
+    int8_t delta = 0;
+    if (_fingers >> i & 1) {
+      delta = CAP1208_EMULATOR_DELTA;
+    } else if (_noise != 0) {
+      uint64_t h = (cycle * 8 + i + 1) * 0x9E3779B97F4A7C15ULL;  // Same cycle, same noise
+      h ^= h >> 31;
+      delta = (int8_t)(h % (2 * _noise + 1)) - _noise;
+    }
+    _regs[0x10 + i] = (uint8_t)delta;
+  }
+}
+
+/**
+ * @brief Inject bus faults from now on.
+ *
+ * @param faults Chances of each fault, all 0 for a reliable bus.
+ * @param seed Seed of the fault generator.
+ */
+void CAP1208Emulator::setFaults(const CAP1208EmulatorFaults& faults, uint32_t seed) {
+  _faults = faults;
+  _random = seed != 0 ? seed : 1;
+  _busDownUntilUs = 0;
+}
+
+/**
+ * @brief Draw a fault of the given chance (xorshift32).
+ */
+bool CAP1208Emulator::inject(uint32_t ppm) {
+  if (ppm == 0) {
+    return false;
+  }
+  _random ^= _random << 13;
+  _random ^= _random >> 17;
+  _random ^= _random << 5;
+  return _random % 1000000 < ppm;
+}
+
+/**
+ * @brief Faults of a transaction before the data moves: stretched clock, then NACK (bus too fast, burst or random).
+ *
+ * @return true if the transaction is not acknowledged.
+ */
+bool CAP1208Emulator::busFault() {
+  if (inject(_faults.latencyPpm)) {
+    delayMicroseconds(_faults.latencyUs);  // Advances the clock without firing the Tickers, as a blocked bus would
+    _faultCounts.stretches++;
+  }
+  bool tooFast = _faults.maxClockHz != 0 && busClock > _faults.maxClockHz;
+  if (tooFast || hostMicros() < _busDownUntilUs || inject(_faults.nackPpm)) {
+    _faultCounts.nacks++;
+    return true;
+  }
+  return false;
+}
+
+int CAP1208Emulator::readAlert(uint8_t pin, void* emulator) {
+  return static_cast<CAP1208Emulator*>(emulator)->alert() ? LOW : HIGH;
+}
+
+/**
+ * @brief Register pointer, then data written from it on. Clearing INT drops the inputs that are no longer touched.
+ */
+uint8_t CAP1208Emulator::write(const uint8_t* data, size_t length, bool stop) {
+  if (busFault()) {
+    return 2;  // Address NACK
+  }
+  if (length == 0) {
+    return 0;
+  }
+  _pointer = data[0];
+  for (size_t i = 1; i < length; i++, _pointer++) {
+    if (_pointer == 0x00 && !(data[i] & 0x01)) {
+      _latched = _detected;
+    }
+    _regs[_pointer] = data[i];
+  }
+  if (inject(_faults.resetPpm)) {
+    powerOn();
+    _faultCounts.resets++;
+  }
+  return 0;
+}
+
+/**
+ * @brief Registers from the pointer on; the stuck bits of the Sensor Input Status and short reads are injected here.
+ */
+size_t CAP1208Emulator::read(uint8_t* data, size_t length) {
+  if (busFault()) {
+    return 0;
+  }
+  if (_noise != 0) {
+    updateDeltas();  // The chip measures on its own, between the sense() calls too
+  }
+  for (size_t i = 0; i < length; i++, _pointer++) {
+    data[i] = _pointer == 0x03 ? (_latched & ~_faults.stuckMask) | (_faults.stuckValue & _faults.stuckMask)
+                               : _regs[_pointer];
+  }
+  if (length > 0 && inject(_faults.shortReadPpm)) {
+    _faultCounts.shortReads++;
+    return length - 1;
+  }
+  return length;
+}
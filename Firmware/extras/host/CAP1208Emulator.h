@@ -0,0 +1,92 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef CAP1208EMULATOR_H
+#define CAP1208EMULATOR_H
+
+#include <Wire.h>
+
+/*********************** LIBRARY OPTIONS **********************/
+#define CAP1208_EMULATOR_DELTA 0x50  // Delta count of a pad under a finger (the default threshold is 0x40)
+
+/*********************** LIBRARY OPTIONS **********************/
+
+// Bus faults injected by the emulator; the chances are in parts per million of the transactions (of the sense()
+// calls for the bursts)
+typedef struct {
+  uint32_t nackPpm;       // Transaction not acknowledged
+  uint32_t shortReadPpm;  // Read that returns one byte less
+  uint32_t resetPpm;      // Chip back at its reset values after the transaction (brown-out)
+  uint32_t latencyPpm;    // Transaction stretched by latencyUs (clock stretching)
+  uint16_t latencyUs;
+  uint8_t stuckMask;      // Bits of the Sensor Input Status stuck at stuckValue
+  uint8_t stuckValue;
+  uint32_t burstPpm;      // Start of a burst during which every transaction is NACKed (e.g. a disconnected cable)
+  uint16_t burstMs;
+  uint32_t maxClockHz;    // Every transaction NACKed at a faster bus clock (long wires, weak pull-ups), 0 = any clock
+} CAP1208EmulatorFaults;
+
+// Faults injected so far
+typedef struct {
+  uint32_t nacks;         // Including those of the bursts
+  uint32_t shortReads;
+  uint32_t resets;
+  uint32_t stretches;
+  uint32_t bursts;
+} CAP1208EmulatorFaultCounts;
+
+/**
+ * @brief Register model of the CAP1208 for the host build, attach it to Wire at CAP1208ADDR.
+ *
+ * Call sense() with the pads under a finger as often as the chip would sample them (every millisecond is fine); the
+ * library then reads the result over the simulated bus. Modelled: Sensor Input Status latched until INT is cleared,
+ * multiple touch blocking, the input and interrupt enables, press, release and repeat alerts (Configuration 2,
+ * Repeat Rate Enable, M_PRESS and RPT_RATE), General Status, the delta counts and the ID registers. With setNoise(),
+ * the delta counts of the free pads change once per measurement cycle of the sampling configuration, as the chip's
+ * do. Not modelled: calibration, the noise flags, standby and the power states. setFaults() makes the bus unreliable,
+ * from a seeded generator so a run can be repeated.
+ */
+class CAP1208Emulator : public HostI2CDevice {
+ public:
+  CAP1208Emulator() { powerOn(); }
+
+  void powerOn();                 // Registers at their reset values, nothing touched
+  void sense(uint8_t fingers);    // One sensing cycle at hostMicros(), bit n = a finger on CS(n + 1)
+  void setNoise(uint8_t counts) { _noise = counts; }  // Deltas of the free pads drawn in +-counts every cycle, 0 = none
+  uint32_t cycleUs() const;       // Measurement cycle of the sampling configuration (Averaging and Sampling, 0x24)
+  bool alert() const { return _regs[0x00] & 0x01; }  // INT set, the ALERT pin is asserted
+  uint8_t reg(uint8_t address) const { return _regs[address]; }
+  uint32_t getRepeats() const { return _repeats; }  // Repeat alerts raised so far
+
+  void setFaults(const CAP1208EmulatorFaults& faults, uint32_t seed = 1);
+  const CAP1208EmulatorFaultCounts& getFaultCounts() const { return _faultCounts; }
+
+  static int readAlert(uint8_t pin, void* emulator);  // Pin reader for hostSetPinReader(), active low
+
+  uint8_t write(const uint8_t* data, size_t length, bool stop) override;
+  size_t read(uint8_t* data, size_t length) override;
+
+ private:
+  uint8_t _regs[256];
+  uint8_t _pointer;
+  uint8_t _detected;  // Inputs reported touched by the last cycle
+  uint8_t _latched;   // Sensor Input Status
+  uint64_t _nextRepeatUs[8];
+  uint32_t _repeats;
+  uint8_t _fingers;   // Pads under a finger at the last sense()
+  uint8_t _noise = 0;
+
+  CAP1208EmulatorFaults _faults = {};
+  CAP1208EmulatorFaultCounts _faultCounts = {};
+  uint32_t _random = 1;
+  uint64_t _busDownUntilUs = 0;
+
+  bool inject(uint32_t ppm);
+  bool busFault();
+  void updateDeltas();
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef TRACECORPUS_H
+#define TRACECORPUS_H
+
+/*
+ * Loading and parallel replay of a corpus of labelled traces (see TouchTrace.h), shared by the host tools.
+ */
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TouchTrace.h"
+
+struct CorpusTrace {
+  std::string path;
+  TouchTrace trace;
+};
+
+/**
+ * @brief Parse a trace file.
+ *
+ * @return false with a "file:line: message" error if a line is malformed or does not fit the trace.
+ */
+inline bool loadTrace(const std::string& path, TouchTrace& trace, std::string& error) {
+  FILE* file = fopen(path.c_str(), "r");
+  if (file == NULL) {
+    error = path + ": cannot open";
+    return false;
+  }
+  trace.clear();
+  char line[256];
+  for (unsigned number = 1; fgets(line, sizeof(line), file) != NULL; number++) {
+    if (!trace.parseLine(line)) {
+      error = path + ":" + std::to_string(number) + ": bad line or trace full: " + line;
+      fclose(file);
+      return false;
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+/**
+ * @brief Load the traces named on the command line; a directory stands for its *.trace files, in name order.
+ */
+inline bool loadCorpus(const std::vector<std::string>& paths, std::vector<CorpusTrace>& corpus, std::string& error) {
+  std::vector<std::string> files;
+  for (const std::string& path : paths) {
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+      DIR* dir = opendir(path.c_str());
+      std::vector<std::string> names;
+      for (dirent* entry; dir != NULL && (entry = readdir(dir)) != NULL;) {
+        std::string name = entry->d_name;
+        if (name.size() > 6 && name.compare(name.size() - 6, 6, ".trace") == 0) {
+          names.push_back(path + "/" + name);
+        }
+      }
+      if (dir != NULL) {
+        closedir(dir);
+      }
+      std::sort(names.begin(), names.end());
+      files.insert(files.end(), names.begin(), names.end());
+    } else {
+      files.push_back(path);
+    }
+  }
+
+  corpus.resize(files.size());
+  for (size_t i = 0; i < files.size(); i++) {
+    corpus[i].path = files[i];
+    if (!loadTrace(files[i], corpus[i].trace, error)) {
+      return false;
+    }
+  }
+  if (corpus.empty()) {
+    error = "no traces";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Replay a corpus on several threads, one TouchSlider each, and merge the scores.
+ *
+ * @param corpus Traces to replay, handed out one at a time to the next free thread.
+ * @param threads Number of threads, 0 for one per core.
+ * @param configure Called once per slider before its first trace (detector, timings...).
+ * @param score Merged score of the whole corpus.
+ * @param perTrace If not NULL, filled with the score of each trace (same order as the corpus).
+ */
+inline void replayCorpus(const std::vector<CorpusTrace>& corpus, unsigned threads,
+                         const std::function<void(TouchSlider&)>& configure, TouchTraceScore& score,
+                         std::vector<TouchTraceScore>* perTrace = NULL) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (perTrace != NULL) {
+    perTrace->assign(corpus.size(), TouchTraceScore());
+  }
+  std::atomic<size_t> next(0);
+  std::mutex merge;
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; t++) {
+    workers.emplace_back([&] {
+      TouchSlider slider(NULL);
+      configure(slider);
+      TouchTraceRunner runner(&slider);
+      TouchTraceScore local;
+      for (size_t i; (i = next++) < corpus.size();) {
+        TouchTraceScore single;
+        runner.run(corpus[i].trace, single);
+        local.merge(single);
+        if (perTrace != NULL) {
+          (*perTrace)[i] = single;
+        }
+      }
+      std::lock_guard<std::mutex> lock(merge);
+      score.merge(local);
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/*
+ * Host build of the library: the part of the Arduino-ESP32 core it uses, on a simulated clock.
+ *
+ * Each thread has its own clock and Tickers, so independent simulations can run in parallel. The clock only moves
+ * with delay(), delayMicroseconds(), the I2C transfers (Wire.h) and hostAdvance(), which also fires the Tickers
+ * that are due, in the calling thread, as the esp_timer task would.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+typedef uint8_t byte;
+typedef bool boolean;
+using std::max;
+using std::min;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define FALLING 0x02
+#define DEC 10
+#define HEX 16
+#define IRAM_ATTR
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Logging is compiled out as in the core below ARDUHAL_LOG_LEVEL_INFO, -D HOST_LOG prints it to stderr
+#ifdef HOST_LOG
+  #define log_e(format, ...) fprintf(stderr, "[E] " format "\n", ##__VA_ARGS__)
+  #define log_w(format, ...) fprintf(stderr, "[W] " format "\n", ##__VA_ARGS__)
+  #define log_i(format, ...) fprintf(stderr, "[I] " format "\n", ##__VA_ARGS__)
+  #define log_d(format, ...) fprintf(stderr, "[D] " format "\n", ##__VA_ARGS__)
+  #define log_v(format, ...) fprintf(stderr, "[V] " format "\n", ##__VA_ARGS__)
+#else
+  #define log_e(format, ...) do {} while (0)
+  #define log_w(format, ...) do {} while (0)
+  #define log_i(format, ...) do {} while (0)
+  #define log_d(format, ...) do {} while (0)
+  #define log_v(format, ...) do {} while (0)
+#endif
+
+// Time, simulated per thread
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+uint64_t hostMicros();           // Simulated time of the calling thread
+void hostAdvance(uint64_t us);   // Move the clock forward, firing the Tickers that are due on the way
+void hostReset();                // Back to time 0 (detach the Tickers first)
+
+// Pins, digitalRead() asks a reader installed per thread (HIGH if none)
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void hostSetPinReader(int (*reader)(uint8_t pin, void* context), void* context);
+#define digitalPinToInterrupt(pin) (pin)
+inline void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {}
+inline void detachInterrupt(uint8_t pin) {}
+
+// Memory, the PSRAM size is chosen per process (0 = no PSRAM, the default)
+bool psramFound();
+void* ps_malloc(size_t size);
+void hostSetPsram(size_t bytes);
+
+class EspClass {
+ public:
+  uint32_t getCycleCount();  // Host time scaled to getCpuFreqMHz()
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getPsramSize();
+  uint32_t getFreePsram();
+};
+extern EspClass ESP;
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str) { return str == NULL ? 0 : write((const uint8_t*)str, strlen(str)); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+  size_t print(const char* str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(T value) { return print(value) + println(); }
+  template <typename T>
+  size_t println(T value, int format) { return print(value, format) + println(); }
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(uint8_t* buffer, size_t length);
+};
+
+// Serial writes to stdout and reads nothing
+class HardwareSerial : public Stream {
+ public:
+  void begin(unsigned long baud) {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int availableForWrite() override { return 1024; }
+  void flush() override;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  operator bool() { return true; }
+};
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,318 @@
+#include <Arduino.h>
+#include <Ticker.h>
+#include <Wire.h>
+
+#include <stdarg.h>
+#include <time.h>
+
+EspClass ESP;
+HardwareSerial Serial;
+TwoWire Wire(0);
+TwoWire Wire1(1);
+
+static thread_local uint64_t clockUs = 0;         // Simulated time of the thread
+static thread_local Ticker* tickers = NULL;       // Attached Tickers of the thread
+static thread_local int (*pinReader)(uint8_t, void*) = NULL;
+static thread_local void* pinContext = NULL;
+static size_t psramBytes = 0;
+
+/*********************** TIME **********************/
+
+unsigned long millis() {
+  return (unsigned long)(clockUs / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)clockUs;
+}
+
+void delay(uint32_t ms) {
+  clockUs += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us) {
+  clockUs += us;
+}
+
+uint64_t hostMicros() {
+  return clockUs;
+}
+
+/**
+ * @brief Move the simulated clock forward by us, firing every Ticker of the thread when it is due.
+ *
+ * A callback runs with the clock at its due time (or later, if the previous callback overran). A periodic Ticker
+ * that fell behind fires once and is rescheduled one period after that, it does not catch up.
+ */
+void hostAdvance(uint64_t us) {
+  uint64_t target = clockUs + us;
+  for (;;) {
+    Ticker* due = NULL;
+    for (Ticker* t = tickers; t != NULL; t = t->_link) {
+      if (t->_nextUs <= target && (due == NULL || t->_nextUs < due->_nextUs)) {
+        due = t;
+      }
+    }
+    if (due == NULL) {
+      break;
+    }
+    if (due->_nextUs > clockUs) {
+      clockUs = due->_nextUs;
+    }
+    void (*callback)(void*) = due->_callback;
+    void* arg = due->_arg;
+    if (due->_repeat) {
+      due->_nextUs += due->_periodUs;
+      if (due->_nextUs <= clockUs) {
+        due->_nextUs = clockUs + due->_periodUs;
+      }
+    } else {
+      due->detach();
+    }
+    callback(arg);
+  }
+  if (target > clockUs) {
+    clockUs = target;
+  }
+}
+
+void hostReset() {
+  clockUs = 0;
+}
+
+void Ticker::arm(uint32_t milliseconds, bool repeat, void (*callback)(void*), void* arg) {
+  detach();
+  _callback = callback;
+  _arg = arg;
+  _periodUs = (uint64_t)milliseconds * 1000;
+  _nextUs = clockUs + _periodUs;
+  _repeat = repeat;
+  _link = tickers;
+  tickers = this;
+}
+
+void Ticker::detach() {
+  for (Ticker** t = &tickers; *t != NULL; t = &(*t)->_link) {
+    if (*t == this) {
+      *t = _link;
+      break;
+    }
+  }
+  _callback = NULL;
+  _link = NULL;
+}
+
+/*********************** PINS **********************/
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {}
+
+int digitalRead(uint8_t pin) {
+  return pinReader != NULL ? pinReader(pin, pinContext) : HIGH;
+}
+
+void hostSetPinReader(int (*reader)(uint8_t pin, void* context), void* context) {
+  pinReader = reader;
+  pinContext = context;
+}
+
+/*********************** MEMORY **********************/
+
+bool psramFound() {
+  return psramBytes != 0;
+}
+
+void* ps_malloc(size_t size) {
+  return size <= psramBytes ? malloc(size) : NULL;
+}
+
+void hostSetPsram(size_t bytes) {
+  psramBytes = bytes;
+}
+
+uint32_t EspClass::getCycleCount() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)(((uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec) * getCpuFreqMHz() / 1000);
+}
+
+uint32_t EspClass::getFreeHeap() {
+  return 280 * 1024;  // Typical of an ESP32 sketch with Wi-Fi off
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+  return 110 * 1024;
+}
+
+uint32_t EspClass::getPsramSize() {
+  return psramBytes;
+}
+
+uint32_t EspClass::getFreePsram() {
+  return psramBytes;
+}
+
+/*********************** PRINT **********************/
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t written = 0;
+  while (size-- != 0 && write(*buffer++) == 1) {
+    written++;
+  }
+  return written;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < 0) {
+    return 0;
+  }
+  if ((size_t)length < sizeof(buffer)) {
+    return write((const uint8_t*)buffer, length);
+  }
+  char* large = (char*)malloc(length + 1);
+  va_start(args, format);
+  vsnprintf(large, length + 1, format, args);
+  va_end(args);
+  size_t written = write((const uint8_t*)large, length);
+  free(large);
+  return written;
+}
+
+size_t Print::print(long n, int base) {
+  if (base == DEC) {
+    return printf("%ld", n);
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  return base == HEX ? printf("%lX", n) : printf("%lu", n);
+}
+
+size_t Print::print(double n, int digits) {
+  return printf("%.*f", digits, n);
+}
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+  size_t count = 0;
+  for (int c; count < length && (c = read()) >= 0;) {
+    buffer[count++] = c;
+  }
+  return count;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() {
+  fflush(stdout);
+}
+
+/*********************** WIRE **********************/
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+  if (frequency != 0) {
+    setClock(frequency);
+  }
+  return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+  _clock = frequency != 0 ? frequency : 100000;
+  return true;
+}
+
+void TwoWire::attach(uint8_t address, HostI2CDevice* device) {
+  for (uint8_t i = 0; i < MAX_DEVICES; i++) {
+    if (_devices[i].device != NULL && _devices[i].address == address) {
+      _devices[i].device = device;
+      return;
+    }
+  }
+  for (uint8_t i = 0; device != NULL && i < MAX_DEVICES; i++) {
+    if (_devices[i].device == NULL) {
+      _devices[i].address = address;
+      _devices[i].device = device;
+      return;
+    }
+  }
+}
+
+HostI2CDevice* TwoWire::device(uint8_t address) const {
+  for (uint8_t i = 0; i < MAX_DEVICES; i++) {
+    if (_devices[i].device != NULL && _devices[i].address == address) {
+      return _devices[i].device;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Advance the clock by the time of a transfer: start, address and data bytes, 9 clocks each.
+ */
+void TwoWire::transfer(size_t bytes) {
+  clockUs += ((uint64_t)(bytes + 1) * 9 * 1000000 + _clock - 1) / _clock;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  _address = address;
+  _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (_txLength >= sizeof(_tx)) {
+    return 0;
+  }
+  _tx[_txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t size) {
+  size_t written = 0;
+  while (written < size && write(data[written]) == 1) {
+    written++;
+  }
+  return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  _transactions++;
+  _repeatedStart = !sendStop;
+  transfer(_txLength);
+  HostI2CDevice* target = device(_address);
+  if (target == NULL) {
+    return 2;
+  }
+  target->busClock = _clock;
+  return target->write(_tx, _txLength, sendStop);
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t size, bool sendStop) {
+  if (size > sizeof(_rx)) {
+    size = sizeof(_rx);
+  }
+  if (!_repeatedStart) {
+    _transactions++;  // A read after endTransmission(false) belongs to the same transaction
+  }
+  _repeatedStart = false;
+  HostI2CDevice* target = device(address);
+  _rxIndex = 0;
+  _rxLength = 0;
+  if (target != NULL) {
+    target->busClock = _clock;
+    _rxLength = target->read(_rx, size);
+  }
+  transfer(_rxLength);
+  return _rxLength;
+}
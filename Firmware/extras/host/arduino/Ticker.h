@@ -0,0 +1,47 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef HOST_TICKER_H
+#define HOST_TICKER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Periodic or one-shot callback on the simulated clock, fired by hostAdvance() of the thread that attached it.
+ */
+class Ticker {
+ public:
+  Ticker() {}
+  ~Ticker() { detach(); }
+
+  void attach_ms(uint32_t milliseconds, void (*callback)()) { arm(milliseconds, true, (void (*)(void*))callback, NULL); }
+  template <typename TArg>
+  void attach_ms(uint32_t milliseconds, void (*callback)(TArg), TArg arg) {
+    static_assert(sizeof(TArg) <= sizeof(void*), "attach_ms() callback argument size must be <= sizeof(void*)");
+    arm(milliseconds, true, (void (*)(void*))callback, (void*)arg);
+  }
+  template <typename TArg>
+  void once_ms(uint32_t milliseconds, void (*callback)(TArg), TArg arg) {
+    static_assert(sizeof(TArg) <= sizeof(void*), "once_ms() callback argument size must be <= sizeof(void*)");
+    arm(milliseconds, false, (void (*)(void*))callback, (void*)arg);
+  }
+  void detach();
+  bool active() const { return _callback != NULL; }
+
+ private:
+  friend void hostAdvance(uint64_t us);
+
+  void (*_callback)(void*) = NULL;
+  void* _arg = NULL;
+  uint64_t _periodUs = 0;
+  uint64_t _nextUs = 0;
+  bool _repeat = false;
+  Ticker* _link = NULL;  // Next attached Ticker of the thread
+
+  void arm(uint32_t milliseconds, bool repeat, void (*callback)(void*), void* arg);
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+/**
+ * @brief A device on the simulated bus, e.g. the CAP1208 emulator (see CAP1208Emulator.h).
+ */
+class HostI2CDevice {
+ public:
+  virtual ~HostI2CDevice() {}
+  virtual uint8_t write(const uint8_t* data, size_t length, bool stop) = 0;  // endTransmission() status, 0 = ACK
+  virtual size_t read(uint8_t* data, size_t length) = 0;                    // Bytes returned to requestFrom()
+
+  uint32_t busClock = 100000;  // Clock of the transaction in progress, set by TwoWire
+};
+
+/**
+ * @brief I2C master of the host build.
+ *
+ * Transactions go to the device attached at the address (an address without a device NACKs, status 2) and advance
+ * the simulated clock by the time of their bits at the bus clock.
+ */
+class TwoWire : public Stream {
+ public:
+  TwoWire(uint8_t bus = 0) {}
+
+  bool begin() { return true; }
+  bool begin(int sda, int scl, uint32_t frequency = 0);
+  bool setClock(uint32_t frequency);
+  uint32_t getClock() { return _clock; }
+  void setTimeOut(uint16_t timeOutMillis) { _timeOut = timeOutMillis; }
+  uint16_t getTimeOut() { return _timeOut; }
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t requestFrom(uint8_t address, size_t size, bool sendStop = true);
+  size_t write(uint8_t data) override;
+  size_t write(const uint8_t* data, size_t size) override;
+  using Print::write;
+  int available() override { return _rxLength - _rxIndex; }
+  int read() override { return _rxIndex < _rxLength ? _rx[_rxIndex++] : -1; }
+  int peek() override { return _rxIndex < _rxLength ? _rx[_rxIndex] : -1; }
+
+  void attach(uint8_t address, HostI2CDevice* device);  // NULL to remove it
+  uint32_t transactions() const { return _transactions; }  // Register writes and register reads so far
+
+ private:
+  static const uint8_t MAX_DEVICES = 4;
+  struct {
+    uint8_t address;
+    HostI2CDevice* device;
+  } _devices[MAX_DEVICES] = {};
+  uint32_t _clock = 100000;
+  uint16_t _timeOut = 50;
+  uint8_t _address = 0;
+  uint8_t _tx[I2C_BUFFER_LENGTH];
+  size_t _txLength = 0;
+  uint8_t _rx[I2C_BUFFER_LENGTH];
+  size_t _rxLength = 0;
+  size_t _rxIndex = 0;
+  uint32_t _transactions = 0;
+  bool _repeatedStart = false;
+
+  HostI2CDevice* device(uint8_t address) const;
+  void transfer(size_t bytes);
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif
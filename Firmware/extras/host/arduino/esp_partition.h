@@ -0,0 +1,42 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef HOST_ESP_PARTITION_H
+#define HOST_ESP_PARTITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The host has no flash partitions: esp_partition_find_first() always fails
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0x00, ESP_PARTITION_TYPE_DATA = 0x01 } esp_partition_type_t;
+typedef enum { ESP_PARTITION_SUBTYPE_ANY = 0xff } esp_partition_subtype_t;
+typedef struct {
+  esp_partition_type_t type;
+  uint32_t address;
+  uint32_t size;
+  uint32_t erase_size;
+  char label[17];
+} esp_partition_t;
+
+inline const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                       const char* label) {
+  return NULL;
+}
+inline esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+  return ESP_FAIL;
+}
+inline esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size) {
+  return ESP_FAIL;
+}
+inline esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+  return ESP_FAIL;
+}
+
+#endif
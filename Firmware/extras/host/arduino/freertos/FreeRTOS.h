@@ -0,0 +1,32 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+
+// Critical sections are spinlocks, so the host threads exclude each other as the two cores of the ESP32 do
+typedef struct {
+  uint32_t owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+inline void hostEnterCritical(portMUX_TYPE* mux) {
+  while (__atomic_exchange_n(&mux->owner, 1, __ATOMIC_ACQUIRE) != 0) {
+  }
+}
+inline void hostExitCritical(portMUX_TYPE* mux) {
+  __atomic_store_n(&mux->owner, 0, __ATOMIC_RELEASE);
+}
+
+#define portENTER_CRITICAL(mux) hostEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) hostExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) hostEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) hostExitCritical(mux)
+
+#endif
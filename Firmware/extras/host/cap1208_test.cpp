@@ -0,0 +1,189 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Checks of the CAP1208 driver against the emulated chip (CAP1208Emulator.h).
+ *
+ *   cap1208_test
+ *
+ * The bus clock: begin() with autoTuneClock probes the steps up to the fastest one the chip answers at, and when the
+ * errors rise above CAP1208_ERROR_THRESHOLD in a window of normal transactions the clock goes down one step and stays
+ * there, never below the slowest step. The register updates: a field written while the read of its register fails
+ * must leave the register alone instead of clearing its other fields. The acquisition profiles: measureProfile()
+ * must report the measurement cycle of the emulated chip for each preset, and with setAutoProfiles() every switch
+ * must be applied whole by the update that needs it. The exit status is 0 on success and 1 on a failure.
+ */
+
+#include "CAP1208Emulator.h"
+#include "CAP1208.h"
+#include "TouchSlider.h"
+
+static bool check(bool ok, const char* what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  return ok;
+}
+
+/**
+ * @brief Run some error-rate windows of register reads.
+ */
+static void readWindows(CAP1208& sensor, uint8_t windows) {
+  for (uint32_t i = 0; i < windows * CAP1208_ERROR_WINDOW; i++) {
+    sensor.checkStatus();
+  }
+}
+
+static bool checkBusClock() {
+  bool ok = true;
+  for (uint32_t limit : {0UL, 300000UL, 200000UL}) {
+    hostReset();
+    TwoWire wire;
+    CAP1208Emulator chip;
+    wire.attach(CAP1208ADDR, &chip);
+    CAP1208EmulatorFaults faults = {};
+    faults.maxClockHz = limit;
+    chip.setFaults(faults);
+    CAP1208 sensor;
+    bool begun = sensor.begin(wire, CAP1208ADDR, true);
+    uint32_t expected = limit != 0 ? limit : 400000;
+    printf("chip limit %lu Hz: tuned to %lu Hz, %u us per register read\n", (unsigned long)limit,
+           (unsigned long)sensor.getBusClock(), sensor.getTransactionTimeUs());
+    ok &= begun && sensor.getBusClock() == expected && wire.getClock() == expected;
+  }
+  ok = check(ok, "begin() tunes the clock to the fastest step the chip answers at");
+
+  hostReset();
+  TwoWire wire;
+  CAP1208Emulator chip;
+  wire.attach(CAP1208ADDR, &chip);
+  CAP1208 sensor;
+  sensor.begin(wire, CAP1208ADDR, true);
+
+  // The bus degrades at 400 kHz: every transaction fails until the clock steps down
+  CAP1208EmulatorFaults faults = {};
+  faults.maxClockHz = 300000;
+  chip.setFaults(faults);
+  readWindows(sensor, 1);
+  uint32_t afterErrors = sensor.getBusClock();
+  uint32_t errors = sensor.getI2CErrors();
+  readWindows(sensor, 8);
+  printf("bus limited to 300 kHz: clock %lu Hz after one window, %lu Hz after 8 more, %lu errors\n",
+         (unsigned long)afterErrors, (unsigned long)sensor.getBusClock(), (unsigned long)sensor.getI2CErrors());
+  ok &= check(afterErrors == 300000 && wire.getClock() == 300000 && sensor.getI2CErrors() == errors,
+              "the errors of one window step the clock down once, then it stays");
+
+  // Random NACKs below the threshold leave it alone
+  faults = CAP1208EmulatorFaults();
+  faults.nackPpm = 1000;  // 0.26 errors per window
+  chip.setFaults(faults, 7);
+  readWindows(sensor, 8);
+  ok &= check(sensor.getBusClock() == 300000, "errors below the threshold keep the clock");
+
+  // Nothing works any more: down to the slowest step and no further
+  faults = CAP1208EmulatorFaults();
+  faults.maxClockHz = 50000;
+  chip.setFaults(faults);
+  readWindows(sensor, 8);
+  ok &= check(sensor.getBusClock() == 100000 && wire.getClock() == 100000, "the clock never goes below 100 kHz");
+  return ok;
+}
+
+static bool checkUpdateRegister() {
+  hostReset();
+  TwoWire wire;
+  CAP1208Emulator chip;
+  wire.attach(CAP1208ADDR, &chip);
+  CAP1208 sensor;
+  sensor.begin(wire);
+  uint8_t before = chip.reg(SENSITIVITY);  // DELTA_SENSE and BASE_SHIFT
+
+  CAP1208EmulatorFaults faults = {};
+  faults.shortReadPpm = 1000000;  // Every read fails, the writes go through
+  chip.setFaults(faults);
+  sensor.setSensitivity(SENSITIVITY_8X);
+  uint8_t failed = chip.reg(SENSITIVITY);
+  chip.setFaults(CAP1208EmulatorFaults());
+  sensor.setSensitivity(SENSITIVITY_8X);
+  uint8_t updated = chip.reg(SENSITIVITY);
+  printf("sensitivity register 0x%02X, 0x%02X after a failed update, 0x%02X after an update\n", before, failed,
+         updated);
+  return check(failed == before && updated == ((before & 0x0F) | SENSITIVITY_8X << 4),
+               "a failed read skips the write of the update");
+}
+
+/**
+ * @brief Whether the chip runs with exactly this profile (Configuration noise filters, sampling, recalibration).
+ */
+static bool hasProfile(const CAP1208Emulator& chip, const CAP1208_Profile& profile) {
+  const uint8_t noiseMask = CONFIG1_DIS_DIG_NOISE::mask | CONFIG1_DIS_ANA_NOISE::mask;
+  uint8_t sampling = (AVERAGE_SAMP_AVG::of(profile.averaging) | AVERAGE_SAMP_SAMP_TIME::of(profile.sampleTime) |
+                      AVERAGE_SAMP_CYCLE_TIME::of(profile.cycleTime)).bits;
+  return (chip.reg(CONFIG1) & noiseMask) == (profile.noiseFilters ? 0 : noiseMask) &&
+         (chip.reg(AVERAGE_SAMP_CONF) & 0x7F) == sampling &&
+         (chip.reg(RECALCONFIG) & RECALCONFIG_CAL_CFG::mask) == RECALCONFIG_CAL_CFG::of(profile.recalibration).bits;
+}
+
+static bool checkProfiles() {
+  hostReset();
+  TwoWire wire;
+  CAP1208Emulator chip;
+  wire.attach(CAP1208ADDR, &chip);
+  chip.setNoise(3);
+  CAP1208 sensor;
+  sensor.begin(wire);
+  bool measured = true;
+  for (const CAP1208_Profile& profile : CAP1208_PROFILES) {
+    CAP1208_ProfileReport report;
+    bool ok = sensor.measureProfile(profile, report);
+    int32_t errorUs = (int32_t)(report.cycleUs - chip.cycleUs());
+    printf("%-11s cycle %5.1f ms (emulated %5.1f ms), noise rms %.2f peak %u counts\n", profile.name,
+           report.cycleUs / 1000.0, chip.cycleUs() / 1000.0, report.noiseRms[0] / 16.0, report.noisePeak[0]);
+    measured &= ok && hasProfile(chip, profile) && abs(errorUs) <= (int32_t)chip.cycleUs() / 50;
+  }
+  bool pass = check(measured, "measureProfile() reports the cycle time of each preset within 2%");
+
+  // Low-power while idle, low-latency while touched
+  const CAP1208_Profile& idle = CAP1208_PROFILES[CAP1208_PROFILE_LOW_POWER];
+  const CAP1208_Profile& active = CAP1208_PROFILES[CAP1208_PROFILE_LOW_LATENCY];
+  TouchSlider slider(&sensor);
+  slider.disablePrintSwipeStatus();
+  slider.start();
+  slider.setAutoProfiles(idle, active, 500);
+  uint32_t updates = 0, switches = 0, partial = 0, late = 0;
+  const CAP1208_Profile* applied = slider.getProfile();
+  TouchSliderSnapshot previous;
+  slider.getSnapshot(previous);
+  for (uint32_t ms = 0; ms < 20000; ms++) {
+    chip.sense(ms % 2000 >= 1000 && ms % 2000 < 1300 ? 0x08 : 0);  // A 300 ms touch every 2 s
+    hostAdvance(1000);
+    TouchSliderSnapshot now;
+    slider.getSnapshot(now);
+    if (now.frame == previous.frame) {
+      continue;
+    }
+    // The update that saw the first touch (or the release timeout) left the chip on the new profile
+    updates++;
+    bool onIdle = hasProfile(chip, idle);
+    bool onActive = hasProfile(chip, active);
+    partial += !onIdle && !onActive;
+    late += now.padMask != 0 && !onActive;
+    switches += slider.getProfile() != applied;
+    applied = slider.getProfile();
+    previous = now;
+  }
+  slider.stop();
+  printf("auto profiles: %lu updates, %lu switches, %lu on a partial profile, %lu touched updates not on the active "
+         "profile\n", (unsigned long)updates, (unsigned long)switches, (unsigned long)partial, (unsigned long)late);
+  pass &= check(switches == 20 && partial == 0 && late == 0,
+                "each touch switches to the active profile and back, applied whole by the update that needs it");
+  return pass;
+}
+
+int main() {
+  bool ok = checkBusClock();
+  ok &= checkUpdateRegister();
+  ok &= checkProfiles();
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Rebuilds the time series of a drift log dump (SliderDrift, format in SliderDriftDecoder.h) as CSV, oldest sample
+ * first.
+ *
+ *   drift_decode [-s sector size] <dump>
+ *
+ * The dump is the raw content of the storage, e.g. of the flash partition:
+ *
+ *   parttool.py read_partition --partition-name <label> --output drift.bin
+ *
+ * Sectors are put back in the order they were written (sector sequence numbers), whatever their place in the ring.
+ * A summary goes to stderr: sectors, samples and sessions decoded, sectors missing between the ones kept (gaps in
+ * the sequence numbers) and sectors that end on a corrupt record. Built without the Arduino core.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "SliderDriftDecoder.h"
+
+struct Sector {
+  uint32_t sequence;
+  size_t offset;
+};
+
+int main(int argc, char** argv) {
+  size_t sectorSize = 4096;  // SLIDER_DRIFT_SECTOR_SIZE
+  const char* path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      sectorSize = strtoul(argv[++i], NULL, 0);
+    } else if (argv[i][0] != '-' && path == NULL) {
+      path = argv[i];
+    } else {
+      path = NULL;
+      break;
+    }
+  }
+  if (path == NULL || sectorSize < SLIDER_DRIFT_HEADER_SIZE) {
+    fprintf(stderr, "usage: drift_decode [-s sector size] <dump>\n");
+    return 2;
+  }
+
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    perror(path);
+    return 2;
+  }
+  std::vector<uint8_t> dump;
+  uint8_t buffer[4096];
+  for (size_t n; (n = fread(buffer, 1, sizeof(buffer), file)) > 0;) {
+    dump.insert(dump.end(), buffer, buffer + n);
+  }
+  fclose(file);
+
+  std::vector<Sector> sectors;
+  for (size_t offset = 0; offset + sectorSize <= dump.size(); offset += sectorSize) {
+    uint32_t sequence;
+    if (SliderDriftDecoder::readHeader(&dump[offset], sectorSize, sequence)) {
+      sectors.push_back({sequence, offset});
+    }
+  }
+  std::sort(sectors.begin(), sectors.end(), [](const Sector& a, const Sector& b) { return a.sequence < b.sequence; });
+
+  char line[160];
+  SliderDriftDecoder::formatCsvHeader(line, sizeof(line));
+  puts(line);
+  uint32_t samples = 0, sessions = 0, gaps = 0, corrupt = 0;
+  uint32_t session = 0;
+  for (size_t i = 0; i < sectors.size(); i++) {
+    if (i > 0) {
+      gaps += sectors[i].sequence - sectors[i - 1].sequence - 1;
+    }
+    SliderDriftDecoder decoder;
+    SliderDriftSample sample;
+    decoder.begin(&dump[sectors[i].offset], sectorSize);
+    while (decoder.next(sample)) {
+      if (samples == 0 || decoder.getSession() != session) {
+        session = decoder.getSession();
+        sessions++;
+      }
+      SliderDriftDecoder::formatCsv(line, sizeof(line), decoder.getSession(), sample);
+      puts(line);
+      samples++;
+    }
+    corrupt += decoder.isCorrupt();
+  }
+  fprintf(stderr, "sectors %zu, samples %lu, sessions %lu, sectors missing %lu, corrupt %lu\n", sectors.size(),
+          (unsigned long)samples, (unsigned long)sessions, (unsigned long)gaps, (unsigned long)corrupt);
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Round trip of the drift log: SliderDrift records three sessions into a RAM ring small enough to wrap, the ring
+ * is dumped to a file and drift_decode must rebuild the same series as SliderDrift::printCsv(), ending with the
+ * samples recorded last (the delta counts within the deadband).
+ *
+ *   drift_test [path of drift_decode]
+ *
+ * The exit status is 0 on success, 1 on a mismatch and 2 if the test cannot run.
+ */
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "SliderDrift.h"
+
+#define SECTORS 3
+#define SESSIONS 3
+#define SAMPLES 2000  // Per session
+
+class StringPrint : public Print {
+ public:
+  size_t write(uint8_t c) override {
+    text += (char)c;
+    return 1;
+  }
+  using Print::write;
+  std::string text;
+};
+
+static std::vector<std::string> lines(const std::string& text) {
+  std::vector<std::string> result;
+  for (size_t start = 0, end; (end = text.find('\n', start)) != std::string::npos; start = end + 1) {
+    result.push_back(text.substr(start, end - start));
+    if (!result.back().empty() && result.back().back() == '\r') {
+      result.back().pop_back();
+    }
+  }
+  return result;
+}
+
+static bool check(bool ok, const char* what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  std::string self = argv[0];
+  std::string decoderPath = argc > 1 ? argv[1] : self.substr(0, self.rfind('/') + 1) + "drift_decode";
+
+  SliderDriftRamStorage storage(SECTORS * SLIDER_DRIFT_SECTOR_SIZE);
+  std::vector<SliderDriftSample> recorded;
+  std::vector<uint32_t> sessions;
+  StringPrint printed;
+  uint32_t now = 0;
+  uint32_t seed = 1;
+  for (int session = 0; session < SESSIONS; session++) {
+    SliderDrift drift(storage, 1000);
+    if (!drift.begin()) {
+      fprintf(stderr, "SliderDrift::begin() failed\n");
+      return 2;
+    }
+    for (int i = 0; i < SAMPLES; i++) {
+      SliderDriftSample sample;
+      for (int pad = 0; pad < SLIDER_DRIFT_PADS; pad++) {
+        seed = seed * 1103515245 + 12345;
+        sample.base[pad] = 100 + pad + i / 400;           // Slow drift of the base counts
+        sample.delta[pad] = (int8_t)((seed >> 16) % 5) - 2;  // Idle noise, inside the deadband
+      }
+      sample.flags[SLIDER_DRIFT_NOISE] = i % 97 == 0;
+      sample.flags[SLIDER_DRIFT_CALIBRATION] = 0;
+      sample.flags[SLIDER_DRIFT_BASE_OUT] = 0;
+      sample.flags[SLIDER_DRIFT_STATUS] = i % 500 == 0 ? 0x20 : 0;
+      now += 1000;
+      drift.post(sample, now);
+      drift.flush();
+      recorded.push_back(sample);
+      sessions.push_back(drift.getSession());
+    }
+    if (session == SESSIONS - 1) {
+      drift.printCsv(printed);
+    }
+  }
+
+  char dumpPath[] = "/tmp/drift_dump_XXXXXX";
+  int fd = mkstemp(dumpPath);
+  FILE* dump = fdopen(fd, "wb");
+  uint8_t sector[SLIDER_DRIFT_SECTOR_SIZE];
+  for (uint16_t i = 0; i < storage.sectorCount(); i++) {
+    storage.read((uint32_t)i * SLIDER_DRIFT_SECTOR_SIZE, sector, sizeof(sector));
+    fwrite(sector, 1, sizeof(sector), dump);
+  }
+  fclose(dump);
+
+  StringPrint decoded;
+  std::string command = decoderPath + " " + dumpPath + " 2>/dev/null";
+  FILE* pipe = popen(command.c_str(), "r");
+  if (pipe == NULL) {
+    unlink(dumpPath);
+    return 2;
+  }
+  char buffer[4096];
+  for (size_t n; (n = fread(buffer, 1, sizeof(buffer), pipe)) > 0;) {
+    decoded.text.append(buffer, n);
+  }
+  int status = pclose(pipe);
+  unlink(dumpPath);
+  if (status != 0) {
+    fprintf(stderr, "%s did not run (status %d)\n", decoderPath.c_str(), status);
+    return 2;
+  }
+
+  // The deadband leaves the delta counts of the log up to SLIDER_DRIFT_DELTA_DEADBAND away from the samples
+  std::vector<std::string> rows = lines(decoded.text);
+  size_t kept = rows.size() - 1;
+  uint32_t mismatches = 0;
+  for (size_t k = 0; k < kept && kept <= recorded.size(); k++) {
+    unsigned long session, time;
+    unsigned base[SLIDER_DRIFT_PADS];
+    int delta[SLIDER_DRIFT_PADS];
+    const SliderDriftSample& sample = recorded[recorded.size() - kept + k];
+    bool same = sscanf(rows[k + 1].c_str(), "%lu,%lu,%u,%u,%u,%u,%u,%u,%u,%u,%d,%d,%d,%d,%d,%d,%d,%d", &session, &time,
+                       &base[0], &base[1], &base[2], &base[3], &base[4], &base[5], &base[6], &base[7], &delta[0],
+                       &delta[1], &delta[2], &delta[3], &delta[4], &delta[5], &delta[6], &delta[7]) == 18 &&
+                session == sessions[recorded.size() - kept + k];
+    for (int pad = 0; same && pad < SLIDER_DRIFT_PADS; pad++) {
+      same = base[pad] == sample.base[pad] && abs(delta[pad] - sample.delta[pad]) <= SLIDER_DRIFT_DELTA_DEADBAND;
+    }
+    mismatches += !same;
+  }
+
+  printf("%zu samples recorded, %zu kept in %u sectors, %u mismatches\n", recorded.size(), kept, SECTORS, mismatches);
+  bool ok = check(kept > SAMPLES && kept < recorded.size(), "the ring wrapped and kept more than a session");
+  ok &= check(lines(decoded.text) == lines(printed.text), "drift_decode matches SliderDrift::printCsv()");
+  ok &= check(mismatches == 0, "the series ends with the samples recorded last");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Frame time of SliderEffects on the host, per combination of effects and strip length.
+ *
+ *   fx_bench [frames]
+ *
+ * Each case replays the same scripted touches (a swipe across the pads, taps on both ends, idle gaps) with the level
+ * bar following the finger, through show() into a strip that only counts what it receives. It prints the average
+ * time per frame (the worst frame on a PC is the scheduler's), and the pixels and strip updates sent per frame: the skipped updates are what the dirty
+ * masks save. Host times are no substitute for the target (getFrameCycles() there), but they compare the cases.
+ */
+
+#include <chrono>
+
+#include "SliderEffects.h"
+
+/**
+ * @brief Stand-in for Adafruit_NeoPixel that counts the pixels and the updates sent.
+ */
+struct CountingStrip {
+  uint64_t pixels = 0;
+  uint64_t shows = 0;
+  void setPixelColor(uint16_t i, uint32_t color) { pixels++; }
+  void show() { shows++; }
+};
+
+static const uint8_t SCRIPT[] = {0x00, 0x00, 0x01, 0x03, 0x02, 0x06, 0x04, 0x0C, 0x08, 0x18, 0x10, 0x30, 0x20, 0x60,
+                                 0x40, 0xC0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x80, 0x80,
+                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+static const struct {
+  const char* name;
+  uint8_t effects;
+} CASES[] = {
+    {"touch", 0},
+    {"rainbow", SLIDER_FX_RAINBOW},
+    {"bar", SLIDER_FX_BAR},
+    {"rainbow trail", SLIDER_FX_RAINBOW | SLIDER_FX_TRAIL},
+    {"rainbow ripple", SLIDER_FX_RAINBOW | SLIDER_FX_RIPPLE},
+    {"all", SLIDER_FX_BAR | SLIDER_FX_RAINBOW | SLIDER_FX_TRAIL | SLIDER_FX_RIPPLE},
+};
+
+int main(int argc, char** argv) {
+  uint32_t frames = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000000;
+  printf("%-15s %6s %10s %12s %12s\n", "effects", "pixels", "ns/frame", "pixels/frame", "shows/frame");
+  for (uint8_t pixels : {8, 32}) {
+    for (const auto& c : CASES) {
+      SliderEffects fx(pixels);
+      fx.setEffects(c.effects);
+      fx.setLightness(128);
+      CountingStrip strip;
+      auto start = std::chrono::steady_clock::now();
+      for (uint32_t f = 0; f < frames; f++) {
+        uint8_t mask = SCRIPT[f % sizeof(SCRIPT)];
+        fx.setTouch(mask);
+        if (mask != 0) {
+          fx.setLevel(__builtin_ctz(mask) * 255 / 7);
+        }
+        fx.show(strip);
+      }
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+      printf("%-15s %6u %10.1f %12.2f %12.3f\n", c.name, pixels, ns, (double)strip.pixels / frames,
+             (double)strip.shows / frames);
+    }
+  }
+  return 0;
+}
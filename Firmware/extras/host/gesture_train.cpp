@@ -0,0 +1,200 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Host version of examples/GestureTrainer.ino: trains the gesture classifier, writes the model and compares it with
+ * the heuristics, the tracker and the built-in model.
+ *
+ *   gesture_train [-n traces] [-d depth] [-l min leaf] [-s seed] [-o model.h] [-j threads] [dir or .trace]...
+ *
+ * The training set is -n generated traces (4 random gestures each, as in the example, drawn from -s seed) plus the
+ * even traces of the corpus given; the test set is as many other generated traces plus the odd traces of the corpus.
+ * The model goes to stdout, or to the -o file, with the command line that trains it again: the shipped one is
+ * gesture_train -o ../../SliderGestureModel.h ../traces, run from extras/host. The comparison prints precision, recall
+ * and detection latency per gesture class on the test set and the replay time per frame, and goes to stderr when the
+ * model is on stdout. The exit status is 0 on success and 2 on a usage or corpus error.
+ */
+
+#include <chrono>
+
+#include "SliderTrainer.h"
+#include "TraceCorpus.h"
+
+static const char* const CLASS_NAMES[TRACE_CLASS_COUNT] = {"swipe", "fine", "tap"};
+
+/**
+ * @brief Print to a stdio file.
+ */
+class FilePrint : public Print {
+ public:
+  explicit FilePrint(FILE* file) : _file(file) {}
+  size_t write(uint8_t c) override { return fputc(c, _file) == EOF ? 0 : 1; }
+  using Print::write;
+
+ private:
+  FILE* _file;
+};
+
+// 4 random gestures (swipes from slow to fast flicks, edge taps, middle taps), as randomGestures() of the example
+static void randomGestures(TouchTraceGenerator& generator, uint32_t& seed, TouchTrace& trace) {
+  trace.clear();
+  for (uint8_t i = 0; i < 4; i++) {
+    seed = seed * 1664525 + 1013904223;
+    uint8_t from = (seed >> 8) % 8;
+    uint8_t to = (from + 1 + (seed >> 12) % 7) % 8;
+    switch ((seed >> 24) % 4) {
+      case 0:
+      case 1:
+        generator.swipe(trace, from, to, (seed >> 16) & 0x01 ? 2 + (seed >> 4) % 14 : 16 + (seed >> 4) % 56);
+        break;
+      case 2:
+        generator.edgeTap(trace, (seed >> 16) & 0x01, 1 + (seed >> 4) % 6);
+        break;
+      default:
+        generator.tap(trace, 1 + (seed >> 4) % 6, 1 + (seed >> 20) % 8);
+        break;
+    }
+  }
+}
+
+static void generate(std::vector<CorpusTrace>& traces, uint32_t count, uint32_t generatorSeed, uint32_t seed) {
+  TouchTraceGenerator generator(generatorSeed);
+  for (uint32_t i = 0; i < count; i++) {
+    generator.setNoise((i % 4) * 20);  // Dropped frames and flickering neighbours
+    generator.setDeltas(i % 2);
+    traces.emplace_back();
+    traces.back().path = "generated";
+    randomGestures(generator, seed, traces.back().trace);
+  }
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: gesture_train [-n traces] [-d depth] [-l min leaf] [-s seed] [-o model.h] [-j threads] [dir or .trace]...\n");
+}
+
+int main(int argc, char** argv) {
+  uint32_t generated = 2000;
+  unsigned depth = SLIDER_CLASSIFIER_MAX_DEPTH;
+  unsigned minLeaf = SLIDER_TRAINER_MIN_LEAF;
+  uint32_t seed = 7;
+  unsigned threads = 1;  // One thread keeps the time per frame comparable
+  std::string modelPath;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-n" && i + 1 < argc) {
+      generated = atoi(argv[++i]);
+    } else if (arg == "-d" && i + 1 < argc) {
+      depth = atoi(argv[++i]);
+    } else if (arg == "-l" && i + 1 < argc) {
+      minLeaf = atoi(argv[++i]);
+    } else if (arg == "-s" && i + 1 < argc) {
+      seed = strtoul(argv[++i], NULL, 0);
+    } else if (arg == "-o" && i + 1 < argc) {
+      modelPath = argv[++i];
+    } else if (arg == "-j" && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    } else if (arg[0] == '-') {
+      usage();
+      return 2;
+    } else {
+      paths.push_back(arg);
+    }
+  }
+
+  std::vector<CorpusTrace> corpus;
+  std::string error;
+  if (!paths.empty() && !loadCorpus(paths, corpus, error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return 2;
+  }
+  std::vector<CorpusTrace> training, test;
+  generate(training, generated, 1, seed);
+  generate(test, generated, 99, 12345);
+  for (size_t i = 0; i < corpus.size(); i++) {
+    (i % 2 == 0 ? training : test).push_back(corpus[i]);
+  }
+
+  hostSetPsram(64UL << 20);  // The samples go to "PSRAM", as on a board that has it
+  SliderTrainer trainer(1UL << 18);  // Every sample of the training set
+  if (!trainer.begin()) {
+    return 2;
+  }
+  for (const CorpusTrace& t : training) {
+    trainer.addTrace(t.trace);
+  }
+  if (!trainer.train(depth, minLeaf)) {
+    fprintf(stderr, "no samples\n");
+    return 2;
+  }
+
+  FILE* model = modelPath.empty() ? stdout : fopen(modelPath.c_str(), "w");
+  if (model == NULL) {
+    fprintf(stderr, "%s: cannot open\n", modelPath.c_str());
+    return 2;
+  }
+  // Every option that changes the model, with its value, so that the header says how to train it again
+  std::string command = "gesture_train -n " + std::to_string(generated) + " -d " + std::to_string(depth) + " -l " +
+                        std::to_string(minLeaf) + " -s " + std::to_string(seed);
+  for (const std::string& path : paths) {
+    command += " " + path;
+  }
+  FilePrint modelOut(model);
+  trainer.printModel(modelOut, command.c_str());
+  if (model != stdout) {
+    fclose(model);
+  }
+
+  FILE* report = model == stdout ? stderr : stdout;
+  fprintf(report, "trained on %zu traces, %lu samples (%lu swipe, %lu fine), %u nodes; tested on %zu traces\n",
+          training.size(), (unsigned long)trainer.getSamples(),
+          (unsigned long)(trainer.getClassSamples(SLIDER_CLASS_SWIPE_UP) + trainer.getClassSamples(SLIDER_CLASS_SWIPE_DOWN)),
+          (unsigned long)(trainer.getClassSamples(SLIDER_CLASS_SWIPE_FINE_UP) +
+                          trainer.getClassSamples(SLIDER_CLASS_SWIPE_FINE_DOWN)),
+          trainer.getNodes(), test.size());
+
+  size_t frames = 0;
+  for (const CorpusTrace& t : test) {
+    frames += t.trace.nextTick() + TOUCH_TRACE_TAIL;
+  }
+  struct {
+    const char* name;
+    std::function<void(TouchSlider&)> configure;
+  } detectors[] = {
+      {"heuristics", [](TouchSlider& slider) { slider.enableSwipeFine(); }},
+      {"tracker", [](TouchSlider& slider) {
+         slider.enableSwipeFine();
+         slider.enableTracker();
+       }},
+      {"built-in model", [](TouchSlider& slider) {
+         slider.enableSwipeFine();
+         slider.enableClassifier();
+       }},
+      {"trained model", [&trainer](TouchSlider& slider) {
+         slider.enableSwipeFine();
+         slider.enableClassifier();
+         slider.setClassifierModel(trainer.getTree(), trainer.getNodes());
+       }},
+  };
+  fprintf(report, "%-15s %-5s %9s %6s %7s %11s\n", "detector", "class", "precision", "recall", "latency", "ns/frame");
+  for (const auto& detector : detectors) {
+    TouchTraceScore score;
+    auto start = std::chrono::steady_clock::now();
+    replayCorpus(test, threads, detector.configure, score);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() * threads / frames;
+    for (uint8_t c = 0; c < TRACE_CLASS_COUNT; c++) {
+      fprintf(report, "%-15s %-5s %9.3f %6.3f %7.2f", c == 0 ? detector.name : "", CLASS_NAMES[c],
+              score.precision((TouchTraceClass)c), score.recall((TouchTraceClass)c),
+              score.averageLatency((TouchTraceClass)c));
+      if (c == 0) {
+        fprintf(report, " %11.0f", ns);
+      }
+      fprintf(report, "\n");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Press, repeat and release events of the pads on an emulated CAP1208, in the three ways TouchSlider can get them.
+ *
+ *   pad_events_test [seconds]
+ *
+ * The same random taps (40% shorter than one update) and holds (some long enough to repeat) run with the frame
+ * differences, with enablePadEvents() and with enablePadEvents() on the ALERT pin. Every touch must give one press
+ * and then one release, in every mode. The pad events must report the repeats of the chip and the releases sooner,
+ * and need fewer I2C transactions per update, fewer still with ALERT. The repeats must also reach the telemetry,
+ * whose events are 16 bits wide since SLIDER_EVENT_REPEAT is bit 10. The exit status is 0 on success and 1 on a
+ * failure.
+ */
+
+#include "CAP1208Emulator.h"
+#include "TouchSlider.h"
+
+#define ALERT_PIN 4
+
+enum PadEventsMode { FRAME_DIFFERENCES, PAD_EVENTS, PAD_EVENTS_ALERT, MODES };
+static const char* const MODE_NAMES[MODES] = {"frame differences", "pad events", "pad events + ALERT"};
+
+struct Result {
+  uint32_t touches;
+  uint32_t presses;
+  uint32_t releases;
+  uint32_t repeats;
+  uint32_t orderErrors;  // Press of a pad already down, release of a pad not down
+  uint32_t chipRepeats;
+  uint32_t telemetryRepeats;  // Telemetry frames decoded with the repeat bit
+  uint64_t releaseLatencyUs;  // Sum, from the end of the touch
+  uint32_t frames;
+  uint32_t transactions;
+};
+
+struct Recorder {
+  Result* result;
+  bool down[8];
+  uint64_t touchEndUs[8];
+};
+
+static void onPadEvent(const TouchSliderEvent& event, void* context) {
+  Recorder* recorder = static_cast<Recorder*>(context);
+  Result& result = *recorder->result;
+  switch (event.type) {
+    case SLIDER_EVENT_PRESS:
+      result.presses++;
+      result.orderErrors += recorder->down[event.pad];
+      recorder->down[event.pad] = true;
+      break;
+    case SLIDER_EVENT_RELEASE:
+      result.releases++;
+      result.orderErrors += !recorder->down[event.pad];
+      recorder->down[event.pad] = false;
+      result.releaseLatencyUs += hostMicros() - recorder->touchEndUs[event.pad];
+      break;
+    case SLIDER_EVENT_REPEAT:
+      result.repeats++;
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Telemetry port that decodes the frames as they are written.
+ */
+class DecodingPort : public Print {
+ public:
+  explicit DecodingPort(uint32_t& repeats) : _repeats(repeats) {}
+
+  size_t write(uint8_t c) override {
+    SliderTelemetryFrame frame;
+    if (_decoder.push(c, frame)) {
+      _repeats += (frame.events >> SLIDER_EVENT_REPEAT) & 0x01;
+    }
+    return 1;
+  }
+  using Print::write;
+  int availableForWrite() override { return 256; }
+
+ private:
+  SliderTelemetryDecoder _decoder;
+  uint32_t& _repeats;
+};
+
+static bool check(bool ok, const char* what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  return ok;
+}
+
+static Result run(PadEventsMode mode, uint32_t seconds, bool withTelemetry) {
+  hostReset();
+  Result result = {};
+  TwoWire wire;
+  CAP1208Emulator chip;
+  wire.attach(CAP1208ADDR, &chip);
+  hostSetPinReader(CAP1208Emulator::readAlert, &chip);
+  CAP1208 sensor;
+  sensor.begin(wire);
+  sensor.ConfigureMultiTouch(4);
+  TouchSlider slider(&sensor);
+  slider.disablePrintSwipeStatus();
+  DecodingPort port(result.telemetryRepeats);
+  SliderTelemetry telemetry(port);
+  if (withTelemetry) {
+    slider.attachTelemetry(&telemetry);  // Reads the status and the deltas of every update
+  }
+  slider.start();
+  if (mode != FRAME_DIFFERENCES) {
+    slider.enablePadEvents(mode == PAD_EVENTS_ALERT ? ALERT_PIN : -1);
+  }
+  Recorder recorder = {&result, {}, {}};
+  for (TouchSliderEventType type : {SLIDER_EVENT_PRESS, SLIDER_EVENT_RELEASE, SLIDER_EVENT_REPEAT}) {
+    slider.subscribe(type, onPadEvent, &recorder);
+  }
+
+  uint32_t random = 12345;
+  auto next = [&random](uint32_t range) {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return random % range;
+  };
+  TouchSliderSnapshot start;
+  slider.getSnapshot(start);
+  uint32_t transactions = wire.transactions();
+  uint64_t endUs = hostMicros() + seconds * 1000000ULL;
+  while (hostMicros() < endUs) {
+    uint8_t pad = next(8);
+    uint32_t kind = next(10);
+    uint32_t touchMs = kind < 4 ? 10 + next(30) : kind < 9 ? 60 + next(200) : 1000 + next(1000);  // Tap, hold, repeat
+    uint32_t idleMs = 300 + next(700);
+    for (uint32_t ms = 0; ms < touchMs + idleMs; ms++) {
+      if (ms == touchMs) {
+        recorder.touchEndUs[pad] = hostMicros();
+      }
+      chip.sense(ms < touchMs ? 1 << pad : 0);
+      hostAdvance(1000);
+    }
+    result.touches++;
+  }
+  TouchSliderSnapshot end;
+  slider.getSnapshot(end);
+  result.frames = end.frame - start.frame;
+  result.transactions = wire.transactions() - transactions;
+  result.chipRepeats = chip.getRepeats();
+  slider.stop();
+  slider.detachTelemetry();
+  hostSetPinReader(NULL, NULL);
+  return result;
+}
+
+int main(int argc, char** argv) {
+  uint32_t seconds = argc > 1 ? atoi(argv[1]) : 3600;
+
+  Result results[MODES];
+  for (uint8_t m = 0; m < MODES; m++) {
+    Result& r = results[m] = run((PadEventsMode)m, seconds, false);
+    printf("%-18s touches=%lu press=%lu release=%lu order errors=%lu repeats=%lu of %lu "
+           "release latency=%.1f ms i2c/update=%.2f\n",
+           MODE_NAMES[m], (unsigned long)r.touches, (unsigned long)r.presses, (unsigned long)r.releases,
+           (unsigned long)r.orderErrors, (unsigned long)r.repeats, (unsigned long)r.chipRepeats,
+           r.releases ? r.releaseLatencyUs / 1000.0 / r.releases : 0.0,
+           r.frames ? (double)r.transactions / r.frames : 0.0);
+  }
+
+  bool ordered = true;
+  for (const Result& r : results) {
+    ordered &= r.presses == r.touches && r.releases == r.touches && r.orderErrors == 0;
+  }
+  bool ok = check(ordered, "every touch gives one press and then one release, in every mode");
+  const Result& differences = results[FRAME_DIFFERENCES];
+  const Result& events = results[PAD_EVENTS];
+  const Result& alert = results[PAD_EVENTS_ALERT];
+  ok &= check(differences.repeats == 0 && events.repeats * 100 >= events.chipRepeats * 95 &&
+                  alert.repeats * 100 >= alert.chipRepeats * 95,
+              "the pad events report at least 95% of the repeats of the chip");
+  ok &= check(events.releaseLatencyUs / events.releases < differences.releaseLatencyUs / differences.releases,
+              "the pad events report the releases sooner");
+  ok &= check(alert.transactions < events.transactions && events.transactions < differences.transactions,
+              "fewer I2C transactions per update with the pad events, fewer still with ALERT");
+  Result streamed = run(PAD_EVENTS_ALERT, seconds, true);
+  printf("%-18s repeats=%lu, in the telemetry %lu\n", "with telemetry", (unsigned long)streamed.repeats,
+         (unsigned long)streamed.telemetryRepeats);
+  ok &= check(streamed.repeats > 0 && streamed.telemetryRepeats == streamed.repeats, "every repeat reaches the telemetry");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Stress test of the snapshot publication (SliderSnapshot.h) with a writer thread and concurrent reader threads.
+ *
+ *   seqlock_test [writes]
+ *
+ * SliderSeqlock alone: the readers must never see a torn value or one older than the value they saw before.
+ * TouchSlider: processFrame() publishes swipes on one thread while getSwipeStatus() consumes them on another and
+ * getSnapshot() readers watch the counters; no swipe may be lost or counted twice. `make tsan` runs it again under
+ * ThreadSanitizer. The exit status is 0 on success and 1 on a failure.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "TouchSlider.h"
+
+#define READERS 3
+
+// Every word holds the same number, a torn read mixes two
+struct Value {
+  uint32_t words[7];
+};
+
+static bool check(bool ok, const char* what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  uint32_t writes = argc > 1 ? atoi(argv[1]) : 200000;
+
+  SliderSeqlock<Value> lock;
+  std::atomic<bool> done(false);
+  std::atomic<uint64_t> reads(0), torn(0), backwards(0);
+  std::vector<std::thread> readers;
+  for (int r = 0; r < READERS; r++) {
+    readers.emplace_back([&] {
+      uint64_t count = 0, bad = 0, back = 0;
+      uint32_t last = 0;
+      while (!done.load()) {
+        Value value;
+        lock.read(value);
+        for (uint8_t i = 1; i < 7; i++) {
+          bad += value.words[i] != value.words[0];
+        }
+        back += value.words[0] < last;
+        last = value.words[0];
+        count++;
+      }
+      reads += count;
+      torn += bad;
+      backwards += back;
+    });
+  }
+  for (uint32_t n = 1; n <= writes; n++) {
+    Value value;
+    for (uint32_t& word : value.words) {
+      word = n;
+    }
+    lock.write(value);
+  }
+  done = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  Value last;
+  lock.read(last);
+  printf("seqlock: %u writes, %lu reads by %d readers, %lu torn, %lu backwards\n", writes, (unsigned long)reads.load(),
+         READERS, (unsigned long)torn.load(), (unsigned long)backwards.load());
+  bool ok = check(torn == 0 && backwards == 0 && last.words[0] == writes, "no torn or stale read, the last value wins");
+
+  // Swipes towards the last pad, published by the updates and consumed by one application task
+  TouchSlider slider(NULL);
+  const int gestures = writes / 100;
+  done = false;
+  std::atomic<uint64_t> snapshotErrors(0);
+  readers.clear();
+  for (int r = 0; r < READERS - 1; r++) {
+    readers.emplace_back([&] {
+      TouchSliderSnapshot previous = {};
+      while (!done.load()) {
+        TouchSliderSnapshot now;
+        slider.getSnapshot(now);
+        snapshotErrors += now.frame < previous.frame || (uint16_t)(now.swipeDown - previous.swipeDown) > 0x8000;
+        previous = now;
+      }
+    });
+  }
+  std::atomic<uint32_t> polls(0);
+  std::thread updates([&] {
+    for (int gesture = 0; gesture < gestures; gesture++) {
+      uint32_t seen = polls.load();
+      for (uint8_t pad = 0; pad < 8; pad++) {
+        slider.processFrame(1 << pad);
+      }
+      for (uint8_t i = 0; i < 3; i++) {
+        slider.processFrame(0);
+      }
+      while (polls.load() == seen) {  // getSwipeStatus() returns an int8_t, poll at least once per gesture
+        std::this_thread::yield();
+      }
+    }
+    done = true;
+  });
+  long consumed = 0;
+  while (!done.load()) {
+    consumed += slider.getSwipeStatus();
+    polls++;
+  }
+  updates.join();
+  consumed += slider.getSwipeStatus();
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  TouchSliderSnapshot final;
+  slider.getSnapshot(final);
+  printf("slider: %d gestures, %u frames, %u swipes published, %ld consumed\n", gestures, final.frame, final.swipeDown,
+         consumed);
+  ok &= check(final.swipeDown > 0 && final.swipeUp == 0 && consumed == final.swipeDown,
+              "every swipe published was consumed once");
+  ok &= check(snapshotErrors == 0, "the snapshot readers saw the frames and counters move forward only");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Simulated clients of SharedI2CBus on a simulated clock (setClock()).
+ *
+ *   shared_bus_test [seconds]
+ *
+ * A touch poll (periodic, 50 ms, 1 ms deadline), an IMU reading two 32-byte blocks every 7 to 10 ms in chunks
+ * (fitBytes()) and a fuel gauge share a 100 kHz bus with random jitter. With the slot reserved the touch poll must
+ * never miss its deadline; the same clients without the reservation show what it buys. Then the edge cases: a short
+ * transfer is refused inside a reserved slot, the estimates follow a clock changed by the owner, and acquire() waits
+ * and times out on the simulated clock. The exit status is 0 on success and 1 on a failure.
+ */
+
+#include <stdlib.h>
+
+#include "SharedI2CBus.h"
+
+#define TOUCH_PERIOD_US 50000
+#define TOUCH_SLOT_US 3000
+#define TOUCH_DEADLINE_US 1000
+
+static unsigned long simulatedUs = 0;
+static SharedI2CBus* waitBus = NULL;  // Bus and client released by simulatedWait() once releaseAtUs is reached
+static int8_t waitOwner = -1;
+static unsigned long releaseAtUs = 0;
+
+static unsigned long simulatedNow() {
+  return simulatedUs;
+}
+
+static void simulatedWait(uint32_t us) {
+  simulatedUs += us;
+  if (waitBus != NULL && simulatedUs >= releaseAtUs) {
+    waitBus->release(waitOwner);
+    waitBus = NULL;
+  }
+}
+
+static bool check(bool ok, const char* what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  return ok;
+}
+
+struct Job {
+  int8_t client;
+  uint32_t nextUs;
+  uint32_t periodUs;
+  uint32_t jitterUs;
+  uint16_t bytes;     // Per transfer
+  uint8_t transfers;  // Per period
+  bool chunked;       // Cut the transfers to what fits before the next slot
+  uint8_t left;
+  bool holding;
+  uint32_t endUs;
+};
+
+/**
+ * @brief Run the three clients for a while, return the statistics of the touch poll.
+ */
+static SharedI2CClientStats simulate(bool reserve, uint32_t seconds, SharedI2CClientStats& imu, SharedI2CClientStats& gauge) {
+  simulatedUs = 0;
+  SharedI2CBus bus(Wire);
+  bus.setClock(simulatedNow, simulatedWait);
+  Wire.setClock(100000);  // 90 us per byte
+  bus.begin();
+  int8_t touch = reserve ? bus.addPeriodicClient("touch", 3, TOUCH_PERIOD_US, TOUCH_SLOT_US, TOUCH_DEADLINE_US)
+                         : bus.addClient("touch", 3, TOUCH_DEADLINE_US);
+  Job jobs[] = {
+      {touch, 0, TOUCH_PERIOD_US, 400, 3, 3, false, 0, false, 0},  // First, its slot is learned from its requests
+      {bus.addClient("imu", 2, 20000), 300, 7000, 3000, 32, 2, true, 0, false, 0},
+      {bus.addClient("gauge", 1), 777, 100000, 3000, 2, 1, false, 0, false, 0},
+  };
+  srand(1);
+  for (; simulatedUs < seconds * 1000000UL; simulatedUs += 5) {
+    for (Job& job : jobs) {
+      if (job.holding && simulatedUs >= job.endUs) {
+        bus.release(job.client);
+        job.holding = false;
+      }
+      if (job.left == 0 && simulatedUs >= job.nextUs) {
+        job.left = job.transfers;
+        job.nextUs += job.periodUs + rand() % job.jitterUs;
+      }
+      if (job.left == 0 || job.holding) {
+        continue;
+      }
+      uint16_t bytes = job.bytes;
+      if (job.chunked) {
+        uint16_t fit = bus.fitBytes(job.client);
+        if (fit < SHARED_I2C_MIN_CHUNK) {
+          continue;
+        }
+        bytes = fit < bytes ? fit : bytes;
+      }
+      uint32_t durationUs = bus.transferUs(bytes);
+      if (bus.tryAcquire(job.client, durationUs)) {
+        job.holding = true;
+        job.endUs = simulatedUs + durationUs;
+        job.left--;
+      }
+    }
+  }
+  SharedI2CClientStats stats;
+  bus.getClientStats(jobs[0].client, stats);
+  bus.getClientStats(jobs[1].client, imu);
+  bus.getClientStats(jobs[2].client, gauge);
+  return stats;
+}
+
+int main(int argc, char** argv) {
+  uint32_t seconds = argc > 1 ? atoi(argv[1]) : 60;
+
+  SharedI2CClientStats imu, gauge;
+  SharedI2CClientStats plain = simulate(false, seconds, imu, gauge);
+  SharedI2CClientStats reserved = simulate(true, seconds, imu, gauge);
+  printf("%lu s: touch without slot maxWait=%luus misses=%lu | with slot maxWait=%luus misses=%lu transfers=%lu | "
+         "imu transfers=%lu deferred=%lu conflicts=%lu | gauge transfers=%lu\n",
+         (unsigned long)seconds, (unsigned long)plain.maxWaitUs, (unsigned long)plain.deadlineMisses,
+         (unsigned long)reserved.maxWaitUs, (unsigned long)reserved.deadlineMisses, (unsigned long)reserved.transfers,
+         (unsigned long)imu.transfers, (unsigned long)imu.deferrals, (unsigned long)imu.slotConflicts,
+         (unsigned long)gauge.transfers);
+  bool ok = check(reserved.deadlineMisses == 0 && reserved.maxWaitUs <= TOUCH_DEADLINE_US,
+                  "the touch poll never misses its deadline with its slot reserved");
+  ok &= check(plain.maxWaitUs > reserved.maxWaitUs, "the reservation shortens the longest wait of the touch poll");
+  ok &= check(imu.transfers > 0 && gauge.transfers > 0, "the other clients still get the bus");
+
+  // A grant of the touch poll at 0 places its slot; its guard starts SHARED_I2C_GUARD_US before the next one
+  simulatedUs = 0;
+  SharedI2CBus bus(Wire);
+  bus.setClock(simulatedNow, simulatedWait);
+  bus.begin();
+  int8_t touch = bus.addPeriodicClient("touch", 3, TOUCH_PERIOD_US, TOUCH_SLOT_US);
+  int8_t other = bus.addClient("other", 1);
+  bus.tryAcquire(touch);
+  bus.release(touch);
+  simulatedUs = TOUCH_PERIOD_US - SHARED_I2C_GUARD_US / 2;
+  bool refused = !bus.tryAcquire(other, 0);
+  bus.cancel(other);
+  simulatedUs = TOUCH_PERIOD_US / 2;
+  bool granted = bus.tryAcquire(other, 0);
+  bus.release(other);
+  ok &= check(refused && granted, "a short transfer is refused in the guard of a slot, granted between slots");
+
+  // A clock stepped down by the owner (CAP1208 on errors) is in the estimates once it releases the bus
+  Wire.setClock(400000);
+  bus.begin();
+  uint32_t fastUs = bus.transferUs(32);
+  bus.tryAcquire(touch);
+  Wire.setClock(100000);
+  bus.release(touch);
+  uint32_t slowUs = bus.transferUs(32);
+  ok &= check(fastUs < slowUs && slowUs == (32 + 3) * 90, "the transfer estimates follow a clock changed by the owner");
+
+  // acquire() on the simulated clock: granted once the owner releases, otherwise times out
+  bus.tryAcquire(touch);
+  waitBus = &bus;
+  waitOwner = touch;
+  releaseAtUs = simulatedUs + 5000;
+  unsigned long start = simulatedUs;
+  bool waited = bus.acquire(other, 0) && simulatedUs - start >= 5000;
+  bus.release(other);
+  bus.tryAcquire(touch);
+  start = simulatedUs;
+  SharedI2CClientStats before, after;
+  bus.getClientStats(other, before);
+  bool timedOut = !bus.acquire(other, 0) && simulatedUs - start >= SHARED_I2C_TIMEOUT_MS * 1000UL;
+  bus.getClientStats(other, after);
+  ok &= check(waited && timedOut && after.deadlineMisses == before.deadlineMisses + 1,
+              "acquire() waits and times out on the simulated clock");
+  return ok ? 0 : 1;
+}
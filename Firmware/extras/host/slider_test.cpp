@@ -0,0 +1,85 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Checks of TouchSlider on frames given by the test (processFrame()), no CAP1208 needed.
+ *
+ *   slider_test
+ *
+ * The swipe fine auto-repeat of a held edge pad (setSwipeFineTiming()), including a period longer than the delay
+ * before the first repeat. SliderValue::attach() on a handler table without room for all of its subscriptions must
+ * fail and give back the ones it took. The exit status is 0 on success and 1 on a failure.
+ */
+
+#include "SliderValue.h"
+#include "TouchSlider.h"
+
+#define HOLD_FRAMES 80  // 4 s at the default 50 ms update
+
+static bool check(bool ok, const char* what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  return ok;
+}
+
+static void onFine(const TouchSliderEvent& event, void* context) {
+  static_cast<uint32_t*>(context)[event.type == SLIDER_EVENT_SWIPE_FINE_UP]++;
+}
+
+/**
+ * @brief Hold the last pad with the dwell of one frame, return whether the swipes fine are the expected ones.
+ */
+static bool holdEdge(uint16_t repeatDelayMs, uint16_t repeatMs) {
+  TouchSlider slider(NULL);
+  slider.disablePrintSwipeStatus();
+  slider.enableSwipeFine();
+  slider.setSwipeFineTiming(1, repeatDelayMs, repeatMs);
+  uint32_t fine[2] = {};
+  slider.subscribe(SLIDER_EVENT_SWIPE_FINE_UP, onFine, fine);
+  slider.subscribe(SLIDER_EVENT_SWIPE_FINE_DOWN, onFine, fine);
+  for (uint8_t frame = 0; frame < HOLD_FRAMES; frame++) {
+    slider.processFrame(0x80);
+  }
+  for (uint8_t frame = 0; frame < 4; frame++) {
+    slider.processFrame(0);
+  }
+
+  // Sent on the second frame, then after the delay and every period while the pad is held
+  uint32_t heldMs = (HOLD_FRAMES - 2) * 50;
+  uint32_t repeats = heldMs >= repeatDelayMs ? 1 + (heldMs - repeatDelayMs) / repeatMs : 0;
+  printf("delay %u ms, period %u ms: %lu swipes fine up (%lu expected), %lu down\n", repeatDelayMs, repeatMs,
+         (unsigned long)fine[1], (unsigned long)(1 + repeats), (unsigned long)fine[0]);
+  return fine[1] == 1 + repeats && fine[0] == 0;
+}
+
+static void onNothing(const TouchSliderEvent& event, void* context) {}
+
+static bool attachValue() {
+  TouchSlider slider(NULL);
+  for (uint8_t i = 0; i < SLIDER_EVENTS_MAX_HANDLERS - 2; i++) {
+    slider.subscribe(SLIDER_EVENT_PRESS, onNothing);
+  }
+  SliderValue value;
+  value.setMode(SLIDER_VALUE_RELATIVE);
+  bool refused = !value.attach(slider);  // 4 subscriptions, 2 free entries
+  int8_t first = slider.subscribe(SLIDER_EVENT_RELEASE, onNothing);
+  int8_t second = slider.subscribe(SLIDER_EVENT_RELEASE, onNothing);
+  slider.unsubscribe(first);
+  slider.unsubscribe(second);
+  value.setMode(SLIDER_VALUE_ABSOLUTE);
+  bool attached = value.attach(slider);  // 2 subscriptions fit
+  return check(refused && first >= 0 && second >= 0 && attached,
+               "SliderValue::attach() fails whole when the handler table is short, and fits when it is not");
+}
+
+int main() {
+  bool repeats = holdEdge(SWIPE_FINE_REPEAT_DELAY_MS, SWIPE_FINE_REPEAT_MS);
+  repeats &= holdEdge(100, 500);
+  repeats &= holdEdge(150, 1000);
+  repeats &= holdEdge(250, 250);
+  bool ok = check(repeats, "a held edge pad repeats the swipe fine at its period, also when it exceeds the delay");
+  ok &= attachValue();
+  return ok ? 0 : 1;
+}
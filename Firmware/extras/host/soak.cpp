@@ -0,0 +1,311 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Soak test: scripted gestures on an emulated CAP1208 (CAP1208Emulator.h) behind an unreliable bus, for hours of
+ * simulated time, one shard per core.
+ *
+ *   soak [-j threads] [-s seeds] [-t seconds per seed] [-r report seconds] [--nack ppm] [--short ppm] [--reset ppm]
+ *        [--latency ppm:us] [--stuck mask:value] [--burst ppm:ms] [--min-accuracy percent]
+ *
+ * Each seed is a shard: its own bus, emulator and TouchSlider, swiping towards the last and the first pad and
+ * tapping the edge pads in random order, with the bus faults drawn from the seed. The seeds are handed out to the
+ * threads (one per core by default). Every -r seconds, and at the end, the totals so far are printed: gesture
+ * accuracy per kind, the recovery of getHealth() (failed reads, forced releases, repaired resets, longest recovery),
+ * the steps down of the tuned bus clock, the throughput (simulated time and frames per second) and the faults
+ * injected. The fault chances are in parts per million of the transactions, the bursts (every transaction NACKed for
+ * a while) per millisecond of simulated time. The exit status is 1 when the accuracy is below --min-accuracy, 2 on a usage error.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CAP1208Emulator.h"
+#include "TouchSlider.h"
+
+enum GestureKind { SWIPE_TO_LAST, SWIPE_TO_FIRST, HOLD_FIRST, HOLD_LAST, GESTURE_KINDS };
+static const char* const KIND_NAMES[GESTURE_KINDS] = {"swipe down", "swipe up", "fine down", "fine up"};
+
+struct Totals {
+  uint64_t gestures[GESTURE_KINDS];
+  uint64_t correct[GESTURE_KINDS];
+  uint64_t frames;
+  uint64_t simulatedUs;
+  uint64_t failedReads;
+  uint64_t faultReleases;
+  uint64_t chipResets;
+  uint16_t maxRecoveryMs;
+  uint32_t clockSteps;  // Steps down of the bus clock (checkTransaction() of CAP1208)
+  CAP1208EmulatorFaultCounts injected;
+};
+
+static std::mutex totalsLock;
+static Totals totals = {};
+
+// Events of the gesture in progress
+struct Events {
+  uint32_t swipeUp, swipeDown, fineUp, fineDown;
+};
+
+static void onEvent(const TouchSliderEvent& event, void* context) {
+  Events* events = static_cast<Events*>(context);
+  switch (event.type) {
+    case SLIDER_EVENT_SWIPE_UP:
+      events->swipeUp++;
+      break;
+    case SLIDER_EVENT_SWIPE_DOWN:
+      events->swipeDown++;
+      break;
+    case SLIDER_EVENT_SWIPE_FINE_UP:
+      events->fineUp++;
+      break;
+    case SLIDER_EVENT_SWIPE_FINE_DOWN:
+      events->fineDown++;
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief A swipe towards the last pad counts down (positive getSwipeStatus()), a tap on the first pad is a fine down.
+ */
+static bool expected(GestureKind kind, const Events& e) {
+  switch (kind) {
+    case SWIPE_TO_LAST:
+      return e.swipeDown > 0 && e.swipeUp == 0;
+    case SWIPE_TO_FIRST:
+      return e.swipeUp > 0 && e.swipeDown == 0;
+    case HOLD_FIRST:
+      return e.fineDown == 1 && e.fineUp == 0 && e.swipeUp + e.swipeDown == 0;
+    default:
+      return e.fineUp == 1 && e.fineDown == 0 && e.swipeUp + e.swipeDown == 0;
+  }
+}
+
+/**
+ * @brief Run one shard and add its results to the totals after every gesture.
+ */
+static void runShard(uint32_t seed, uint32_t seconds, const CAP1208EmulatorFaults& faults) {
+  hostReset();
+  TwoWire wire;
+  CAP1208Emulator chip;
+  wire.attach(CAP1208ADDR, &chip);
+  CAP1208 sensor;
+  sensor.begin(wire, CAP1208ADDR, true);  // The clock steps down when the faults raise the error rate
+  sensor.ConfigureMultiTouch(4);
+  sensor.setSensitivity(SENSITIVITY_32X);
+  TouchSlider slider(&sensor);
+  slider.disablePrintSwipeStatus();
+  slider.enableSwipeFine();
+  Events events = {};
+  for (TouchSliderEventType type : {SLIDER_EVENT_SWIPE_UP, SLIDER_EVENT_SWIPE_DOWN, SLIDER_EVENT_SWIPE_FINE_UP,
+                                    SLIDER_EVENT_SWIPE_FINE_DOWN}) {
+    slider.subscribe(type, onEvent, &events);
+  }
+  slider.start();
+  chip.setFaults(faults, seed * 2654435761u);  // Faults once the sensor is configured
+
+  uint32_t random = seed * 7919 + 1;
+  auto next = [&random](uint32_t range) {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return random % range;
+  };
+  uint64_t endUs = hostMicros() + seconds * 1000000ULL;
+  TouchSliderHealth previous = {};
+  CAP1208EmulatorFaultCounts injected = {};
+  uint32_t previousFrame = 0;
+  uint32_t previousClock = sensor.getBusClock();
+  while (hostMicros() < endUs) {
+    GestureKind kind = (GestureKind)next(GESTURE_KINDS);
+    uint32_t idleMs = 400 + next(500);
+    uint32_t touchMs = kind <= SWIPE_TO_FIRST ? 200 + next(600) : 60 + next(240);
+    events = Events();
+    for (uint32_t ms = 0; ms < idleMs + touchMs + 400; ms++) {  // Idle, touch, then time for the release
+      uint8_t fingers = 0;
+      if (ms >= idleMs && ms < idleMs + touchMs) {
+        float travel = (float)(ms - idleMs) / touchMs;
+        float position = kind == SWIPE_TO_LAST ? travel * 7 : kind == SWIPE_TO_FIRST ? 7 - travel * 7 : kind == HOLD_FIRST ? 0 : 7;
+        for (uint8_t pad = 0; pad < 8; pad++) {
+          fingers |= (fabsf(pad - position) < 0.75f) << pad;  // One or two pads under the finger
+        }
+      }
+      chip.sense(fingers);
+      hostAdvance(1000);
+    }
+
+    TouchSliderHealth health;
+    slider.getHealth(health);
+    TouchSliderSnapshot snapshot;
+    slider.getSnapshot(snapshot);
+    const CAP1208EmulatorFaultCounts& counts = chip.getFaultCounts();
+    std::lock_guard<std::mutex> lock(totalsLock);
+    totals.gestures[kind]++;
+    totals.correct[kind] += expected(kind, events);
+    totals.frames += snapshot.frame - previousFrame;
+    totals.simulatedUs += (idleMs + touchMs + 400) * 1000ULL;
+    totals.failedReads += health.failedReads - previous.failedReads;
+    totals.faultReleases += (uint16_t)(health.faultReleases - previous.faultReleases);
+    totals.chipResets += (uint16_t)(health.chipResets - previous.chipResets);
+    totals.maxRecoveryMs = std::max(totals.maxRecoveryMs, health.maxRecoveryMs);
+    totals.clockSteps += (previousClock - sensor.getBusClock()) / 100000;
+    previousClock = sensor.getBusClock();
+    totals.injected.nacks += counts.nacks - injected.nacks;
+    totals.injected.shortReads += counts.shortReads - injected.shortReads;
+    totals.injected.resets += counts.resets - injected.resets;
+    totals.injected.stretches += counts.stretches - injected.stretches;
+    totals.injected.bursts += counts.bursts - injected.bursts;
+    previous = health;
+    injected = counts;
+    previousFrame = snapshot.frame;
+  }
+  slider.stop();
+}
+
+/**
+ * @brief Print the totals so far, return the accuracy in percent.
+ */
+static double report(double wallSeconds, const char* label) {
+  Totals t;
+  {
+    std::lock_guard<std::mutex> lock(totalsLock);
+    t = totals;
+  }
+  uint64_t gestures = 0, correct = 0;
+  std::string kinds;
+  for (uint8_t k = 0; k < GESTURE_KINDS; k++) {
+    gestures += t.gestures[k];
+    correct += t.correct[k];
+    char part[32];
+    snprintf(part, sizeof(part), "%s%s %.1f", k ? ", " : "", KIND_NAMES[k],
+             t.gestures[k] ? 100.0 * t.correct[k] / t.gestures[k] : 0.0);
+    kinds += part;
+  }
+  double accuracy = gestures ? 100.0 * correct / gestures : 0.0;
+  double simulated = t.simulatedUs / 1e6;
+  printf("[%s %6.0f s] %llu gestures, accuracy %.2f%% (%s) | failed reads %llu, released %llu, repaired %llu, "
+         "recovery max %u ms, clock steps down %lu | %.1f h simulated, %.0fx real time, %.0f frames/s | injected nack %lu, short %lu, "
+         "reset %lu, stretch %lu, burst %lu\n",
+         label, wallSeconds, (unsigned long long)gestures, accuracy, kinds.c_str(), (unsigned long long)t.failedReads,
+         (unsigned long long)t.faultReleases, (unsigned long long)t.chipResets, t.maxRecoveryMs, (unsigned long)t.clockSteps, simulated / 3600,
+         wallSeconds > 0 ? simulated / wallSeconds : 0.0, wallSeconds > 0 ? t.frames / wallSeconds : 0.0,
+         (unsigned long)t.injected.nacks, (unsigned long)t.injected.shortReads, (unsigned long)t.injected.resets,
+         (unsigned long)t.injected.stretches, (unsigned long)t.injected.bursts);
+  fflush(stdout);
+  return accuracy;
+}
+
+static bool parsePair(const char* text, uint32_t& first, uint32_t& second) {
+  char* end;
+  first = strtoul(text, &end, 0);
+  if (*end != ':') {
+    return false;
+  }
+  second = strtoul(end + 1, &end, 0);
+  return *end == '\0';
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: soak [-j threads] [-s seeds] [-t seconds per seed] [-r report seconds] [--nack ppm] [--short ppm]\n"
+          "            [--reset ppm] [--latency ppm:us] [--stuck mask:value] [--burst ppm:ms] [--min-accuracy percent]\n");
+}
+
+int main(int argc, char** argv) {
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  uint32_t seeds = 0;
+  uint32_t seconds = 600;
+  double reportSeconds = 10;
+  double minAccuracy = 0;
+  CAP1208EmulatorFaults faults = {};
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    uint32_t first, second;
+    bool ok = value != NULL;
+    if (!ok) {
+    } else if (arg == "-j") {
+      threads = std::max(1, atoi(value));
+    } else if (arg == "-s") {
+      seeds = atoi(value);
+    } else if (arg == "-t") {
+      seconds = atoi(value);
+    } else if (arg == "-r") {
+      reportSeconds = atof(value);
+    } else if (arg == "--nack") {
+      faults.nackPpm = atoi(value);
+    } else if (arg == "--short") {
+      faults.shortReadPpm = atoi(value);
+    } else if (arg == "--reset") {
+      faults.resetPpm = atoi(value);
+    } else if (arg == "--latency" && (ok = parsePair(value, first, second))) {
+      faults.latencyPpm = first;
+      faults.latencyUs = second;
+    } else if (arg == "--stuck" && (ok = parsePair(value, first, second))) {
+      faults.stuckMask = first;
+      faults.stuckValue = second;
+    } else if (arg == "--burst" && (ok = parsePair(value, first, second))) {
+      faults.burstPpm = first;
+      faults.burstMs = second;
+    } else if (arg == "--min-accuracy") {
+      minAccuracy = atof(value);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      usage();
+      return 2;
+    }
+    i++;
+  }
+  if (seeds == 0) {
+    seeds = threads * 4;
+  }
+
+  std::atomic<uint32_t> nextSeed(0);
+  std::atomic<unsigned> running(threads);
+  std::mutex doneLock;
+  std::condition_variable done;
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned t = 0; t < threads; t++) {
+    workers.emplace_back([&] {
+      for (uint32_t seed; (seed = nextSeed++) < seeds;) {
+        runShard(seed + 1, seconds, faults);
+      }
+      std::lock_guard<std::mutex> lock(doneLock);
+      running--;
+      done.notify_all();
+    });
+  }
+
+  auto elapsed = [&start] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+  {
+    std::unique_lock<std::mutex> lock(doneLock);
+    while (!done.wait_for(lock, std::chrono::duration<double>(reportSeconds), [&] { return running == 0; })) {
+      lock.unlock();
+      report(elapsed(), "soak ");
+      lock.lock();
+    }
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  double accuracy = report(elapsed(), "total");
+  if (minAccuracy > 0 && accuracy < minAccuracy) {
+    printf("FAIL: accuracy %.2f%%, minimum %.2f%%\n", accuracy, minAccuracy);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Decodes the binary telemetry of SliderTelemetry (layout in SliderTelemetry.h) into CSV, one line per frame.
+ *
+ *   telemetry_decode [-b baud] [serial port or capture file]
+ *
+ * Reads stdin without a path. A serial port is switched to raw mode at the given rate (921600 by default, as in
+ * TelemetrySlider.ino). Text logs on the same port and corrupted frames are skipped. The input ends at end of file,
+ * when the port goes away or on Ctrl-C; a summary with the frames decoded, lost (gaps in the sequence numbers) and
+ * rejected by the CRC then goes to stderr.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "SliderTelemetry.h"
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+  stopRequested = 1;
+}
+
+static bool baudConstant(long baud, speed_t& speed) {
+  static const struct {
+    long baud;
+    speed_t speed;
+  } rates[] = {{9600, B9600}, {57600, B57600}, {115200, B115200}, {230400, B230400}, {460800, B460800},
+               {921600, B921600}};
+  for (const auto& r : rates) {
+    if (r.baud == baud) {
+      speed = r.speed;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Raw 8N1 at the given rate, so no byte of the frames is translated or eaten by the line discipline.
+ */
+static bool configurePort(int fd, long baud) {
+  termios tty;
+  speed_t speed;
+  if (tcgetattr(fd, &tty) != 0 || !baudConstant(baud, speed)) {
+    return false;
+  }
+  cfmakeraw(&tty);
+  cfsetispeed(&tty, speed);
+  cfsetospeed(&tty, speed);
+  tty.c_cflag |= CLOCAL | CREAD;
+  tty.c_cc[VMIN] = 1;
+  tty.c_cc[VTIME] = 0;
+  return tcsetattr(fd, TCSANOW, &tty) == 0;
+}
+
+int main(int argc, char** argv) {
+  long baud = 921600;
+  const char* path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      baud = atol(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "usage: telemetry_decode [-b baud] [serial port or capture file]\n");
+      return 2;
+    } else {
+      path = argv[i];
+    }
+  }
+
+  int fd = STDIN_FILENO;
+  if (path != NULL && (fd = open(path, O_RDONLY | O_NOCTTY)) < 0) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return 2;
+  }
+  if (isatty(fd) && !configurePort(fd, baud)) {
+    fprintf(stderr, "%s: cannot set raw mode at %ld baud\n", path != NULL ? path : "stdin", baud);
+    return 2;
+  }
+  struct sigaction action = {};
+  action.sa_handler = onSignal;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  SliderTelemetryDecoder decoder;
+  SliderTelemetryFrame frame;
+  char line[128];
+  SliderTelemetryDecoder::formatCsvHeader(line, sizeof(line));
+  puts(line);
+  uint8_t buffer[512];
+  while (!stopRequested) {
+    ssize_t length = read(fd, buffer, sizeof(buffer));
+    if (length < 0 && errno == EINTR) {
+      continue;
+    }
+    if (length <= 0) {
+      break;  // End of file, or EIO once the other end of a pty or a USB port is gone
+    }
+    for (ssize_t i = 0; i < length; i++) {
+      if (decoder.push(buffer[i], frame)) {
+        SliderTelemetryDecoder::formatCsv(line, sizeof(line), frame);
+        puts(line);
+      }
+    }
+  }
+  fflush(stdout);
+  fprintf(stderr, "frames %lu, lost %lu, crc errors %lu\n", (unsigned long)decoder.getFrames(),
+          (unsigned long)decoder.getDropped(), (unsigned long)decoder.getCrcErrors());
+  return 0;
+}
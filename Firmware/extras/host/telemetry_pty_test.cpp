@@ -0,0 +1,258 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * End-to-end test of the telemetry: TouchSlider on an emulated CAP1208 streams through a pseudo-terminal, as it
+ * would through the USB serial port, and telemetry_decode reads the other end.
+ *
+ *   telemetry_pty_test [path of telemetry_decode]
+ *
+ * The slider runs scripted swipes with decimation 2. Text lines, a truncated frame and a window where the port has
+ * no room are mixed in. The CSV must hold every frame sent, each lost frame must show as a sequence gap (and the
+ * decimated ones must not), the CRC must catch the truncated frame and every swipe must be in the events column.
+ * Before that, the decoder must read back the event types from 8 on and a frame of the first format (type 0x01).
+ * The exit status is 0 on success, 1 on a mismatch and 2 if the test cannot run.
+ */
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "CAP1208Emulator.h"
+#include "TouchSlider.h"
+
+#define DECIMATION 2
+#define SWIPES 16
+
+/**
+ * @brief Master side of the pty as the serial port of the sketch; availableForWrite() is 0 while it is "full".
+ */
+class PtyPort : public Print {
+ public:
+  explicit PtyPort(int fd) : _fd(fd) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    size_t written = 0;
+    while (written < size) {
+      ssize_t n = ::write(_fd, buffer + written, size - written);
+      if (n <= 0) {
+        break;
+      }
+      written += n;
+    }
+    return written;
+  }
+  using Print::write;
+  int availableForWrite() override { return full ? 0 : 256; }
+
+  bool full = false;
+
+ private:
+  int _fd;
+};
+
+static uint32_t swipes[2];            // Swipes up and down published by the slider
+static uint32_t gestures[SWIPES][2];  // The same, per scripted swipe
+
+static void onSwipe(const TouchSliderEvent& event, void* context) {
+  swipes[event.type == SLIDER_EVENT_SWIPE_DOWN]++;
+}
+
+static bool check(bool ok, const char* what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  return ok;
+}
+
+/**
+ * @brief Decode the frame types: all 16 event bits survive a round trip, and a first format frame still reads.
+ */
+static bool checkFormats() {
+  SliderTelemetryFrame frame = {0x1234, 0x89ABCDEF, 0x81, 0x01, 1 << SLIDER_EVENT_REPEAT | 1 << SLIDER_EVENT_SWIPE_UP,
+                                {1, -2, 3, -4, 5, -6, 7, -8}};
+  uint8_t current[SLIDER_TELEMETRY_FRAME_SIZE];
+  SliderTelemetry::encode(frame, current);
+
+  // The first format: one events byte, 23 bytes in all
+  uint8_t legacy[SLIDER_TELEMETRY_FRAME_SIZE - 1] = {SLIDER_TELEMETRY_SYNC_1, SLIDER_TELEMETRY_SYNC_2,
+                                                     SLIDER_TELEMETRY_PAYLOAD_SIZE_V1, SLIDER_TELEMETRY_TYPE_TOUCH_V1};
+  memcpy(&legacy[4], &current[4], 9);
+  memcpy(&legacy[13], &current[14], SLIDER_TELEMETRY_PADS);
+  legacy[4]++;  // Next sequence number
+  uint16_t crc = SliderTelemetry::crc16(&legacy[2], sizeof(legacy) - 4);
+  legacy[21] = crc;
+  legacy[22] = crc >> 8;
+
+  SliderTelemetryDecoder decoder;
+  SliderTelemetryFrame decoded[2];
+  int count = 0;
+  uint8_t types[2] = {};
+  for (size_t i = 0; i < sizeof(current) + sizeof(legacy); i++) {
+    uint8_t byte = i < sizeof(current) ? current[i] : legacy[i - sizeof(current)];
+    if (count < 2 && decoder.push(byte, decoded[count])) {
+      types[count++] = decoder.getType();
+    }
+  }
+  return count == 2 && types[0] == SLIDER_TELEMETRY_TYPE_TOUCH && types[1] == SLIDER_TELEMETRY_TYPE_TOUCH_V1 &&
+         decoded[0].events == frame.events && decoded[1].events == (uint8_t)frame.events &&
+         decoded[1].sequence == frame.sequence + 1 && memcmp(decoded[1].delta, frame.delta, SLIDER_TELEMETRY_PADS) == 0 &&
+         decoder.getDropped() == 0 && decoder.getCrcErrors() == 0;
+}
+
+static std::string readFile(const char* path) {
+  std::string text;
+  FILE* file = fopen(path, "r");
+  if (file != NULL) {
+    char buffer[4096];
+    for (size_t n; (n = fread(buffer, 1, sizeof(buffer), file)) > 0;) {
+      text.append(buffer, n);
+    }
+    fclose(file);
+  }
+  return text;
+}
+
+int main(int argc, char** argv) {
+  std::string self = argv[0];
+  std::string decoderPath = argc > 1 ? argv[1] : self.substr(0, self.rfind('/') + 1) + "telemetry_decode";
+
+  // Raw pty, as the decoder sets a real port; keep a slave descriptor to know when the decoder has read everything
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    perror("pty");
+    return 2;
+  }
+  std::string slavePath = ptsname(master);
+  int slave = open(slavePath.c_str(), O_RDWR | O_NOCTTY);
+  termios tty;
+  tcgetattr(slave, &tty);
+  cfmakeraw(&tty);
+  tcsetattr(slave, TCSANOW, &tty);
+
+  char csvPath[] = "/tmp/telemetry_csv_XXXXXX";
+  char summaryPath[] = "/tmp/telemetry_sum_XXXXXX";
+  int csv = mkstemp(csvPath);
+  int summary = mkstemp(summaryPath);
+  pid_t child = fork();
+  if (child == 0) {
+    dup2(csv, STDOUT_FILENO);
+    dup2(summary, STDERR_FILENO);
+    close(master);  // Else the hangup never comes
+    close(slave);
+    execl(decoderPath.c_str(), decoderPath.c_str(), slavePath.c_str(), (char*)NULL);
+    _exit(127);
+  }
+
+  // Firmware side
+  CAP1208Emulator chip;
+  Wire.attach(CAP1208ADDR, &chip);
+  hostSetPinReader(CAP1208Emulator::readAlert, &chip);
+  CAP1208 sensor;
+  sensor.begin(Wire);
+  sensor.ConfigureMultiTouch(4);
+  sensor.setSensitivity(SENSITIVITY_32X);
+  TouchSlider slider(&sensor);
+  PtyPort port(master);
+  SliderTelemetry telemetry(port, DECIMATION);
+  slider.start();
+  slider.disablePrintSwipeStatus();
+  slider.subscribe(SLIDER_EVENT_SWIPE_UP, onSwipe);
+  slider.subscribe(SLIDER_EVENT_SWIPE_DOWN, onSwipe);
+  slider.attachTelemetry(&telemetry);
+
+  static const uint8_t truncated[] = {SLIDER_TELEMETRY_SYNC_1, SLIDER_TELEMETRY_SYNC_2, SLIDER_TELEMETRY_PAYLOAD_SIZE,
+                                      SLIDER_TELEMETRY_TYPE_TOUCH, 0x00, 0x00, 0x12};
+  uint64_t startUs[SWIPES];
+  for (int swipe = 0; swipe < SWIPES; swipe++) {
+    bool toLast = swipe % 2 == 0;
+    startUs[swipe] = hostMicros();
+    for (int ms = 0; ms < 400; ms++) {  // Across the 8 pads in 400 ms, then lift the finger
+      int pad = ms / 50;
+      chip.sense(1 << (toLast ? pad : 7 - pad));
+      hostAdvance(1000);
+    }
+    port.print("[I][TouchSlider.cpp] idle\r\n");
+    if (swipe == 5) {
+      port.write(truncated, sizeof(truncated));
+    }
+    for (int ms = 0; ms < (swipe == 9 ? 1200 : 400); ms++) {
+      port.full = swipe == 9 && ms >= 400 && ms < 800;  // No room for a while, with no gesture in flight
+      chip.sense(0);
+      hostAdvance(1000);
+    }
+    gestures[swipe][0] = swipes[0];
+    gestures[swipe][1] = swipes[1];
+    swipes[0] = swipes[1] = 0;
+  }
+  slider.stop();
+
+  // Let the decoder drain the pty, then hang up
+  for (int waited = 0, queued = 1; queued > 0 && waited < 5000; waited += 10) {
+    ioctl(slave, FIONREAD, &queued);
+    usleep(10000);
+  }
+  usleep(100000);
+  close(slave);
+  close(master);
+  int status = 0;
+  waitpid(child, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    fprintf(stderr, "%s did not run (status %d)\n", decoderPath.c_str(), status);
+    return 2;
+  }
+
+  std::string text = readFile(csvPath);
+  std::string totals = readFile(summaryPath);
+  unlink(csvPath);
+  unlink(summaryPath);
+  unsigned long frames = 0, lost = 0, crcErrors = 0;
+  sscanf(totals.c_str(), "frames %lu, lost %lu, crc errors %lu", &frames, &lost, &crcErrors);
+
+  uint32_t rows = 0, gaps = 0;
+  uint16_t events[SWIPES] = {};  // Event bits of the frames of each scripted swipe and its pause
+  unsigned previous = 0;
+  for (size_t start = text.find('\n') + 1, end; (end = text.find('\n', start)) != std::string::npos; start = end + 1) {
+    unsigned sequence, mask, gen, bits;
+    unsigned long timestamp;
+    if (sscanf(text.c_str() + start, "%u,%lu,%x,%x,%x", &sequence, &timestamp, &mask, &gen, &bits) != 5) {
+      continue;
+    }
+    if (rows++ != 0) {
+      gaps += (uint16_t)(sequence - previous - 1);
+    }
+    previous = sequence;
+    int swipe = SWIPES - 1;
+    while (swipe > 0 && timestamp < startUs[swipe]) {
+      swipe--;
+    }
+    events[swipe] |= bits;
+  }
+
+  // Swiping towards the last pad counts down (positive getSwipeStatus())
+  uint32_t detected = 0, streamed = 0;
+  for (int swipe = 0; swipe < SWIPES; swipe++) {
+    int direction = swipe % 2 == 0 ? SLIDER_EVENT_SWIPE_DOWN : SLIDER_EVENT_SWIPE_UP;
+    int opposite = SLIDER_EVENT_SWIPE_DOWN + SLIDER_EVENT_SWIPE_UP - direction;
+    detected += gestures[swipe][direction == SLIDER_EVENT_SWIPE_DOWN] > 0 && gestures[swipe][opposite == SLIDER_EVENT_SWIPE_DOWN] == 0;
+    streamed += (events[swipe] >> direction & 1) && !(events[swipe] >> opposite & 1);
+  }
+
+  printf("sent %lu, overflows %lu, decimated %lu | decoded %u, lost %lu, crc errors %lu | swipes %u/%u, streamed %u/%u\n",
+         (unsigned long)telemetry.getSent(), (unsigned long)telemetry.getOverflows(),
+         (unsigned long)telemetry.getDecimated(), rows, lost, crcErrors, detected, SWIPES, streamed, SWIPES);
+  bool ok = check(checkFormats(), "16 event bits round trip and the first format still decodes");
+  ok &= check(telemetry.getOverflows() > 0 && telemetry.getDecimated() > 0, "the test overflowed and decimated");
+  ok &= check(rows == telemetry.getSent() && frames == rows, "every frame sent was decoded, through the text");
+  ok &= check(lost == telemetry.getOverflows() && gaps == lost, "sequence gaps count the overflows only");
+  ok &= check(crcErrors == 1, "the truncated frame was rejected");
+  ok &= check(detected == SWIPES, "every scripted swipe was detected, in its direction");
+  ok &= check(streamed == SWIPES, "the events of every swipe are in the frames of its time");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Replays a labelled trace corpus through TouchSlider::processFrame() on every core and fails when a score falls
+ * below its threshold.
+ *
+ *   trace_gate [-j threads] [-t thresholds] [--tracker | --classifier] [--fine-dwell frames] [-v] <dir or .trace>...
+ *
+ * --fine-dwell sends the swipe fine of an edge tap after that many frames (setSwipeFineTiming()) instead of at the
+ * release. The thresholds default to the file "thresholds" of the first directory given. Each line is
+ *
+ *   <swipe|fine|tap> <precision|recall|latency> <limit>
+ *
+ * precision and recall are minimums, latency (average ticks to the detection) is a maximum. The exit status is 0
+ * when every threshold holds, 1 on a regression and 2 on a usage or corpus error.
+ */
+
+#include <chrono>
+
+#include "TraceCorpus.h"
+
+static const char* const CLASS_NAMES[TRACE_CLASS_COUNT] = {"swipe", "fine", "tap"};
+
+enum Detector { DETECTOR_HEURISTICS, DETECTOR_TRACKER, DETECTOR_CLASSIFIER };
+
+struct Threshold {
+  TouchTraceClass cls;
+  std::string metric;
+  float limit;
+};
+
+static bool loadThresholds(const std::string& path, std::vector<Threshold>& thresholds) {
+  FILE* file = fopen(path.c_str(), "r");
+  if (file == NULL) {
+    fprintf(stderr, "%s: cannot open\n", path.c_str());
+    return false;
+  }
+  char line[128];
+  for (unsigned number = 1; fgets(line, sizeof(line), file) != NULL; number++) {
+    char name[16], metric[16];
+    float limit;
+    char* comment = strchr(line, '#');
+    if (comment != NULL) {
+      *comment = '\0';
+    }
+    int fields = sscanf(line, "%15s %15s %f", name, metric, &limit);
+    if (fields <= 0) {
+      continue;
+    }
+    Threshold threshold = {TRACE_CLASS_COUNT, metric, limit};
+    for (uint8_t c = 0; c < TRACE_CLASS_COUNT; c++) {
+      if (strcmp(name, CLASS_NAMES[c]) == 0) {
+        threshold.cls = (TouchTraceClass)c;
+      }
+    }
+    if (fields != 3 || threshold.cls == TRACE_CLASS_COUNT ||
+        (threshold.metric != "precision" && threshold.metric != "recall" && threshold.metric != "latency")) {
+      fprintf(stderr, "%s:%u: expected <swipe|fine|tap> <precision|recall|latency> <limit>\n", path.c_str(), number);
+      fclose(file);
+      return false;
+    }
+    thresholds.push_back(threshold);
+  }
+  fclose(file);
+  return true;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: trace_gate [-j threads] [-t thresholds] [--tracker | --classifier] [--fine-dwell frames] [-v] "
+                  "<dir or .trace>...\n");
+}
+
+int main(int argc, char** argv) {
+  unsigned threads = 0;
+  std::string thresholdsPath;
+  Detector detector = DETECTOR_HEURISTICS;
+  int fineDwell = -1;  // Library default
+  bool verbose = false;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-j" && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    } else if (arg == "-t" && i + 1 < argc) {
+      thresholdsPath = argv[++i];
+    } else if (arg == "--tracker") {
+      detector = DETECTOR_TRACKER;
+    } else if (arg == "--classifier") {
+      detector = DETECTOR_CLASSIFIER;
+    } else if (arg == "--fine-dwell" && i + 1 < argc) {
+      fineDwell = atoi(argv[++i]);
+    } else if (arg == "-v") {
+      verbose = true;
+    } else if (arg[0] == '-') {
+      usage();
+      return 2;
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.empty()) {
+    usage();
+    return 2;
+  }
+
+  std::vector<CorpusTrace> corpus;
+  std::string error;
+  if (!loadCorpus(paths, corpus, error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return 2;
+  }
+  if (thresholdsPath.empty()) {
+    struct stat info;
+    if (stat(paths[0].c_str(), &info) == 0 && S_ISDIR(info.st_mode) &&
+        stat((paths[0] + "/thresholds").c_str(), &info) == 0) {
+      thresholdsPath = paths[0] + "/thresholds";
+    }
+  }
+  std::vector<Threshold> thresholds;
+  if (!thresholdsPath.empty() && !loadThresholds(thresholdsPath, thresholds)) {
+    return 2;
+  }
+
+  auto configure = [detector, fineDwell](TouchSlider& slider) {
+    slider.enableSwipeFine();
+    if (fineDwell >= 0) {
+      slider.setSwipeFineTiming(fineDwell);
+    }
+    if (detector == DETECTOR_TRACKER) {
+      slider.enableTracker();
+    } else if (detector == DETECTOR_CLASSIFIER) {
+      slider.enableClassifier();
+    }
+  };
+  TouchTraceScore score;
+  std::vector<TouchTraceScore> perTrace;
+  auto start = std::chrono::steady_clock::now();
+  replayCorpus(corpus, threads, configure, score, verbose ? &perTrace : NULL);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  size_t frames = 0;
+  for (const CorpusTrace& t : corpus) {
+    frames += t.trace.frameCount();
+  }
+  if (verbose) {
+    for (size_t i = 0; i < corpus.size(); i++) {
+      const TouchTraceScore& s = perTrace[i];
+      printf("%-40s swipe %u/%u fp %u  fine %u/%u fp %u  tap %u/%u\n", corpus[i].path.c_str(),
+             s.classes[TRACE_CLASS_SWIPE].truePositives,
+             s.classes[TRACE_CLASS_SWIPE].truePositives + s.classes[TRACE_CLASS_SWIPE].falseNegatives,
+             s.classes[TRACE_CLASS_SWIPE].falsePositives, s.classes[TRACE_CLASS_SWIPE_FINE].truePositives,
+             s.classes[TRACE_CLASS_SWIPE_FINE].truePositives + s.classes[TRACE_CLASS_SWIPE_FINE].falseNegatives,
+             s.classes[TRACE_CLASS_SWIPE_FINE].falsePositives, s.classes[TRACE_CLASS_TAP].truePositives,
+             s.classes[TRACE_CLASS_TAP].truePositives + s.classes[TRACE_CLASS_TAP].falseNegatives);
+    }
+  }
+  printf("%zu traces, %zu frames in %.3f s (%.0f frames/s)\n", corpus.size(), frames, seconds, frames / seconds);
+  for (uint8_t c = 0; c < TRACE_CLASS_COUNT; c++) {
+    const TouchTraceClassScore& s = score.classes[c];
+    printf("%-5s tp=%u fp=%u fn=%u precision=%.3f recall=%.3f latency avg=%.2f max=%u ticks\n", CLASS_NAMES[c],
+           s.truePositives, s.falsePositives, s.falseNegatives, score.precision((TouchTraceClass)c),
+           score.recall((TouchTraceClass)c), score.averageLatency((TouchTraceClass)c), s.latencyMax);
+  }
+
+  int failures = 0;
+  for (const Threshold& t : thresholds) {
+    float value = t.metric == "precision" ? score.precision(t.cls)
+                  : t.metric == "recall"  ? score.recall(t.cls)
+                                          : score.averageLatency(t.cls);
+    bool pass = t.metric == "latency" ? value <= t.limit : value >= t.limit;
+    if (!pass) {
+      printf("REGRESSION %s %s %.3f, limit %.3f\n", CLASS_NAMES[t.cls], t.metric.c_str(), value, t.limit);
+      failures++;
+    }
+  }
+  if (!thresholds.empty()) {
+    printf("%s: %zu thresholds, %d failed\n", failures == 0 ? "PASS" : "FAIL", thresholds.size(), failures);
+  }
+  return failures == 0 ? 0 : 1;
+}
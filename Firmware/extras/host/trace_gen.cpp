@@ -0,0 +1,99 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Writes labelled traces synthesized by TouchTraceGenerator, e.g. to extend the corpus of trace_gate.
+ *
+ *   trace_gen <dir> <count> [first seed]
+ *
+ * Trace n uses seed (first seed + n) and the noise level n % 3 (0, 20 or 60 out of 256). It holds a random mix of
+ * swipes (4 speeds), edge taps and middle taps, as many as fit in one trace.
+ */
+
+#include <string>
+
+#include "TouchTrace.h"
+
+static const uint8_t NOISE[] = {0, 20, 60};
+static const uint8_t SPEEDS[] = {4, 8, 16, 32};  // Sixteenths of a pad per tick
+
+static uint32_t nextRandom(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static bool writeTrace(const std::string& path, const TouchTrace& trace, const char* header) {
+  FILE* file = fopen(path.c_str(), "w");
+  if (file == NULL) {
+    return false;
+  }
+  fprintf(file, "%s\n", header);
+  char line[96];
+  for (uint8_t l = 0; l < trace.labelCount(); l++) {
+    TouchTrace::formatLabel(line, sizeof(line), trace.label(l));
+    fprintf(file, "%s\n", line);
+  }
+  for (uint16_t f = 0; f < trace.frameCount(); f++) {
+    if (trace.frame(f).mask != 0 || trace.hasDeltas()) {  // Missing ticks are frames with no pad touched
+      TouchTrace::formatFrame(line, sizeof(line), trace.frame(f), trace.hasDeltas());
+      fprintf(file, "%s\n", line);
+    }
+  }
+  // The last frame keeps the length of the trace
+  const TouchTraceFrame& last = trace.frame(trace.frameCount() - 1);
+  if (last.mask == 0 && !trace.hasDeltas()) {
+    TouchTrace::formatFrame(line, sizeof(line), last, false);
+    fprintf(file, "%s\n", line);
+  }
+  return fclose(file) == 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: trace_gen <dir> <count> [first seed]\n");
+    return 2;
+  }
+  std::string dir = argv[1];
+  int count = atoi(argv[2]);
+  uint32_t firstSeed = argc > 3 ? strtoul(argv[3], NULL, 0) : 1;
+
+  for (int n = 0; n < count; n++) {
+    uint32_t seed = firstSeed + n;
+    uint32_t state = seed * 2654435761u | 1;
+    uint8_t noise = NOISE[n % 3];
+    TouchTraceGenerator generator(seed);
+    generator.setNoise(noise);
+    TouchTrace trace;
+    generator.idle(trace, 2);
+    // Stop while the longest gesture (a slow swipe over 7 pads, about 32 ticks) still fits
+    while (trace.frameCount() < TOUCH_TRACE_MAX_FRAMES - 40 && trace.labelCount() < TOUCH_TRACE_MAX_LABELS) {
+      uint32_t kind = nextRandom(state) % 4;
+      if (kind < 2) {
+        uint8_t from = nextRandom(state) % TOUCH_TRACE_PADS;
+        uint8_t to;
+        do {
+          to = nextRandom(state) % TOUCH_TRACE_PADS;
+        } while (abs(to - from) < 3);
+        generator.swipe(trace, from, to, SPEEDS[nextRandom(state) % 4]);
+      } else if (kind == 2) {
+        generator.edgeTap(trace, nextRandom(state) & 1, 1 + nextRandom(state) % 6);
+      } else {
+        generator.tap(trace, 2 + nextRandom(state) % 4, 1 + nextRandom(state) % 4);
+      }
+    }
+
+    char name[32], header[96];
+    snprintf(name, sizeof(name), "/gen-%03d.trace", n);
+    snprintf(header, sizeof(header), "# trace_gen seed %lu, noise %u/256", (unsigned long)seed, noise);
+    if (!writeTrace(dir + name, trace, header)) {
+      fprintf(stderr, "%s%s: cannot write\n", dir.c_str(), name);
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Marcos Abraham Carballo Vazquez
+ * Original Creation Date: Dicember 5, 2024
+ * https://github.com/MarcosCarballoV/Adafruit_FeatherWing_TouchSlider
+ * */
+
+/*
+ * Cost per update and accuracy of the swipe detection on the raw pad states (heuristics) and on the position
+ * filtered by SliderTracker, over the same traces.
+ *
+ *   tracker_bench [-j threads] [<dir or .trace>...]
+ *
+ * The corpus defaults to ../traces. After the corpus scores, a table replays generated traces per noise level and
+ * swipe speed (500 traces per row, seed 42: two swipes, two edge taps and a middle tap each).
+ */
+
+#include <chrono>
+
+#include "TraceCorpus.h"
+
+static const char* const DETECTORS[] = {"raw", "tracker"};
+
+static void configure(TouchSlider& slider, int detector) {
+  slider.enableSwipeFine();
+  if (detector == 1) {
+    slider.enableTracker();
+  }
+}
+
+/**
+ * @brief Nanoseconds per processFrame() over the whole corpus, best of several passes.
+ */
+static double costPerFrame(const std::vector<CorpusTrace>& corpus, int detector) {
+  TouchSlider slider(NULL);
+  configure(slider, detector);
+  double best = 1e9;
+  for (int pass = 0; pass < 7; pass++) {
+    size_t frames = 0;
+    int32_t events = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < 20; repeat++) {
+      for (const CorpusTrace& t : corpus) {
+        for (uint16_t i = 0; i < t.trace.frameCount(); i++) {
+          slider.processFrame(t.trace.frame(i).mask);
+        }
+        frames += t.trace.frameCount();
+        events += slider.getSwipeStatus();
+      }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    best = std::min(best, ns);
+    if (events == 0x7FFFFFFF) {  // Keep the reads alive
+      printf(" ");
+    }
+  }
+  return best;
+}
+
+static void printScore(const char* name, const TouchTraceScore& score) {
+  printf("%-8s swipe P=%.3f R=%.3f L=%.2f | fine P=%.3f R=%.3f L=%.2f | tap %.3f\n", name,
+         score.precision(TRACE_CLASS_SWIPE), score.recall(TRACE_CLASS_SWIPE), score.averageLatency(TRACE_CLASS_SWIPE),
+         score.precision(TRACE_CLASS_SWIPE_FINE), score.recall(TRACE_CLASS_SWIPE_FINE),
+         score.averageLatency(TRACE_CLASS_SWIPE_FINE), score.recall(TRACE_CLASS_TAP));
+}
+
+int main(int argc, char** argv) {
+  unsigned threads = 0;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.empty()) {
+    paths.push_back("../traces");
+  }
+  std::vector<CorpusTrace> corpus;
+  std::string error;
+  if (!loadCorpus(paths, corpus, error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return 2;
+  }
+
+  printf("corpus: %zu traces\n", corpus.size());
+  for (int d = 0; d < 2; d++) {
+    TouchTraceScore score;
+    replayCorpus(corpus, threads, [d](TouchSlider& slider) { configure(slider, d); }, score);
+    printScore(DETECTORS[d], score);
+  }
+  for (int d = 0; d < 2; d++) {
+    printf("%-8s %.1f ns per update\n", DETECTORS[d], costPerFrame(corpus, d));
+  }
+
+  printf("\ngenerated (500 traces per row, seed 42)\n");
+  static const uint8_t noises[] = {0, 20, 60};
+  static const uint8_t speeds[] = {4, 8, 16, 32};
+  for (uint8_t noise : noises) {
+    for (uint8_t speed : speeds) {
+      std::vector<CorpusTrace> rows(500);
+      TouchTraceGenerator generator(42);
+      generator.setNoise(noise);
+      for (CorpusTrace& row : rows) {
+        generator.idle(row.trace, 2);
+        generator.swipe(row.trace, 0, 7, speed);
+        generator.swipe(row.trace, 6, 2, speed);
+        generator.edgeTap(row.trace, true, 2);
+        generator.edgeTap(row.trace, false, 1);
+        generator.tap(row.trace, 4, 3);
+      }
+      for (int d = 0; d < 2; d++) {
+        TouchTraceScore score;
+        replayCorpus(rows, threads, [d](TouchSlider& slider) { configure(slider, d); }, score);
+        char name[40];
+        snprintf(name, sizeof(name), "noise %2u/256, %4.2f pads/tick, %s", noise, speed / 16.0, DETECTORS[d]);
+        printf("%-38s", name);
+        printScore("", score);
+      }
+    }
+  }
+  return 0;
+}